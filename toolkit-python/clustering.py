@@ -251,3 +251,54 @@ class BlobFinder:
 
 
 #end of BlobFinder class definition.
+
+class ClusterList:
+    """
+    The clusters stored with a frame, as Blobs.
+    Frames converted from cluster logs keep the cluster of each pixel
+    (FramesData.GetClusterIds()), so the frame needn't be re-clustered.
+    Has the same blob_list as the BlobFinder.
+    """
+    def __init__(self, data, cluster_ids, r, c):
+        self.pixels = {} # map of {XY: Pixel}
+
+        self.blob_list = []
+        self.rows = r
+        self.cols = c
+
+        # Group the pixels by cluster ID.
+        blobs = {}
+        for xy in sorted(data.keys()):
+            x = xy % self.cols; y = xy / self.cols
+            self.pixels[xy] = Pixel(x,y,data[xy],-1)
+            cluster_id = cluster_ids[xy]
+            if cluster_id not in blobs:
+                blobs[cluster_id] = Blob()
+            blobs[cluster_id].insert(xy, self.pixels[xy])
+
+        # Keep the clusters in the order they were given.
+        for cluster_id in sorted(blobs.keys()):
+            self.insert(blobs[cluster_id])
+
+        # Calculate the blob properties
+        for b in self.blob_list:
+            b.process(self.pixels)
+
+    def insert(self, blob):
+        self.blob_list.append(blob)
+
+    def get_size(self):
+        return len(self.blob_list)
+
+#end of ClusterList class definition.
+
+def find_clusters(data, cluster_ids, r, c):
+    """
+    Get the clusters of a frame's pixels, {XY: C}.
+    The clusters stored with the frame, {XY: cluster ID}, are used if
+    they match the pixels (e.g. none were masked); otherwise the pixels
+    are clustered with the BlobFinder.
+    """
+    if len(cluster_ids) == len(data) and all(xy in cluster_ids for xy in data):
+        return ClusterList(data, cluster_ids, r, c)
+    return BlobFinder(data, r, c)
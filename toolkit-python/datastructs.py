@@ -13,6 +13,9 @@ See the data-conversion-toolkit README.md for further instructions.
 # Import the required ROOT libraries - hurrah for PyROOT!
 from ROOT import TFile, gSystem
 
+# Import the reader for the metadata overlay (Mf-updater, Mf-filter).
+from overlay import FrameTree
+
 # Import the validator package.
 from mfvalidator import *
 
@@ -29,8 +32,8 @@ class Data:
         ## The ROOT file itself.
         self.file = TFile(self.path)
 
-        ## The TTree containing the data.
-        self.chain = self.file.Get('MPXTree')
+        ## The TTree containing the data (with any overlay applied).
+        self.chain = FrameTree(self.file)
 
         ## The number of frames in the file.
         self.nframes = self.chain.GetEntriesFast()
@@ -33,6 +33,9 @@ from Plots import *
 from ROOT import TFile, gSystem
 from ROOT import TH1D, TH2D
 
+# Import the reader for the metadata overlay (Mf-updater, Mf-filter).
+from overlay import FrameTree
+
 # Import the JSON library.
 import json
 
@@ -84,8 +87,8 @@ if __name__=="__main__":
     ## The ROOT file itself.
     f = TFile(datapath)
 
-    ## The TTree containing the data.
-    chain = f.Get('MPXTree')
+    ## The TTree containing the data (with any overlay applied).
+    chain = FrameTree(f)
 
     ## The number of frames in the file.
     nframes = chain.GetEntriesFast()
@@ -143,9 +146,18 @@ if __name__=="__main__":
                 #x = X%256
                 #y = X/256
 
-        # Create a "BlobFinder" to cluster the pixels we've just extracted.
+        ## The cluster of each pixel, if stored with the frame (C++ std::map).
+        clids = chain.FramesData.GetClusterIds()
+
+        # A dictionary for the pixel clusters [X:cluster ID].
+        cluster_ids = {}
+        for i in clids:
+            cluster_ids[i.first] = i.second
+
+        # Get the clusters of the pixels we've just extracted: those
+        # stored with the frame, or else from a "BlobFinder".
         # See clustering.py for more about how this is done.
-        blob_finder = BlobFinder(pixels, 256, 256)
+        blob_finder = find_clusters(pixels, cluster_ids, 256, 256)
 
         # Add the total number of clusters in the frame to the list.
         n_cl_l.append(len(blob_finder.blob_list))
@@ -0,0 +1,148 @@
+#!/usr/bin/env python
+
+"""@package overlay
+
+==============================================================================
+                   CERN@school MPXTree metadata overlay package
+==============================================================================
+
+Mf-updater and Mf-filter leave MPXTree as it is and write their changes
+to the MPXOverlay (one entry per frame) and MPXOverlayMask trees. The
+FrameTree class reads MPXTree through those trees, as MfReader does in
+the toolkit, so that the Python tools see the updated metadata and mask.
+
+Usage (in place of f.Get('MPXTree')):
+
+    chain = FrameTree(f)
+    chain.GetEntry(fn)
+    lat = chain.FramesData.GetLatitude()
+
+See the data-conversion-toolkit README.md for further instructions.
+
+"""
+
+# Import the required ROOT libraries - hurrah for PyROOT!
+from ROOT import TString, std
+
+
+class FrameTree(object):
+    """ MPXTree with the file's MPXOverlay and MPXOverlayMask applied.
+
+    The overlay is ignored (with a warning) if its number of entries
+    does not match MPXTree's.
+    """
+    def __init__(self, f):
+        """ Constructor. """
+
+        ## The TTree containing the data.
+        self.tree = f.Get('MPXTree')
+
+        ## The overlay TTree (None if there isn't one).
+        self.overlay = f.Get('MPXOverlay')
+
+        if not self.overlay:
+            self.overlay = None
+        elif self.overlay.GetEntries() != self.tree.GetEntries():
+            print("* WARNING: the overlay has %d entries for %d frames; it is ignored." \
+                % (self.overlay.GetEntries(), self.tree.GetEntries()))
+            self.overlay = None
+
+        ## The pixel mask as a list of (x, y, value) - None if not masked.
+        self.mask = None
+
+        masktree = f.Get('MPXOverlayMask')
+        if self.overlay is not None and masktree:
+            self.mask = []
+            for i in range(masktree.GetEntries()):
+                masktree.GetEntry(i)
+                self.mask.append((masktree.x, masktree.y, masktree.v))
+
+        ## The mask in X (as a C++ std::map<int,int>) for each frame width.
+        self.masks = {}
+
+    def GetEntries(self):
+        return self.tree.GetEntries()
+
+    def GetEntriesFast(self):
+        return self.tree.GetEntriesFast()
+
+    def LoadTree(self, fn):
+        return self.tree.LoadTree(fn)
+
+    def GetEntry(self, fn):
+        if self.overlay is not None:
+            self.overlay.GetEntry(fn)
+        return self.tree.GetEntry(fn)
+
+    @property
+    def FramesData(self):
+        """ The current frame, with the overlay applied. """
+        if self.overlay is None:
+            return self.tree.FramesData
+        return OverlaidFrame(self.tree.FramesData, self)
+
+    def getLVL1(self, width):
+        """ The pixel mask {X:value} for the frame width, summed in X. """
+        if width not in self.masks:
+            lvl1 = std.map('int', 'int')()
+            for x, y, v in self.mask:
+                X = y * width + x
+                if lvl1.count(X):
+                    lvl1[X] = lvl1[X] + v
+                else:
+                    lvl1[X] = v
+            self.masks[width] = lvl1
+        return self.masks[width]
+
+
+class OverlaidFrame(object):
+    """ The Frame getters, taking the fields present in the overlay. """
+
+    ## The overlay getters: {getter: (branch, index)}.
+    fields = {
+        'GetDataSet'     : ('dataSet',     None),
+        'IsMCData'       : ('mcData',      None),
+        'GetFrameId'     : ('frameId',     None),
+        'GetLatitude'    : ('position',    0),
+        'GetLongitude'   : ('position',    1),
+        'GetAltitude'    : ('position',    2),
+        'GetRoll'        : ('attitude',    0),
+        'GetPitch'       : ('attitude',    1),
+        'GetYaw'         : ('attitude',    2),
+        'GetOmega_x'     : ('omega',       0),
+        'GetOmega_y'     : ('omega',       1),
+        'GetOmega_z'     : ('omega',       2),
+        'GetDet_x'       : ('detPosition', 0),
+        'GetDet_y'       : ('detPosition', 1),
+        'GetDet_z'       : ('detPosition', 2),
+        'GetEulerA'      : ('euler',       0),
+        'GetEulerB'      : ('euler',       1),
+        'GetEulerC'      : ('euler',       2),
+        'GetCustomName'  : ('customName',  None),
+        'GetAppFilters'  : ('appFilters',  None),
+        'GetSourceId'    : ('sourceId',    None),
+        }
+
+    ## The string fields (returned as TStrings, like the Frame getters).
+    strings = ['dataSet', 'customName', 'appFilters', 'sourceId']
+
+    def __init__(self, frame, frames):
+        self.frame = frame
+        self.frames = frames
+
+    def GetLVL1(self):
+        if self.frames.mask is None:
+            return self.frame.GetLVL1()
+        return self.frames.getLVL1(self.frame.GetFrameWidth())
+
+    def __getattr__(self, name):
+        overlay = self.frames.overlay
+        if name in self.fields and overlay.GetBranch(self.fields[name][0]):
+            branch, index = self.fields[name]
+            value = getattr(overlay, branch)
+            if index is not None:
+                value = value[index]
+            elif branch in self.strings:
+                value = TString(str(value))
+            return lambda: value
+        return getattr(self.frame, name)
@@ -5,4 +5,8 @@
 # data. It should be run before attempting to use the viewer.
 #
 
-echo .L Frame.C+ | root -l
+# The library is built next to Frame.C, wherever this is run from.
+cd "$(dirname "$0")"
+
+# The frame classes share the (header-only) payload codec with the toolkit.
+printf 'gSystem->AddIncludePath("-I%s/../toolkit/include");\n.L Frame.C+\n' "$(pwd)" | root -l
@@ -12,6 +12,9 @@ import os, inspect, glob, argparse
 from ROOT import TFile, gSystem
 from ROOT import TH1D, TH2D
 
+# Import the reader for the metadata overlay (Mf-updater, Mf-filter).
+from overlay import FrameTree
+
 # ...for the colour scaling.
 from matplotlib import colorbar, colors
 
@@ -66,8 +69,8 @@ if __name__=="__main__":
     ## The ROOT file itself.
     f = TFile(datapath)
 
-    ## The TTree containing the data.
-    chain = f.Get('MPXTree')
+    ## The TTree containing the data (with any overlay applied).
+    chain = FrameTree(f)
 
     ## The number of frames in the file.
     nframes = chain.GetEntriesFast()
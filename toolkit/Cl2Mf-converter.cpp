@@ -34,6 +34,13 @@ int main(int argc, char ** argv) {
 
   bool dbg = false; //true;
 
+  // Extract the optional "--name=value" settings.
+  ConverterOptions options;
+  if (!options.Parse(argc, argv)) {
+    ConverterOptions::PrintUsage();
+    exit(1);
+  }
+
   // Check the input arguments.
   TString tempScratchDir = "";
   checkParameters(argc, argv, &tempScratchDir);
@@ -65,7 +72,7 @@ int main(int argc, char ** argv) {
   cout << endl;
 
   // Instantiate the converter object
-  Cl2MfConverter converter(argv[1], argv[2], argv[3], num_frames_per_root_file, num_frames_to_read, dbg);
+  Cl2MfConverter converter(argv[1], argv[2], argv[3], num_frames_per_root_file, num_frames_to_read, dbg, options);
 
   return 0;
 
@@ -92,8 +99,14 @@ void checkParameters(int argc, char ** argv, TString * tempScratchDir){
       << "[XML config file] "
       << "[output directory] "
       << "[number of frames/ROOT file] "
-      << "{no. of frames to read}" << endl
+      << "{no. of frames to read} "
+      << "{--options}" << endl
+      << endl
+      << "Every ROOT file but the last, the first included, holds the" << endl
+      << "number of frames/ROOT file given. (Earlier versions put one" << endl
+      << "frame fewer in the first file.)" << endl
       << endl;
+    ConverterOptions::PrintUsage();
     exit(1);
   }
 
@@ -0,0 +1,210 @@
+/// @file Mf-benchmark.cpp
+/// @brief Code for the Mf-benchmark executable: output settings benchmark.
+
+// Standard includes.
+#include <stdlib.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+// ROOT includes.
+#include "RVersion.h"
+#include "TString.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TStopwatch.h"
+
+// Toolkit includes.
+#include "Frames.h"
+#include "WriteToNtuple.h"
+#include "ConverterOptions.h"
+
+using namespace std;
+
+// Forward declaration of helper functions.
+void checkParameters(int, char**);
+
+
+/// @brief Mf-benchmark: compares the output compression settings.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// Frames from a converted (MAFalda) file are written again with each
+/// compression setting, then read back. The file size and the write
+/// and read throughput (uncompressed MB per second) are reported for
+/// each setting. With --compression only that setting is measured;
+/// the other options (basket size, AutoFlush, writer threads, ...)
+/// apply to every setting.
+///
+/// @param[in] argc Input argument numbers.
+/// @param[in] argv Input argument values.
+int main(int argc, char ** argv) {
+
+  ConverterOptions options;
+  if (!options.Parse(argc, argv)) {
+    ConverterOptions::PrintUsage();
+    exit(1);
+  }
+
+  checkParameters(argc, argv);
+
+  cout << "" << endl
+       << "===========================" << endl
+       << " CERN@school: Mf-benchmark " << endl
+       << "===========================" << endl
+       << "*" << endl;
+
+  cout << "* Sample ROOT file name:       '" << argv[1] << "'" << endl;
+  cout << "* Output directory:            '" << argv[2] << "'" << endl;
+
+  // The number of frames to use (default: 1000).
+  Long64_t num_frames = 1000;
+  if (argc > 3) num_frames = atoll(argv[3]);
+
+  // Read the sample frames into memory
+  //------------------------------------
+  TFile * sf = new TFile(argv[1], "READ");
+  if (sf->IsZombie()) {
+    cout << "ERROR: could not open '" << argv[1] << "'" << endl;
+    return 1;
+  }
+
+  TTree * st = (TTree*)sf->Get("MPXTree");
+  if (!st) {
+    cout << "ERROR: no MPXTree in '" << argv[1] << "'" << endl;
+    return 1;
+  }
+
+  FrameStruct * pFrame = new FrameStruct();
+  st->SetBranchAddress("FramesData", &pFrame);
+
+  if (num_frames <= 0 || num_frames > st->GetEntries()) {
+    num_frames = st->GetEntries();
+  }
+
+  vector<FrameStruct> sample(num_frames);
+  for (Long64_t i = 0; i < num_frames; ++i) {
+    st->GetEntry(i);
+    sample[i] = *pFrame;
+  }
+
+  sf->Close();
+
+  cout << "* Frames in the sample:         " << num_frames << endl
+       << "*" << endl;
+
+  // The settings to compare
+  //-------------------------
+  vector<TString> codecs;
+  vector<Int_t>   levels;
+  if (options.compression != "") {
+    codecs.push_back(options.compression);
+    levels.push_back(options.compressionLevel);
+  } else {
+    codecs.push_back("none"); levels.push_back(0);
+    codecs.push_back("zlib"); levels.push_back(1);
+    codecs.push_back("zlib"); levels.push_back(6);
+    codecs.push_back("lzma"); levels.push_back(7);
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,12,0)
+    codecs.push_back("lz4");  levels.push_back(4);
+#endif
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,20,0)
+    codecs.push_back("zstd"); levels.push_back(5);
+    codecs.push_back("zstd"); levels.push_back(9);
+#endif
+  }
+
+  cout
+    << "* " << setw(12) << left << "Setting" << right
+    << setw(14) << "Size [MB]"
+    << setw(10) << "Ratio"
+    << setw(16) << "Write [MB/s]"
+    << setw(16) << "Read [MB/s]" << endl;
+
+  FrameStruct frame;
+
+  for (UInt_t s = 0; s < codecs.size(); ++s) {
+
+    ConverterOptions o = options;
+    o.compression      = codecs[s];
+    o.compressionLevel = levels[s];
+
+    TString label = codecs[s];
+    if (levels[s] >= 0 && codecs[s] != "none") label += TString::Format("-%d", levels[s]);
+
+    // Write the sample.
+    TStopwatch wt;
+    wt.Start();
+
+    WriteToNtuple * writer = new WriteToNtuple("MfBenchmark_" + label, argv[2], o);
+    for (Long64_t i = 0; i < num_frames; ++i) {
+      frame = sample[i];
+      writer->fillFrame(frame);
+    }
+    writer->closeNtuple();
+
+    wt.Stop();
+
+    TString path = writer->GetNtupleFileName();
+    delete writer;
+
+    // Read it back.
+    TStopwatch rt;
+    rt.Start();
+
+    TFile * f = new TFile(path, "READ");
+    TTree * t = (TTree*)f->Get("MPXTree");
+    FrameStruct * pRead = new FrameStruct();
+    t->SetBranchAddress("FramesData", &pRead);
+    for (Long64_t i = 0; i < t->GetEntries(); ++i) t->GetEntry(i);
+
+    rt.Stop();
+
+    Double_t rawMB  = t->GetTotBytes()/1.0e6;
+    Double_t fileMB = f->GetSize()/1.0e6;
+
+    f->Close();
+    delete f;
+    delete pRead;
+
+    cout
+      << "* " << setw(12) << left << label << right
+      << fixed << setprecision(2)
+      << setw(14) << fileMB
+      << setw(10) << (fileMB > 0. ? rawMB/fileMB : 0.)
+      << setw(16) << (wt.RealTime() > 0. ? rawMB/wt.RealTime() : 0.)
+      << setw(16) << (rt.RealTime() > 0. ? rawMB/rt.RealTime() : 0.)
+      << endl;
+
+  }//end of loop over the settings.
+
+  return 0;
+
+}
+
+/// @brief Checks the validity of the input arguments.
+///
+/// @param[in] argc Input argument numbers.
+/// @param[in] argv Input argument values.
+void checkParameters(int argc, char ** argv){
+
+  if(argc < 3) {
+    cout
+      << endl
+      << "ERROR: insufficient input arguments!" << endl
+      << endl
+      << "Usage: " << endl
+      << endl
+      << "./Mf-benchmark "
+      << "[sample ROOT file] "
+      << "[outputPath] "
+      << "{no. of frames} "
+      << "{--options}"
+      << endl
+      << endl;
+    ConverterOptions::PrintUsage();
+    exit(1);
+  }
+
+}//end of checkParameters helper function.
@@ -0,0 +1,237 @@
+/// @file Mf-cluster.cpp
+/// @brief Code for the Mf-cluster executable: clusters frames on many threads.
+
+// Standard includes.
+#include <stdlib.h>
+#include <iostream>
+#include <vector>
+#include <deque>
+
+// ROOT includes.
+#include "TString.h"
+
+// Toolkit includes.
+#include "Frames.h"
+#include "FrameBatch.h"
+#include "MfReader.h"
+#include "ColumnarReader.h"
+#include "FrameRing.h"
+#include "ClusterService.h"
+#include "ClusterClassifier.h"
+#include "ClusterTreeWriter.h"
+#include "ConverterOptions.h"
+
+using namespace std;
+
+// Forward declaration of helper functions.
+void checkParameters(int, char**);
+
+void writeResults(ClusterService &, ClusterTreeWriter &, deque<Long64_t> &, Bool_t, Bool_t = false);
+
+
+/// @brief Mf-cluster: clusters the frames of MAFalda files or a frame ring.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// The frames are clustered on a pool of threads (see ClusterService)
+/// and the results written in frame order to ClusterTree, one entry
+/// per frame with the properties of its clusters, their classes and
+/// the number in each class (see ClusterTreeWriter). The classes are
+/// those of rate-plotter.py unless --cut-table gives a table of cuts
+/// (see ClusterClassifier). An input of the form ring:NAME reads the frames
+/// published by a running converter (--shm-ring=NAME) until no frame
+/// has come for 10 seconds. A columnar file (NAME.mpxc, see
+/// ColumnarReader) is clustered straight from its mapped pixel arrays.
+/// The --zone-cut options select the frames of the MAFalda files,
+/// skipping the entry clusters that can't pass them (see MfReader).
+///
+/// @param[in] argc Input argument numbers.
+/// @param[in] argv Input argument values.
+int main(int argc, char ** argv) {
+
+  ConverterOptions options;
+  if (!options.Parse(argc, argv)) {
+    ConverterOptions::PrintUsage();
+    exit(1);
+  }
+
+  checkParameters(argc, argv);
+
+  cout << "" << endl
+       << "=========================" << endl
+       << " CERN@school: Mf-cluster " << endl
+       << "=========================" << endl
+       << "*" << endl;
+
+  cout << "* Output ROOT file name:       '" << argv[1] << "'" << endl;
+  for (int i = 2; i < argc; ++i) {
+    cout << "* Input:                       '" << argv[i] << "'" << endl;
+  }
+
+  if (options.cutTable != "") {
+    cout << "* Cut table:                   '" << options.cutTable << "'" << endl;
+  }
+
+  ClusterClassifier classifier;
+  if (options.cutTable != "" && !classifier.ReadCutTable(options.cutTable)) return 1;
+  cout << "* Cluster classes:" << endl;
+  classifier.Print();
+
+  ClusterTreeWriter writer(argv[1], options, &classifier);
+  if (!writer.IsOpen()) return 1;
+
+  ClusterService service(options.clusterThreads, options.clusterBuffers);
+
+  cout << "* Clustering threads:           " << service.GetNThreads() << endl;
+
+  Long64_t nframes = 0, nskipped = 0;
+
+  // The position in the inputs of each frame submitted, and of the
+  // first frame of the current input.
+  deque<Long64_t> entries;
+  Long64_t offset = 0;
+
+  FrameBatch batch(options.clusterBuffers);
+
+  for (int i = 2; i < argc; ++i) {
+
+    TString input = argv[i];
+
+    if (input.BeginsWith("ring:")) {
+
+      FrameRingReader ring(input(5, input.Length() - 5));
+      if (!ring.IsOpen()) continue;
+
+      FrameRingFrame frame;
+      Long64_t e = 0;
+      while (ring.Next(frame, 10000)) {
+        if (!service.HasFree()) writeResults(service, writer, entries, true);
+        UInt_t n = frame.pixelX.size();
+        entries.push_back(offset + e++);
+        service.Submit(frame.frameId, frame.width, frame.height,
+                       n > 0 ? &frame.pixelX[0] : 0,
+                       n > 0 ? &frame.pixelC[0] : 0, n);
+        writeResults(service, writer, entries, false);
+        ++nframes;
+      }
+      offset += e;
+
+      if (ring.GetNDropped() > 0) {
+        cout << "WARNING: " << ring.GetNDropped() << " frames were dropped from the ring." << endl;
+      }
+
+    } else if (input.EndsWith(".mpxc")) {
+
+      ColumnarReader reader(input.Data());
+      if (!reader.IsOpen()) continue;
+
+      for (Long64_t e = 0; e < reader.GetNFrames(); ++e) {
+        if (!service.HasFree()) writeResults(service, writer, entries, true);
+        PixelSpan pixels = reader.GetPixels(e);
+        entries.push_back(offset + e);
+        service.Submit(reader.GetFrameId(e), reader.GetWidth(e), reader.GetHeight(e),
+                       pixels.X, pixels.C, pixels.n);
+        writeResults(service, writer, entries, false);
+        ++nframes;
+      }
+      offset += reader.GetNFrames();
+
+    } else {
+
+      MfReader reader(input);
+      if (!reader.IsOpen()) continue;
+
+      for (UInt_t c = 0; c < options.zoneCuts.size(); ++c) {
+        reader.AddZoneCut(options.zoneCuts[c].q, options.zoneCuts[c].lo, options.zoneCuts[c].hi);
+      }
+
+      // The frames are read a batch at a time and submitted from the
+      // batch's pixel arrays.
+      Long64_t e = 0;
+      while (reader.ReadBatch(e, batch) > 0) {
+        for (UInt_t i = 0; i < batch.GetNFrames(); ++i) {
+          if (!service.HasFree()) writeResults(service, writer, entries, true);
+          entries.push_back(offset + batch.GetInputEntries()[i]);
+          service.Submit(batch, i);
+          writeResults(service, writer, entries, false);
+          ++nframes;
+        }
+      }
+      offset += reader.GetEntries();
+      nskipped += reader.GetNZoneSkipped();
+
+    }
+
+  }//end of loop over the inputs.
+
+  service.Close();
+  writeResults(service, writer, entries, true, true);
+
+  writer.Close();
+
+  cout << "* Frames clustered:             " << nframes << endl;
+  cout << "* Frames stolen by threads:     " << service.GetNStolen() << endl;
+  if (!options.zoneCuts.empty()) {
+    cout << "* Frames skipped by zone map:   " << nskipped << endl;
+  }
+
+  vector<Long64_t> const & totals = writer.GetTotals();
+  Int_t nclasses = classifier.GetNClasses();
+  for (Int_t i = 0; i < classifier.GetNCounts(); ++i) {
+    TString name = i < nclasses ? classifier.GetClassName(i)
+                                : classifier.GetGroupName(i - nclasses);
+    cout << "* Clusters in '" << name << "': " << totals[i] << endl;
+  }
+
+  return 0;
+
+}
+
+/// @brief Writes the results that are ready to the cluster tree.
+///
+/// @param[in] service The clustering service.
+/// @param[in] writer The cluster tree writer.
+/// @param[in,out] entries The positions in the inputs of the frames
+///                        waiting for their results.
+/// @param[in] wait Wait for the next result?
+/// @param[in] drain Wait for all of the results (once the service is closed)?
+void writeResults(ClusterService & service, ClusterTreeWriter & writer,
+                  deque<Long64_t> & entries, Bool_t wait, Bool_t drain) {
+
+  // The results come back in the order the frames were submitted.
+  ClusterResult const * result;
+  while ((result = service.GetResult(wait))) {
+    writer.Fill(entries.front(), result->frameId, result->properties);
+    entries.pop_front();
+    service.Release(result);
+    wait = drain;
+  }
+
+}//end of writeResults helper function.
+
+/// @brief Checks the validity of the input arguments.
+///
+/// @param[in] argc Input argument numbers.
+/// @param[in] argv Input argument values.
+void checkParameters(int argc, char ** argv){
+
+  if(argc < 3) {
+    cout
+      << endl
+      << "ERROR: insufficient input arguments!" << endl
+      << endl
+      << "Usage: " << endl
+      << endl
+      << "./Mf-cluster "
+      << "[output ROOT file] "
+      << "[input ROOT file | .mpxc file | ring:NAME] "
+      << "{more inputs} "
+      << "{--options}"
+      << endl
+      << endl;
+    ConverterOptions::PrintUsage();
+    exit(1);
+  }
+
+}//end of checkParameters helper function.
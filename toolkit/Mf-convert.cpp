@@ -0,0 +1,145 @@
+/// @file Mf-convert.cpp
+/// @brief Code for the Mf-convert executable: TTree <-> RNTuple conversion.
+
+// Standard includes.
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+#include <iostream>
+#include <vector>
+
+// ROOT includes.
+#include "TString.h"
+#include "TSystem.h"
+
+// Toolkit includes.
+#include "Frames.h"
+#include "FrameBatch.h"
+#include "MfReader.h"
+#include "OutputManager.h"
+#include "ConverterOptions.h"
+
+using namespace std;
+
+// Forward declaration of helper functions.
+void checkParameters(int, char**);
+
+
+/// @brief Mf-convert: converts MAFalda files between TTree and RNTuple.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// A file holding MPXTree is written as an RNTuple file, and an RNTuple
+/// file as an MPXTree one, unless --format says otherwise. Any overlay
+/// (see FrameOverlay) is applied to the frames written. The output file
+/// keeps the dataset ID and file number of the input file.
+///
+/// @param[in] argc Input argument numbers.
+/// @param[in] argv Input argument values.
+int main(int argc, char ** argv) {
+
+  // Was the output format given?
+  Bool_t formatGiven = false;
+  for (int i = 1; i < argc; ++i) {
+    if (TString(argv[i]).BeginsWith("--format")) formatGiven = true;
+  }
+
+  ConverterOptions options;
+  if (!options.Parse(argc, argv)) {
+    ConverterOptions::PrintUsage();
+    exit(1);
+  }
+
+  checkParameters(argc, argv);
+
+  cout << "" << endl
+       << "=========================" << endl
+       << " CERN@school: Mf-convert " << endl
+       << "=========================" << endl
+       << "*" << endl;
+
+  cout << "* Input ROOT file name:        '" << argv[1] << "'" << endl;
+  cout << "* Output directory:            '" << argv[2] << "'" << endl;
+
+  MfReader reader(argv[1]);
+  if (!reader.IsOpen()) return 1;
+
+  if (!formatGiven) options.outputFormat = reader.IsRNTuple() ? "root" : "rntuple";
+
+  cout << "* Input format:                 " << (reader.IsRNTuple() ? "rntuple" : "root") << endl;
+  cout << "* Output format:                " << options.outputFormat << endl;
+
+  Long64_t nframes = reader.GetEntries();
+  if (nframes == 0) {
+    cout << "ERROR: no frames in '" << argv[1] << "'" << endl;
+    return 1;
+  }
+
+  // The dataset ID comes from the frames, the file number from the
+  // input file name (DATASET_NNNNNNNNNN.root) if it has one.
+  TString dataset = reader.GetFrame(0)->GetDataSet();
+  TString base = gSystem->BaseName(argv[1]);
+  if (base.EndsWith(".root")) base.Resize(base.Length() - 5);
+  Int_t fileNum = 1;
+  Ssiz_t us = base.Last('_');
+  if (us != kNPOS && TString(base(us+1, base.Length()-us-1)).IsDigit()) {
+    fileNum = atoi(base.Data() + us + 1);
+    if (dataset == "") dataset = base(0, us);
+  }
+  if (dataset == "") dataset = base;
+
+  TString outPath = TString::Format("%s/%s_%010d.root", argv[2], dataset.Data(), fileNum);
+  char inReal[PATH_MAX], outReal[PATH_MAX];
+  if (realpath(outPath.Data(), outReal) && realpath(argv[1], inReal) &&
+      strcmp(inReal, outReal) == 0) {
+    cout << "ERROR: the output would overwrite the input file." << endl;
+    return 1;
+  }
+
+  OutputManager output(dataset, argv[2], options, fileNum);
+
+  // The frames are read and written a batch at a time.
+  FrameBatch batch;
+  Long64_t nconverted = 0;
+  Long64_t e = 0;
+  while (reader.ReadBatch(e, batch) > 0) {
+    output.fillBatch(batch);
+    nconverted += batch.GetNFrames();
+  }
+
+  output.Close();
+
+  cout << "* Frames converted:             " << nconverted << endl;
+  for (UInt_t i = 0; i < output.GetFileNames().size(); ++i) {
+    cout << "* The output file is '" << output.GetFileNames()[i] << "'" << endl;
+  }
+
+  return 0;
+
+}
+
+/// @brief Checks the validity of the input arguments.
+///
+/// @param[in] argc Input argument numbers.
+/// @param[in] argv Input argument values.
+void checkParameters(int argc, char ** argv){
+
+  if(argc < 3) {
+    cout
+      << endl
+      << "ERROR: insufficient input arguments!" << endl
+      << endl
+      << "Usage: " << endl
+      << endl
+      << "./Mf-convert "
+      << "[input ROOT file] "
+      << "[outputPath] "
+      << "{--options}"
+      << endl
+      << endl;
+    ConverterOptions::PrintUsage();
+    exit(1);
+  }
+
+}//end of checkParameters helper function.
@@ -0,0 +1,142 @@
+/// @file Mf-merge.cpp
+/// @brief Code for the Mf-merge executable: merges MAFalda files.
+
+// Standard includes.
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+#include <iostream>
+#include <vector>
+
+// ROOT includes.
+#include "TString.h"
+#include "TStopwatch.h"
+
+// Toolkit includes.
+#include "MfMerger.h"
+#include "ConverterOptions.h"
+
+using namespace std;
+
+// Forward declaration of helper functions.
+void checkParameters(int, char**);
+
+
+/// @brief Mf-merge: merges MAFalda files, copying the compressed data.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// The input files (e.g. DATASET_0000000001.root, DATASET_0000000002.root,
+/// ...) are written to the one output file in the order given. With
+/// --time-order the frames are sorted by start time, using at most
+/// --memory=MB (default 512) for the inputs read at once. See MfMerger.
+///
+/// @param[in] argc Input argument numbers.
+/// @param[in] argv Input argument values.
+int main(int argc, char ** argv) {
+
+  // The Mf-merge options.
+  Bool_t timeOrder = false;
+  Int_t memoryMB = 512;
+  int npositional = 1;
+  for (int i = 1; i < argc; ++i) {
+    TString arg = argv[i];
+    if (arg == "--time-order") {
+      timeOrder = true;
+    } else if (arg.BeginsWith("--memory=")) {
+      memoryMB = atoi(arg.Data() + 9);
+    } else {
+      argv[npositional++] = argv[i];
+    }
+  }
+  argc = npositional;
+  argv[argc] = 0;
+
+  ConverterOptions options;
+  if (!options.Parse(argc, argv)) {
+    ConverterOptions::PrintUsage();
+    exit(1);
+  }
+
+  checkParameters(argc, argv);
+
+  if (options.outputFormat != "root") {
+    cout << "ERROR: Mf-merge only writes ROOT files with MPXTree." << endl;
+    return 1;
+  }
+
+  if (memoryMB < 1) {
+    cout << "ERROR: the memory budget must be at least 1 MB." << endl;
+    return 1;
+  }
+
+  cout << "" << endl
+       << "=======================" << endl
+       << " CERN@school: Mf-merge " << endl
+       << "=======================" << endl
+       << "*" << endl;
+
+  cout << "* Output ROOT file name:       '" << argv[1] << "'" << endl;
+  cout << "* Input files:                  " << argc - 2 << endl;
+  cout << "* Time order:                   " << (timeOrder ? "yes" : "no") << endl;
+
+  MfMerger merger(argv[1], options);
+  merger.SetTimeOrder(timeOrder);
+  merger.SetMemoryMB(memoryMB);
+
+  char outReal[PATH_MAX], inReal[PATH_MAX];
+  Bool_t outExists = realpath(argv[1], outReal) != 0;
+  for (int i = 2; i < argc; ++i) {
+    if (outExists && realpath(argv[i], inReal) && strcmp(inReal, outReal) == 0) {
+      cout << "ERROR: the output would overwrite the input file '" << argv[i] << "'" << endl;
+      return 1;
+    }
+    merger.AddInput(argv[i]);
+  }
+
+  TStopwatch sw;
+  sw.Start();
+
+  Bool_t ok = merger.Merge();
+
+  sw.Stop();
+
+  cout << "*" << endl
+       << "* Frames written:               " << merger.GetNFrames() << endl
+       << "* Frames with copied baskets:   " << merger.GetNFramesCopied() << endl
+       << "* Time taken:                   " << sw.RealTime() << " s" << endl;
+
+  if (!ok) {
+    cout << "ERROR: the merge failed." << endl;
+    return 1;
+  }
+
+  return 0;
+
+}
+
+/// @brief Checks the validity of the input arguments.
+///
+/// @param[in] argc Input argument numbers.
+/// @param[in] argv Input argument values.
+void checkParameters(int argc, char ** argv){
+
+  if(argc < 3) {
+    cout
+      << endl
+      << "ERROR: insufficient input arguments!" << endl
+      << endl
+      << "Usage: " << endl
+      << endl
+      << "./Mf-merge "
+      << "[output ROOT file] "
+      << "[input ROOT file] {[input ROOT file] ...} "
+      << "{--time-order} {--memory=MB} {--options}"
+      << endl
+      << endl;
+    ConverterOptions::PrintUsage();
+    exit(1);
+  }
+
+}//end of checkParameters helper function.
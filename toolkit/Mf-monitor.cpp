@@ -0,0 +1,98 @@
+/// @file Mf-monitor.cpp
+/// @brief Code for the Mf-monitor executable: follows a live frame ring.
+
+// Standard includes.
+#include <stdlib.h>
+#include <iostream>
+#include <iomanip>
+
+// ROOT includes.
+#include "TString.h"
+
+// Toolkit includes.
+#include "FrameRing.h"
+
+using namespace std;
+
+// Forward declaration of helper functions.
+void checkParameters(int, char**);
+
+
+/// @brief Mf-monitor: prints the frames published by a running converter.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// The converters publish to the ring when run with --shm-ring=NAME.
+///
+/// @param[in] argc Input argument numbers.
+/// @param[in] argv Input argument values.
+int main(int argc, char ** argv) {
+
+  checkParameters(argc, argv);
+
+  cout << "" << endl
+       << "=========================" << endl
+       << " CERN@school: Mf-monitor " << endl
+       << "=========================" << endl
+       << "*" << endl;
+
+  cout << "* Frame ring name:             '" << argv[1] << "'" << endl;
+
+  // The number of frames to read (0: until the ring goes quiet).
+  Int_t num_frames_to_read = 0;
+  if (argc > 2) num_frames_to_read = atoi(argv[2]);
+
+  FrameRingReader reader(argv[1]);
+  if (!reader.IsOpen()) return 1;
+
+  FrameRingFrame frame;
+
+  Int_t nread = 0;
+
+  // Wait up to 10 seconds for each frame.
+  while (reader.Next(frame, 10000)) {
+
+    cout
+      << "* Frame " << setw(8) << frame.frameId
+      << " | t = " << fixed << setprecision(3) << frame.startTime
+      << " | " << setw(6) << frame.occupancy << " pixels"
+      << " | ToT " << setw(8) << frame.totalToT
+      << " | clusters " << frame.nClusters
+      << " | " << frame.dataset << endl;
+
+    nread++;
+    if (num_frames_to_read > 0 && nread >= num_frames_to_read) break;
+
+  }
+
+  cout
+    << "*" << endl
+    << "* Frames read:    " << nread << endl
+    << "* Frames dropped: " << reader.GetNDropped() << endl;
+
+  return 0;
+
+}
+
+/// @brief Checks the validity of the input arguments.
+///
+/// @param[in] argc Input argument numbers.
+/// @param[in] argv Input argument values.
+void checkParameters(int argc, char ** argv){
+
+  if(argc < 2) {
+    cout
+      << endl
+      << "ERROR: insufficient input arguments!" << endl
+      << endl
+      << "Usage: " << endl
+      << endl
+      << "./Mf-monitor "
+      << "[frame ring name] "
+      << "{no. of frames to read}"
+      << endl;
+    exit(1);
+  }
+
+}//end of checkParameters helper function.
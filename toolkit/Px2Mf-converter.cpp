@@ -10,8 +10,10 @@
 
 // toolkit include statements.
 #include "ListHandler.h"
-#include "WriteToNtuple.h"
+#include "OutputManager.h"
 #include "Frames.h"
+#include "FrameRing.h"
+#include "ConverterOptions.h"
 
 using namespace std;
 
@@ -30,6 +32,13 @@ int main(int argc, char ** argv) {
     << "==============================" << endl;
 
 
+  // Extract the optional "--name=value" settings.
+  ConverterOptions options;
+  if (!options.Parse(argc, argv)) {
+    ConverterOptions::PrintUsage();
+    exit(1);
+  }
+
   // Check the input arguments
   TString tempScratchDir("");
   checkParameters(argc, argv, &tempScratchDir);
@@ -40,8 +49,18 @@ int main(int argc, char ** argv) {
   // Get the dataset path from the input arguments.
   TString dataset = argv[2];
 
-  // Instantiate the WriteToNtuple object.
-  WriteToNtuple * MPXnTuple = new WriteToNtuple(dataset, tempScratchDir);
+  // Instantiate the output manager (which starts a new ROOT file
+  // every --file-size MB, if set).
+  OutputManager * MPXnTuple = new OutputManager(dataset, tempScratchDir, options);
+
+  // Publish the frames to a shared-memory ring for live monitors?
+  FrameRingWriter * ring = 0;
+  if (options.shmRing.Length() > 0) {
+    ring = new FrameRingWriter(options.shmRing,
+                               options.shmRingSlots,
+                               options.shmRingMaxPixels);
+    MPXnTuple->SetFrameRing(ring);
+  }
 
   // Instantiate the FramesHandler object.
   FramesHandler frames(dataset);
@@ -154,12 +173,17 @@ int main(int argc, char ** argv) {
   }//end of loop over the list of files.
 
   // Close the ntuple and update the user on progress.
-  MPXnTuple->closeNtuple();
+  MPXnTuple->Close();
+
+  // Remove the shared-memory ring.
+  if (ring) delete ring;
 
   cout
     << "*"                                                               << endl
-    << "* Conversion finished."                                          << endl
-    << "* The output file is '" << MPXnTuple->GetNtupleFileName() << "'" << endl;
+    << "* Conversion finished."                                          << endl;
+  for (UInt_t i = 0; i < MPXnTuple->GetFileNames().size(); ++i) {
+    cout << "* The output file is '" << MPXnTuple->GetFileNames()[i] << "'" << endl;
+  }
 
 
   // Erase any temporary files
@@ -210,7 +234,7 @@ void checkParameters(int argc, char ** argv, TString * tempScratchDir){
       << "INFO: * Px2Mf-converter - usage:" << endl
       << "INFO: * "
       << argv[0] << " pathToData outputFileName "
-      << "{tempScratchDir} {skip}"                                  << endl
+      << "{tempScratchDir} {skip} {--options}"                      << endl
       << "INFO:"                                                    << endl
       << "INFO: *--> [inputPath]  : The path to the folder "        << endl
       << "INFO:                     containing the data."           << endl
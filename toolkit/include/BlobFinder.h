@@ -9,11 +9,15 @@
 #include <map>
 #include <list>
 #include <set>
+#include <vector>
 #include <math.h>
 
 // ROOT include statements.
 #include "TROOT.h"
 
+// Local include statements.
+#include "ClusterFinder.h"
+
 using namespace std;
 
 
@@ -148,7 +152,10 @@ class Blob {
   /// @return The total counts in the Blob.
   inline Double_t getTotalEnergy() { return totalEnergy; }
 
-  /// @brief Free up the Blob.
+  /// @brief Free up the Blob (deleting its pixels).
+  ///
+  /// Only for pixels made with new: a BlobFinder's blobs point into
+  /// its own pixel block, which it frees itself.
   void freeBlob();
 
 };//end of Blob class definition.
@@ -157,6 +164,17 @@ class Blob {
 ///
 /// @author Son Hoang (principle author).
 /// @author T. Whyntie (editor for CERN\@school).
+///
+/// The pixels are grouped by a ClusterFinder (one per thread, kept
+/// from frame to frame); the blobs come in the order of their first
+/// pixel (in X), with their pixels in X order. Each pixel's mask has
+/// bit dir set for each neighbour hit (see findBlobs); the neighbour
+/// pointers are not set.
+///
+/// The BlobFinder is kept for its Blob and Pixel objects, which cost
+/// a list and a set entry per pixel, for the converters' cross-check
+/// (--blobfinder-every) and older code. Everything else should use a
+/// ClusterFinder directly, which allocates nothing per pixel.
 class BlobFinder {
   
  public:
@@ -168,6 +186,15 @@ class BlobFinder {
   /// @param [in] C The number of columns (frame width).
   BlobFinder(std::map<int,int> const & data, Int_t R, Int_t C);
 
+  /// @brief Constructor (pixel arrays, e.g. one frame of a FrameBatch).
+  ///
+  /// @param [in] X The pixel X values (sorted in X).
+  /// @param [in] counts The pixel ToT counts.
+  /// @param [in] n The number of pixels.
+  /// @param [in] R The number of rows (frame height).
+  /// @param [in] C The number of columns (frame width).
+  BlobFinder(Int_t const * X, Int_t const * counts, UInt_t n, Int_t R, Int_t C);
+
   /// @brief Destructor.
   ~BlobFinder();
 
@@ -189,6 +216,27 @@ class BlobFinder {
   /// @return The list of blobs.
   inline list<Blob> & getList() { return listBlob; }
 
+ private:
+
+  /// @brief Copy constructor (not implemented; the blobs point into m_pixels).
+  BlobFinder(const BlobFinder &);
+
+  /// @brief Copy assignment operator (not implemented).
+  BlobFinder & operator=(const BlobFinder &);
+
+  /// @brief The pixels of all of the blobs.
+  std::vector<Pixel> m_pixels;
+
+  /// @brief Group the pixels into blobs.
+  ///
+  /// @param [in] X The pixel X values.
+  /// @param [in] counts The pixel counts.
+  /// @param [in] n The number of pixels.
+  /// @param [in] R The number of rows (frame height).
+  /// @param [in] C The number of columns (frame width).
+  void findBlobs(Int_t const * X, Int_t const * counts, UInt_t n,
+                 Int_t R, Int_t C);
+
 };//end of BlobFinder class definition.
 
 #endif	/* BlobFinder_h */
@@ -8,6 +8,7 @@
 #include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <vector>
 
 // ROOT include statements.
 #include "TString.h"
@@ -18,8 +19,15 @@
 // Local include statements.
 #include "CalibMetadata.h"
 #include "Frames.h"
+#include "FrameRing.h"
+#include "FrameQueue.h"
+#include "OutputManager.h"
+#include "ConverterOptions.h"
 #include "Utils.h"
 #include "BlobFinder.h"
+#include "ClusterLogParser.h"
+#include "ClusterValidator.h"
+#include "ValidationCounters.h"
 
 using namespace std;
 
@@ -33,6 +41,21 @@ using namespace std;
 ///
 /// This class owes a debt to J. Idarraga's Mafalda code:
 /// * [Mafalda](https://twiki.cern.ch/twiki/bin/view/Main/MAFalda).
+///
+/// With --read-threads the cluster log file is mapped a window
+/// (--read-window) at a time. Each window is split at the blank lines
+/// between frames and the parts are parsed in parallel, each into a
+/// small queue of reused frame buffers. The queues are drained in file
+/// order, so the frames are checked and written as they are parsed, and
+/// the next window is parsed while the last part of a window is written.
+///
+/// The clusters given in the file are checked as each frame is read
+/// (see ClusterValidator); --blobfinder-every=N also re-clusters every
+/// Nth frame with the BlobFinder as a cross-check.
+///
+/// The cluster of each pixel (numbered from 1 in file order within the
+/// frame) is stored with the frame, so analyses needn't re-cluster it
+/// (see FrameContainer::GetClusterIds and GetClusters).
 class Cl2MfConverter {
 
  public:
@@ -45,13 +68,15 @@ class Cl2MfConverter {
   /// @param [in] frames_per_root_file The number of frames per ROOT file.
   /// @param [in] num_frames_to_read The number of frames to read.
   /// @param [in] dbg Run in debug mode.
+  /// @param [in] options The optional converter settings.
   explicit Cl2MfConverter(
     TString datasetpath,
     TString datasetmetadata,
     TString outputdir,
     Int_t   frames_per_root_file,
     Int_t   num_frames_to_read,
-    Bool_t dbg = false);
+    Bool_t dbg = false,
+    ConverterOptions const & options = ConverterOptions());
 
   /// @brief Destructor.
   ~Cl2MfConverter();
@@ -77,7 +102,7 @@ class Cl2MfConverter {
 
   //void fillVars(FramesHandler *, bool rmd = true);
 
-  /// @brief Closes the current ntuple file.
+  /// @brief Closes the ntuple files.
   void closeNtuple();
 
 
@@ -85,14 +110,56 @@ class Cl2MfConverter {
 
   // Private methods
 
+  /// @brief Opens the output ntuple files.
+  ///
+  /// @param [in] frames_per_root_file The number of frames per ROOT file.
+  void openNtuple(Int_t frames_per_root_file);
+
   /// @brief Process the next frame from the cluster log file.
   Bool_t processNextFrame(Bool_t dbg = false);
 
+  /// @brief Process the cluster log file on several threads.
+  ///
+  /// @param [in] datasetpath The full path of the cluster log file.
+  /// @param [in] num_frames_to_read The number of frames to read.
+  /// @param [in] dbg Debug mode?
+  void processParallel(TString datasetpath, Int_t num_frames_to_read, Bool_t dbg = false);
+
+  /// @brief Parse the frames in part of the cluster log file.
+  ///
+  /// @param [in] begin The start of the part (the start of a frame).
+  /// @param [in] end The end of the part (the end of a frame).
+  /// @param [in] num_frames_to_read The last frame to parse (if > 0).
+  /// @param [out] frames The queue the parsed frames are handed over
+  ///                     to, in file order (closed at the end).
+  /// @param [in,out] counters The parsing thread's validation counts.
+  void parseChunk(const char * begin, const char * end, Int_t num_frames_to_read,
+                  FrameQueue * frames, ValidationCounters * counters);
+
+  /// @brief Set the metadata and statistics of a complete frame.
+  ///
+  /// @param [in] frame The frame.
+  /// @param [in] clusters_in_frame The number of clusters read.
+  void completeFrame(FrameStruct * frame, Long_t clusters_in_frame);
+
+  /// @brief Check the clusters of a complete frame and count them.
+  ///
+  /// @param [in] frame The frame.
+  /// @param [in] pixels_in_frame The number of pixels read.
+  /// @param [in] clusters_in_frame The number of clusters read.
+  /// @param [in,out] validator The validator given the frame's clusters.
+  /// @param [in,out] counters The validation counts.
+  /// @param [in] dbg Debug mode?
+  void checkClusters(FrameStruct * frame, Long_t pixels_in_frame, Long_t clusters_in_frame,
+                     ClusterValidator * validator, ValidationCounters * counters,
+                     Bool_t dbg = false);
+
   /// @brief Process a cluster from a line of the cluster log file.
   ///
   /// @param [in] clusterline Line from the cluster log file.
+  /// @param [in] cluster The cluster ID (from 1) within the frame.
   /// @param [in] dbg Debug mode?
-  Int_t processCluster(string clusterline, Bool_t dbg = false);
+  Int_t processCluster(string const & clusterline, Int_t cluster, Bool_t dbg = false);
 
   // Private members
 
@@ -123,24 +190,21 @@ class Cl2MfConverter {
   /// @brief The current output path.
   TString m_outputPath;
 
-  /// @brief Pointer to the current ntuple file.
-  TFile * m_pNt;
+  /// @brief The output manager writing the ntuple files.
+  OutputManager * m_pOutput;
 
-  /// @brief Pointer to the TTree.
-  TTree * m_pTr;
+  /// @brief The optional converter settings (used for each new file).
+  ConverterOptions m_options;
 
   /// @brief Pointer to the current frame container.
   FrameStruct * m_pFrame; 
 
+  /// @brief The shared-memory ring the frames are published to (if any).
+  FrameRingWriter * m_pRing;
+
   /// @brief The current frame number.
   Long_t m_currentFrameNumber; 
 
-  // Clustering
-  //------------
-  
-  ///  @brief A pointer to the BlobFinder (for cluster validation).
-  BlobFinder * m_bf;
-
   // Validation
   //------------
 
@@ -153,35 +217,11 @@ class Cl2MfConverter {
   /// @brief The path of the validation ROOT file.
   TString m_valPath;
 
-  /// @brief Histogram counter for the number of frames extracted.
-  TH1D * m_hg_nframes_ex;
-
-  /// @brief Histogram counter for the number of lines in the cluster file.
-  TH1D * m_hg_nLines_ex;
-
-  /// @brief Histogram counter for the number of frame headers extracted.
-  TH1D * m_hg_nHeaders_ex;
-
-  /// @brief Histogram counter for the number of clusters extracted.
-  TH1D * m_hg_nClusters_ex;
-
-  /// @brief Histogram counter for the number of blank lines extracted.
-  TH1D * m_hg_nBlanks_ex;
-
-  /// @brief Histogram for the number of clusters per frame (extracted).
-  TH1D * m_hg_nClustersPf_ex;
-
-  /// @brief Histogram for the number of clusters per frame (BlobFinder).
-  TH1D * m_hg_nClustersPf_bf;
-
-  /// @brief Histogram for the number of pixels per frame (extracted).
-  TH1D * m_hg_nPixelsPf_ex;
-
-  /// @brief Histogram for the number of pixels per frame (frame container).
-  TH1D * m_hg_nPixelsPf_fc;
+  /// @brief The validation counts (written to the validation file at the end).
+  ValidationCounters m_counters;
 
-  /// @brief Histogram for the pixels per cluster.
-  TH1D * m_hg_ppc_ex;
+  /// @brief The cluster validator (for the line-by-line reader).
+  ClusterValidator * m_pValidator;
 
   /// @brief Pseudo-histogram for the start and end times.
   TH1D * m_phg_times;
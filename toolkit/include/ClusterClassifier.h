@@ -0,0 +1,175 @@
+/// @file ClusterClassifier.h
+/// @brief Header file for the ClusterClassifier class.
+
+#ifndef ClusterClassifier_h
+#define ClusterClassifier_h 1
+
+// Standard include statements.
+#include <vector>
+
+// ROOT include statements.
+#include "TROOT.h"
+#include "TString.h"
+
+using namespace std;
+
+// Forward declarations.
+class ClusterProperties;
+
+/// @brief Sorts clusters into classes (gamma, beta, ... candidates)
+/// with a table of cuts on their properties.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// Each class is a list of cuts, lo <= value < hi, on the variables
+/// of ClusterProperties. A cluster goes to the first class whose cuts
+/// it passes (-1 if none), so a later class with looser cuts takes
+/// what the earlier ones leave. A group is a sum of classes, counted
+/// as well as the classes.
+///
+/// The default table is that of rate-plotter.py:
+/// * g1, g2: one- and two-pixel clusters (gamma candidates);
+/// * g3, b3: three-pixel clusters with radius below 0.75 (gamma) or
+///   not (beta candidates);
+/// * g4, b4: four-pixel clusters with radius below 0.71 or not;
+/// * lc: larger clusters;
+/// * the groups g (g1-g4), bs (b3, b4) and nongam (b3, b4, lc).
+///
+/// A cut table file replaces it, with one class or group per line:
+/// @verbatim
+/// # name     variable min max ...   (* for no limit)
+/// class g1   size 1 2
+/// class g3   size 3 4  radius * 0.75
+/// class alpha size 5 * densityU 0.5 *  linearity * 0.5
+/// class muon  size 5 * linearity 0.99 *
+/// group g    g1 g3
+/// @endverbatim
+///
+/// Classify() doesn't change the classifier, so one classifier can be
+/// used by many threads at once.
+class ClusterClassifier {
+
+ public:
+
+  /// @brief The variables that can be cut on.
+  enum Variable {
+    kSize,       ///< The number of pixels.
+    kTotalToT,   ///< The total ToT.
+    kMaxToT,     ///< The largest pixel ToT.
+    kWidth,      ///< The bounding box width [pixels].
+    kHeight,     ///< The bounding box height [pixels].
+    kRadiusU,    ///< The unweighted radius [pixels].
+    kDensityU,   ///< The unweighted spatial density.
+    kLinearity,  ///< The linearity.
+    kNVariables
+  };
+
+  /// @brief Get the name of a variable (as used in the cut tables).
+  static const char * GetVariableName(Int_t v);
+
+  /// @brief Find a variable by name.
+  ///
+  /// @return The variable (-1 if there is none of that name).
+  static Int_t FindVariable(TString name);
+
+  /// @brief Constructor (the default table).
+  ClusterClassifier();
+
+  /// @brief Destructor.
+  ~ClusterClassifier();
+
+  /// @brief Remove all of the classes and groups.
+  void Clear();
+
+  /// @brief Set up the classes and groups of rate-plotter.py.
+  void SetDefaultTable();
+
+  /// @brief Replace the classes and groups with those of a cut table.
+  ///
+  /// @param [in] path The cut table file.
+  /// @return Was the table read? (If not, the classifier is empty.)
+  Bool_t ReadCutTable(TString path);
+
+  /// @brief Add a class, after the others.
+  ///
+  /// @param [in] name The class name.
+  /// @return The class number.
+  Int_t AddClass(TString name);
+
+  /// @brief Add a cut, lo <= value < hi, to the last class added.
+  ///
+  /// @param [in] v The variable.
+  /// @param [in] lo The lower limit.
+  /// @param [in] hi The upper limit.
+  void AddCut(Int_t v, Double_t lo, Double_t hi);
+
+  /// @brief Add a group of classes.
+  ///
+  /// @param [in] name The group name.
+  /// @param [in] classes The names of its classes.
+  /// @return Were all of the classes found?
+  Bool_t AddGroup(TString name, vector<TString> const & classes);
+
+  /// @brief Find a class by name.
+  ///
+  /// @return The class number (-1 if there is none of that name).
+  Int_t FindClass(TString name) const;
+
+  /// @brief Get the number of classes.
+  Int_t GetNClasses() const { return m_classNames.size(); }
+
+  /// @brief Get the name of a class.
+  TString GetClassName(Int_t c) const { return m_classNames[c]; }
+
+  /// @brief Get the number of groups.
+  Int_t GetNGroups() const { return m_groupNames.size(); }
+
+  /// @brief Get the name of a group.
+  TString GetGroupName(Int_t g) const { return m_groupNames[g]; }
+
+  /// @brief Get the number of counts given by Classify() (one per
+  /// class, then one per group).
+  Int_t GetNCounts() const { return GetNClasses() + GetNGroups(); }
+
+  /// @brief Classify the clusters of a frame.
+  ///
+  /// @param [in] properties The cluster properties.
+  /// @param [in] frame The frame (in the properties).
+  /// @param [out] labels The class of each of the frame's clusters (-1
+  ///                     for none).
+  /// @param [out] counts The number of clusters in each class, then in
+  ///                     each group (GetNCounts() values).
+  void Classify(ClusterProperties const & properties, UInt_t frame,
+                Int_t * labels, Int_t * counts) const;
+
+  /// @brief Print the classes and groups.
+  void Print() const;
+
+ private:
+
+  /// @brief A cut on a variable.
+  struct Cut {
+    Int_t    v;  ///< The variable.
+    Double_t lo; ///< The lower limit.
+    Double_t hi; ///< The upper limit.
+  };
+
+  /// @brief The class names.
+  vector<TString> m_classNames;
+
+  /// @brief The start of each class's cuts in m_cuts, then the end.
+  vector<UInt_t> m_cutOffsets;
+
+  /// @brief The cuts, class by class.
+  vector<Cut> m_cuts;
+
+  /// @brief The group names.
+  vector<TString> m_groupNames;
+
+  /// @brief The classes of each group.
+  vector< vector<Int_t> > m_groups;
+
+};//end of ClusterClassifier class definition.
+
+#endif
@@ -0,0 +1,183 @@
+/// @file ClusterFinder.h
+/// @brief Header file for the ClusterFinder class.
+
+#ifndef ClusterFinder_h
+#define ClusterFinder_h 1
+
+// Standard include statements.
+#include <map>
+#include <vector>
+
+// ROOT include statements.
+#include "TROOT.h"
+
+using namespace std;
+
+/// @brief Finds the clusters (8-connected groups) of a frame's pixels.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// The pixels are put on a dense grid of pixel indices, joined to
+/// their neighbours with a union-find, and sorted into clusters with a
+/// counting sort. Only the grid entries that were set are cleared
+/// afterwards, so a frame costs time in proportion to its pixels, and
+/// once the buffers have grown to the largest frame seen no more
+/// memory is allocated.
+///
+/// Frames with many hit pixels (beam and calibration frames) take a
+/// second path: the pixels are set in a bit mask of 64-bit words, the
+/// runs of set bits in each row are found a word at a time, and the
+/// runs are joined to the runs they touch in the row before (run-based
+/// labelling). Find() takes this path when the frame's occupancy is at
+/// least SetDenseOccupancy() (1/8 by default: for frames of tracks and
+/// blobs the bit mask path is faster from a few percent, but for
+/// scattered single hits only from about a third). Both paths give the
+/// same clusters, in the same order.
+///
+/// The clusters are numbered in the order of their first pixel. For
+/// pixels sorted in X (e.g. from the pixel map) this is the order of
+/// the BlobFinder's blobs, and the clusters hold the same pixels.
+/// Within a cluster the pixels are in input order.
+class ClusterFinder {
+
+ public:
+
+  /// @brief Constructor.
+  ///
+  /// @param [in] width The frame width [pixels].
+  /// @param [in] height The frame height [pixels].
+  ClusterFinder(Int_t width, Int_t height);
+
+  /// @brief Find the clusters of a frame's pixels.
+  ///
+  /// @param [in] X The pixel X (y*width + x) values (each given once).
+  /// @param [in] n The number of pixels.
+  /// @return The number of clusters.
+  ///
+  /// A pixel outside of the frame is a cluster on its own.
+  UInt_t Find(Int_t const * X, UInt_t n);
+
+  /// @brief Find the clusters of a frame's pixels.
+  ///
+  /// @param [in] pixels The map of pixel X to ToT counts.
+  /// @return The number of clusters.
+  UInt_t Find(map<int,int> const & pixels);
+
+  /// @brief Set the occupancy (fraction of the frame's pixels hit) from
+  /// which the bit mask path is used.
+  ///
+  /// @param [in] occupancy The occupancy (0: always; > 1: never).
+  void SetDenseOccupancy(Double_t occupancy);
+
+  /// @brief Get the frame width [pixels].
+  Int_t GetWidth() const { return m_width; }
+
+  /// @brief Get the frame height [pixels].
+  Int_t GetHeight() const { return m_height; }
+
+  /// @brief Get the number of clusters found.
+  UInt_t GetNClusters() const { return m_nClusters; }
+
+  /// @brief Get the number of pixels in a cluster.
+  ///
+  /// @param [in] i The cluster number (from 0).
+  UInt_t GetClusterSize(UInt_t i) const { return m_offsets[i+1] - m_offsets[i]; }
+
+  /// @brief Get the pixels in a cluster.
+  ///
+  /// @param [in] i The cluster number (from 0).
+  /// @return The indices of the cluster's pixels in the input.
+  UInt_t const * GetClusterPixels(UInt_t i) const { return &m_pixels[m_offsets[i]]; }
+
+  /// @brief Get the start of each cluster in GetPixels(), then the
+  /// number of pixels.
+  vector<UInt_t> const & GetOffsets() const { return m_offsets; }
+
+  /// @brief Get the indices of the pixels in the input, cluster by cluster.
+  vector<UInt_t> const & GetPixels() const { return m_pixels; }
+
+  /// @brief Get the cluster number (from 0) of each pixel in the input.
+  vector<UInt_t> const & GetLabels() const { return m_labels; }
+
+ private:
+
+  /// @brief Label the pixels by looking up their neighbours on the grid.
+  void findSparse(Int_t const * X, UInt_t n);
+
+  /// @brief Label the pixels by joining the runs of a bit mask.
+  ///
+  /// @return Were the pixels also sorted into their clusters (as they
+  /// are, a run at a time, for pixels sorted in X)?
+  Bool_t findDense(Int_t const * X, UInt_t n);
+
+  /// @brief Sort the labelled pixels into their clusters.
+  void sortPixels(UInt_t n);
+
+  /// @brief Find the root of a pixel's group (halving the paths as it goes).
+  UInt_t find(UInt_t i) {
+    while (m_parent[i] != i) {
+      m_parent[i] = m_parent[m_parent[i]];
+      i = m_parent[i];
+    }
+    return i;
+  }
+
+  /// @brief Join the groups of two pixels (or runs).
+  ///
+  /// The root is always the group's first pixel (or run).
+  void join(UInt_t a, UInt_t b) {
+    a = find(a);
+    b = find(b);
+    if (a < b) m_parent[b] = a;
+    else if (b < a) m_parent[a] = b;
+  }
+
+  /// @brief The frame width [pixels].
+  Int_t m_width;
+
+  /// @brief The frame height [pixels].
+  Int_t m_height;
+
+  /// @brief The pixel index + 1 at each X (0: no pixel).
+  vector<UInt_t> m_grid;
+
+  /// @brief The number of mask words per row.
+  Int_t m_words;
+
+  /// @brief The hit mask (bit x%64 of word y*m_words + x/64).
+  vector<ULong64_t> m_mask;
+
+  /// @brief The number of pixels from which the bit mask path is used.
+  UInt_t m_denseMin;
+
+  /// @brief The first x and the last x + 1 of each run, row by row.
+  vector<Int_t> m_runStart, m_runEnd;
+
+  /// @brief The first run of each row, then the number of runs.
+  vector<UInt_t> m_rowRuns;
+
+  /// @brief The cluster number of each root run.
+  vector<UInt_t> m_runLabels;
+
+  /// @brief The union-find parent of each pixel (or run).
+  vector<UInt_t> m_parent;
+
+  /// @brief The cluster number of each pixel.
+  vector<UInt_t> m_labels;
+
+  /// @brief The start of each cluster in m_pixels, then the number of pixels.
+  vector<UInt_t> m_offsets;
+
+  /// @brief The pixel indices, cluster by cluster.
+  vector<UInt_t> m_pixels;
+
+  /// @brief The pixel X values (when given a pixel map).
+  vector<Int_t> m_X;
+
+  /// @brief The number of clusters found.
+  UInt_t m_nClusters;
+
+};//end of ClusterFinder class definition.
+
+#endif
@@ -0,0 +1,106 @@
+/// @file ClusterLogParser.h
+/// @brief Header file for the ClusterLogParser class.
+
+#ifndef ClusterLogParser_h
+#define ClusterLogParser_h 1
+
+// Standard include statements.
+#include <string.h>
+
+// ROOT include statements.
+#include "TROOT.h"
+
+/// @brief Parses the lines of a Pixelman cluster log file in place.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// The file is made of frames, each a header line, one line per
+/// cluster, and a blank line:
+///
+///     Frame 1 (1336049775.586539 s, 0.03 s)
+///     [6, 0, 200] [7, 0, 61]
+///     [44, 0, 119]
+///
+/// Each line is read with a single forward scan over [begin, end),
+/// which needn't be null terminated, so the lines can be parsed
+/// straight from a read buffer or a mapped file without copies.
+class ClusterLogParser {
+
+ public:
+
+  /// @brief Is the line a frame header ("Frame n (t s, a s)")?
+  static Bool_t IsHeader(const char * begin, const char * end) {
+    return memchr(begin, '(', end - begin) != 0;
+  }
+
+  /// @brief Is the line blank (the end of a frame)?
+  static Bool_t IsBlank(const char * begin, const char * end) {
+    return begin == end || (end - begin == 1 && *begin == '\r');
+  }
+
+  /// @brief Parse a frame header line.
+  ///
+  /// @param [in] begin The start of the line.
+  /// @param [in] end The end of the line.
+  /// @param [out] frame The frame number.
+  /// @param [out] startTime The frame start time [s].
+  /// @param [out] acqTime The acquisition time [s].
+  /// @return Was the line a header?
+  static Bool_t ParseHeader(const char * begin, const char * end,
+                            Int_t & frame, Double_t & startTime, Double_t & acqTime);
+
+  /// @brief Parse the "[x, y, C]" pixels of a cluster line.
+  ///
+  /// @param [in] begin The start of the line.
+  /// @param [in] end The end of the line.
+  /// @param [in] fill Called as fill(x, y, C) for each pixel.
+  /// @return The number of pixels.
+  template <class Fill>
+  static Int_t ParseCluster(const char * begin, const char * end, Fill fill) {
+
+    Int_t n = 0;
+    const char * p = begin;
+    while ((p = (const char *)memchr(p, '[', end - p)) != 0) {
+      ++p;
+      Int_t x = parseInt(p, end);
+      Int_t y = parseInt(p, end);
+      Int_t C = parseInt(p, end);
+      fill(x, y, C);
+      ++n;
+      if (p >= end) break;
+    }
+
+    return n;
+
+  }
+
+ private:
+
+  /// @brief Read the next integer, skipping anything before it.
+  ///
+  /// @param [in,out] p The position (left after the number).
+  /// @param [in] end The end of the line.
+  static Int_t parseInt(const char *& p, const char * end) {
+
+    while (p < end && (*p < '0' || *p > '9') && *p != '-' && *p != ']') ++p;
+
+    Bool_t negative = (p < end && *p == '-');
+    if (negative) ++p;
+
+    Int_t v = 0;
+    while (p < end && *p >= '0' && *p <= '9') v = 10*v + (*p++ - '0');
+
+    return negative ? -v : v;
+
+  }
+
+  /// @brief Read the next decimal number, skipping anything before it.
+  ///
+  /// @param [in,out] p The position (left after the number).
+  /// @param [in] end The end of the line.
+  static Double_t parseDouble(const char *& p, const char * end);
+
+};//end of ClusterLogParser class definition.
+
+#endif
@@ -0,0 +1,230 @@
+/// @file ClusterProperties.h
+/// @brief Header file for the ClusterProperties class.
+
+#ifndef ClusterProperties_h
+#define ClusterProperties_h 1
+
+// Standard include statements.
+#include <vector>
+
+// ROOT include statements.
+#include "TROOT.h"
+#include "TString.h"
+
+using namespace std;
+
+// Forward declarations.
+class TTree;
+class FrameStruct;
+class FrameBatch;
+class ClusterFinder;
+
+/// @brief The properties of the clusters of one or more frames.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// The properties computed in Python by clustering.py, plus a few
+/// more, for every cluster:
+/// * the size, total and maximum ToT, and bounding box;
+/// * the unweighted and ToT-weighted centroids;
+/// * the radius (the furthest pixel from the unweighted centroid)
+///   and spatial density, size/(pi r^2) (0 for a single pixel);
+/// * the linearity, 1 - l2/l1 for the eigenvalues l1 >= l2 of the
+///   pixel position covariance (0 for round clusters, 1 for lines).
+///
+/// A frame's pixels are first gathered into x, y and ToT arrays in
+/// cluster order. Each cluster is then two loops over contiguous
+/// integer arrays: the sums, products and extents, then the largest
+/// squared distance from the centroid (kept in integers, n^2 times
+/// the true value, so there is no division in the loop). Both loops
+/// vectorize.
+///
+/// The properties are held as columns, one entry per cluster, with
+/// the clusters of frame i from GetFrameBegin(i) to GetFrameEnd(i).
+/// Branch() adds the columns to a TTree as vector branches: clear,
+/// add a frame and fill for one entry per frame.
+class ClusterProperties {
+
+ public:
+
+  /// @brief Constructor.
+  ClusterProperties();
+
+  /// @brief Empty the columns (the allocated memory is kept).
+  void Clear();
+
+  /// @brief Add the clusters of a frame.
+  ///
+  /// @param [in] X The pixel X (y*width + x) values.
+  /// @param [in] C The pixel ToT counts.
+  /// @param [in] width The frame width [pixels].
+  /// @param [in] offsets The start of each cluster in pixels, then the
+  /// number of pixels (nclusters + 1 entries).
+  /// @param [in] pixels The indices of the pixels, cluster by cluster.
+  /// @param [in] nclusters The number of clusters.
+  /// @return The number of clusters added (0 for a frame with no width,
+  ///         which is added with no clusters).
+  UInt_t AddFrame(Int_t const * X, Int_t const * C, Int_t width,
+                  UInt_t const * offsets, UInt_t const * pixels,
+                  UInt_t nclusters);
+
+  /// @brief Add the clusters of a frame, grouping the pixels by their
+  /// stored cluster IDs.
+  ///
+  /// @param [in] X The pixel X (y*width + x) values.
+  /// @param [in] C The pixel ToT counts.
+  /// @param [in] ids The cluster ID of each pixel.
+  /// @param [in] n The number of pixels.
+  /// @param [in] width The frame width [pixels].
+  /// @param [out] labels The cluster number (from 0) of each pixel (0 to
+  ///                    skip; not set for a frame with no width).
+  /// @return The number of clusters added (0 for a frame with no width).
+  ///
+  /// The clusters are numbered in the order of their first pixel, as
+  /// the ClusterFinder numbers them.
+  UInt_t AddFrame(Int_t const * X, Int_t const * C, Int_t const * ids,
+                  UInt_t n, Int_t width, UInt_t * labels = 0);
+
+  /// @brief Add the clusters of a frame.
+  ///
+  /// @param [in] frame The frame.
+  /// @param [in] finder Finds the clusters (unless the frame has them),
+  ///                    and gives the frame size.
+  /// @return The number of clusters added.
+  UInt_t AddFrame(FrameStruct & frame, ClusterFinder & finder);
+
+  /// @brief Add the clusters of every frame of a batch.
+  ///
+  /// @param [in] batch The batch.
+  /// @return The number of clusters added.
+  ///
+  /// The clusters stored with a frame are used if it has any, and
+  /// frames without a size are taken to be Timepix frames (256 x 256).
+  UInt_t AddBatch(FrameBatch const & batch);
+
+  /// @brief Replace the columns with the clusters of one frame of
+  /// another set of properties.
+  ///
+  /// @param [in] other The properties to copy from.
+  /// @param [in] i The frame of other to copy.
+  void CopyFrame(ClusterProperties const & other, UInt_t i);
+
+  /// @brief Add the columns to a TTree as vector branches.
+  ///
+  /// @param [in] tree The TTree.
+  /// @param [in] prefix The start of the branch names.
+  void Branch(TTree * tree, TString prefix = "cluster");
+
+  /// @brief Get the number of clusters.
+  UInt_t GetNClusters() const { return m_size.size(); }
+
+  /// @brief Get the number of frames added.
+  UInt_t GetNFrames() const { return m_frameOffsets.size() - 1; }
+
+  /// @brief Get the index of the first cluster of frame i.
+  UInt_t GetFrameBegin(UInt_t i) const { return m_frameOffsets[i]; }
+
+  /// @brief Get the index after the last cluster of frame i.
+  UInt_t GetFrameEnd(UInt_t i) const { return m_frameOffsets[i+1]; }
+
+  // The columns
+  //-------------
+
+  /// @brief Get the number of pixels in each cluster.
+  vector<Int_t> const & GetSize() const { return m_size; }
+
+  /// @brief Get the total ToT counts of each cluster.
+  vector<Int_t> const & GetTotalToT() const { return m_totalToT; }
+
+  /// @brief Get the maximum pixel ToT of each cluster.
+  vector<Int_t> const & GetMaxToT() const { return m_maxToT; }
+
+  /// @brief Get the minimum x of each cluster [pixels].
+  vector<Int_t> const & GetXMin() const { return m_xMin; }
+
+  /// @brief Get the maximum x of each cluster [pixels].
+  vector<Int_t> const & GetXMax() const { return m_xMax; }
+
+  /// @brief Get the minimum y of each cluster [pixels].
+  vector<Int_t> const & GetYMin() const { return m_yMin; }
+
+  /// @brief Get the maximum y of each cluster [pixels].
+  vector<Int_t> const & GetYMax() const { return m_yMax; }
+
+  /// @brief Get the unweighted x centroid of each cluster [pixels].
+  vector<Double_t> const & GetXBarU() const { return m_xBarU; }
+
+  /// @brief Get the unweighted y centroid of each cluster [pixels].
+  vector<Double_t> const & GetYBarU() const { return m_yBarU; }
+
+  /// @brief Get the ToT-weighted x centroid of each cluster [pixels].
+  vector<Double_t> const & GetXBarC() const { return m_xBarC; }
+
+  /// @brief Get the ToT-weighted y centroid of each cluster [pixels].
+  vector<Double_t> const & GetYBarC() const { return m_yBarC; }
+
+  /// @brief Get the (unweighted) radius of each cluster [pixels].
+  vector<Double_t> const & GetRadiusU() const { return m_rU; }
+
+  /// @brief Get the (unweighted) spatial density of each cluster [pixels^-2].
+  vector<Double_t> const & GetDensityU() const { return m_densityU; }
+
+  /// @brief Get the linearity of each cluster.
+  vector<Double_t> const & GetLinearity() const { return m_linearity; }
+
+ private:
+
+  /// @brief Group a frame's pixels by their stored cluster IDs.
+  ///
+  /// @param [in] ids The cluster ID of each pixel.
+  /// @param [in] n The number of pixels.
+  /// @return The number of clusters.
+  UInt_t groupByIds(Int_t const * ids, UInt_t n);
+
+  // Scratch arrays (kept between frames)
+  //--------------------------------------
+
+  /// @brief The pixel x values, cluster by cluster.
+  vector<Int_t> m_x;
+
+  /// @brief The pixel y values, cluster by cluster.
+  vector<Int_t> m_y;
+
+  /// @brief The pixel ToT counts, cluster by cluster.
+  vector<Int_t> m_c;
+
+  /// @brief A frame's pixel X values and counts (from the pixel map).
+  vector<Int_t> m_frameX, m_frameC, m_frameIds;
+
+  /// @brief The clusters grouped by groupByIds (as the ClusterFinder's).
+  vector<UInt_t> m_idOffsets, m_idPixels;
+
+  /// @brief The cluster number + 1 of each stored ID, and the next
+  /// place in each cluster (for groupByIds).
+  vector<UInt_t> m_idLabels, m_idNext;
+
+  // The columns
+  //-------------
+
+  /// @brief The start of each frame's clusters, then the number of clusters.
+  vector<UInt_t> m_frameOffsets;
+
+  vector<Int_t> m_size;
+  vector<Int_t> m_totalToT;
+  vector<Int_t> m_maxToT;
+  vector<Int_t> m_xMin;
+  vector<Int_t> m_xMax;
+  vector<Int_t> m_yMin;
+  vector<Int_t> m_yMax;
+  vector<Double_t> m_xBarU;
+  vector<Double_t> m_yBarU;
+  vector<Double_t> m_xBarC;
+  vector<Double_t> m_yBarC;
+  vector<Double_t> m_rU;
+  vector<Double_t> m_densityU;
+  vector<Double_t> m_linearity;
+
+};//end of ClusterProperties class definition.
+
+#endif
@@ -0,0 +1,224 @@
+/// @file ClusterService.h
+/// @brief Header file for the ClusterService class.
+
+#ifndef ClusterService_h
+#define ClusterService_h 1
+
+// Standard include statements.
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// ROOT include statements.
+#include "TROOT.h"
+
+// Local include statements.
+#include "Frames.h"
+#include "ClusterProperties.h"
+
+using namespace std;
+
+// Forward declarations.
+class FrameBatch;
+
+/// @brief The clusters of one frame, as given by a ClusterService.
+struct ClusterResult {
+
+  /// @brief The position of the frame among the frames submitted (from 0).
+  Long64_t index;
+
+  Long64_t frameId;     ///< The frame ID.
+  Int_t width;          ///< The frame width [pixels].
+  Int_t height;         ///< The frame height [pixels].
+
+  /// @brief The pixel X values (as submitted).
+  vector<Int_t> pixelX;
+
+  /// @brief The pixel ToT counts.
+  vector<Int_t> pixelC;
+
+  /// @brief The cluster IDs stored with the pixels (empty if none were).
+  vector<Int_t> clusterIds;
+
+  /// @brief The cluster number (from 0) of each pixel (grouped by the
+  /// stored cluster IDs if there are any, found otherwise).
+  vector<UInt_t> labels;
+
+  /// @brief The number of clusters.
+  UInt_t nClusters;
+
+  /// @brief The properties of the clusters (one entry per cluster).
+  ClusterProperties properties;
+
+};
+
+/// @brief Clusters frames on a pool of threads, giving the results in
+/// frame order.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// Frames are submitted one at a time (from a MAFalda file, a frame
+/// ring or a converter) and their pixels copied into one of a fixed
+/// number of buffers, so that nothing is allocated while running and
+/// Submit() waits whenever the results are not being taken.
+///
+/// Each thread has its own queue of frames, and the frames are dealt
+/// out to the queues in turn. A thread whose queue is empty steals
+/// from the others, taking the oldest waiting frame (since the
+/// results go out in frame order, the oldest frames are the ones
+/// being waited for). A frame with tens of thousands of pixels
+/// therefore holds up only its own thread, not the frames behind it.
+///
+/// Frames without a size are taken to be Timepix frames (256 x 256),
+/// and the clusters stored with a frame are used if it has any, as
+/// OutputManager does when classifying inline.
+///
+/// The results are taken with GetResult() in the order the frames
+/// were submitted, and given back with Release(). A thread that both
+/// submits and takes results should check HasFree() before submitting,
+/// taking a result first if there is no free buffer.
+class ClusterService {
+
+ public:
+
+  /// @brief Constructor (starts the threads).
+  ///
+  /// @param [in] nthreads The number of threads (0: one per core).
+  /// @param [in] nbuffers The number of frames held at once.
+  ClusterService(UInt_t nthreads = 0, UInt_t nbuffers = 64);
+
+  /// @brief Destructor (stops the threads and deletes the buffers).
+  ~ClusterService();
+
+  /// @brief Get the number of threads.
+  UInt_t GetNThreads() const { return m_threads.size(); }
+
+  /// @brief Is there a free buffer (so Submit() won't wait)?
+  Bool_t HasFree();
+
+  /// @brief Submit a frame, waiting for a free buffer if necessary.
+  ///
+  /// @param [in] frame The frame.
+  /// @return The frame's index (-1 if the service is closed).
+  Long64_t Submit(FrameStruct & frame);
+
+  /// @brief Submit a frame of a batch, waiting for a free buffer if necessary.
+  ///
+  /// @param [in] batch The batch.
+  /// @param [in] i The frame's index in the batch.
+  /// @return The frame's index (-1 if the service is closed).
+  Long64_t Submit(FrameBatch const & batch, UInt_t i);
+
+  /// @brief Submit a frame, waiting for a free buffer if necessary.
+  ///
+  /// @param [in] frameId The frame ID.
+  /// @param [in] width The frame width [pixels].
+  /// @param [in] height The frame height [pixels].
+  /// @param [in] X The pixel X (y*width + x) values (each given once).
+  /// @param [in] C The pixel ToT counts.
+  /// @param [in] n The number of pixels.
+  /// @param [in] ids The cluster ID of each pixel (0 to find the clusters).
+  /// @return The frame's index (-1 if the service is closed).
+  Long64_t Submit(Long64_t frameId, Int_t width, Int_t height,
+                  Int_t const * X, Int_t const * C, UInt_t n,
+                  Int_t const * ids = 0);
+
+  /// @brief Get the result for the next frame.
+  ///
+  /// @param [in] wait Wait for it if it isn't ready?
+  /// @return The result (0 if not ready, or once closed and drained).
+  ClusterResult const * GetResult(Bool_t wait = true);
+
+  /// @brief Give back a result once it has been used.
+  void Release(ClusterResult const * result);
+
+  /// @brief Signal that no more frames will be submitted.
+  void Close();
+
+  /// @brief Get the number of frames stolen from another thread's queue.
+  Long64_t GetNStolen() const { return m_nStolen.load(memory_order_relaxed); }
+
+ private:
+
+  /// @brief Copy constructor (not implemented).
+  ClusterService(const ClusterService &);
+
+  /// @brief Copy assignment operator (not implemented).
+  ClusterService & operator=(const ClusterService &);
+
+  /// @brief A thread's queue of frames.
+  struct WorkQueue {
+    mutex m_mutex;
+    deque<ClusterResult*> m_frames;
+  };
+
+  /// @brief Take a free buffer, waiting for one if necessary.
+  ///
+  /// @return The buffer, with its index set (0 if the service is closed).
+  ClusterResult * getFree();
+
+  /// @brief Put a filled buffer on the next thread's queue.
+  ///
+  /// @return The frame's index.
+  Long64_t queue(ClusterResult * result);
+
+  /// @brief A thread's loop.
+  ///
+  /// @param [in] t The thread number.
+  void run(UInt_t t);
+
+  /// @brief Take a frame from a thread's own queue, or steal one.
+  ///
+  /// @param [in] t The thread number.
+  /// @return The frame (0 if every queue is empty).
+  ClusterResult * take(UInt_t t);
+
+  /// @brief The threads.
+  vector<thread> m_threads;
+
+  /// @brief The threads' queues.
+  vector<WorkQueue*> m_queues;
+
+  /// @brief The buffers allocated by the service.
+  vector<ClusterResult*> m_owned;
+
+  /// @brief The free buffers.
+  deque<ClusterResult*> m_free;
+
+  /// @brief The finished frames not yet taken, at index % buffers.
+  vector<ClusterResult*> m_done;
+
+  /// @brief The number of frames submitted.
+  Long64_t m_nSubmitted;
+
+  /// @brief The index of the next result to give out.
+  Long64_t m_nextOut;
+
+  /// @brief The number of frames waiting in the queues.
+  atomic<Long64_t> m_nQueued;
+
+  /// @brief The number of frames stolen.
+  atomic<Long64_t> m_nStolen;
+
+  /// @brief Has the submitter finished?
+  Bool_t m_closed;
+
+  /// @brief Guards the buffers, results and flags.
+  mutex m_mutex;
+
+  /// @brief Signalled when a buffer is freed.
+  condition_variable m_freeCond;
+
+  /// @brief Signalled when a frame is queued (or the service closed).
+  condition_variable m_workCond;
+
+  /// @brief Signalled when a frame is finished (or the service closed).
+  condition_variable m_doneCond;
+
+};//end of ClusterService class definition.
+
+#endif
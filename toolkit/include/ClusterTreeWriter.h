@@ -0,0 +1,113 @@
+/// @file ClusterTreeWriter.h
+/// @brief Header file for the ClusterTreeWriter class.
+
+#ifndef ClusterTreeWriter_h
+#define ClusterTreeWriter_h 1
+
+// Standard include statements.
+#include <vector>
+
+// ROOT include statements.
+#include "TROOT.h"
+#include "TString.h"
+
+// Local include statements.
+#include "ClusterProperties.h"
+#include "ConverterOptions.h"
+
+using namespace std;
+
+// Forward declarations.
+class TFile;
+class TTree;
+class ClusterClassifier;
+
+/// @brief Writes the clusters of each frame, and their classes, to
+/// ClusterTree.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// ClusterTree has one entry per frame, with:
+/// * entry, frameId: the frame's position in the input and its ID;
+/// * nClusters: the number of clusters;
+/// * the cluster properties (clusterSize, clusterRadiusU, ..., see
+///   ClusterProperties);
+/// * clusterClass: the class of each cluster (-1 for none);
+/// * n_NAME: the number of clusters in each class and group of the
+///   classifier (n_g1, ..., n_g, n_bs, n_nongam by default).
+///
+/// The class names, in class order, are also written to the file as
+/// the TNamed ClusterClasses (its title holds the names, separated by
+/// spaces), so the clusterClass numbers can be read back.
+class ClusterTreeWriter {
+
+ public:
+
+  /// @brief Constructor (creates the file and the tree).
+  ///
+  /// @param [in] path The output ROOT file.
+  /// @param [in] options The converter settings (compression, flushing).
+  /// @param [in] classifier The classifier (not owned; 0 for none).
+  ClusterTreeWriter(TString path, ConverterOptions const & options,
+                    ClusterClassifier const * classifier);
+
+  /// @brief Destructor (closes the file).
+  ~ClusterTreeWriter();
+
+  /// @brief Was the file created?
+  Bool_t IsOpen() const { return m_tree != 0; }
+
+  /// @brief Classify a frame's clusters and fill the tree.
+  ///
+  /// @param [in] entry The frame's position in the input.
+  /// @param [in] frameId The frame ID.
+  /// @param [in] properties The properties of the clusters of the frame.
+  /// @param [in] frame The frame's number in the properties (e.g. its
+  ///                   place in a batch).
+  void Fill(Long64_t entry, Long64_t frameId, ClusterProperties const & properties,
+            UInt_t frame = 0);
+
+  /// @brief Write the tree and close the file.
+  void Close();
+
+  /// @brief Get the number of clusters written in each class, then in
+  /// each group.
+  vector<Long64_t> const & GetTotals() const { return m_totals; }
+
+ private:
+
+  /// @brief Copy constructor (not implemented).
+  ClusterTreeWriter(const ClusterTreeWriter &);
+
+  /// @brief Copy assignment operator (not implemented).
+  ClusterTreeWriter & operator=(const ClusterTreeWriter &);
+
+  /// @brief The output file.
+  TFile * m_file;
+
+  /// @brief The cluster tree.
+  TTree * m_tree;
+
+  /// @brief The classifier (0 for none).
+  ClusterClassifier const * m_classifier;
+
+  Long64_t m_entry;    ///< The entry branch value.
+  Long64_t m_frameId;  ///< The frameId branch value.
+  Int_t m_nClusters;   ///< The nClusters branch value.
+
+  /// @brief The properties branch values.
+  ClusterProperties m_properties;
+
+  /// @brief The clusterClass branch value.
+  vector<Int_t> m_labels;
+
+  /// @brief The n_NAME branch values.
+  vector<Int_t> m_counts;
+
+  /// @brief The totals over all of the frames.
+  vector<Long64_t> m_totals;
+
+};//end of ClusterTreeWriter class definition.
+
+#endif
@@ -0,0 +1,144 @@
+/// @file ClusterValidator.h
+/// @brief Header file for the ClusterValidator class.
+
+#ifndef ClusterValidator_h
+#define ClusterValidator_h 1
+
+// Standard include statements.
+#include <vector>
+
+// ROOT include statements.
+#include "TROOT.h"
+
+// Local include statements.
+#include "ClusterFinder.h"
+
+using namespace std;
+
+/// @brief Checks the clusters of a cluster log frame in linear time.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// The pixels are added cluster by cluster as they are read. At the
+/// end of the frame the validator checks that:
+/// * every pixel is inside the frame (and so in the frame payload);
+/// * no pixel is given twice (in the same or another cluster);
+/// * each cluster is a single group of touching pixels (8-connected,
+///   as in the BlobFinder), and no two clusters touch.
+///
+/// The touching pixels are grouped by a ClusterFinder, which also
+/// gives the number of clusters the BlobFinder would find.
+class ClusterValidator {
+
+ public:
+
+  /// @brief Constructor.
+  ///
+  /// @param [in] width The frame width [pixels].
+  /// @param [in] height The frame height [pixels].
+  ClusterValidator(Int_t width, Int_t height);
+
+  /// @brief Start a new cluster.
+  void BeginCluster() { ++m_nClusters; }
+
+  /// @brief Add a pixel to the current cluster.
+  ///
+  /// @param [in] x The pixel x coordinate.
+  /// @param [in] y The pixel y coordinate.
+  void AddPixel(Int_t x, Int_t y) {
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height) {
+      ++m_nOutside;
+      return;
+    }
+    Int_t X = y*m_width + x;
+    if (m_grid[X] != 0) {
+      ++m_nDuplicates;
+      return;
+    }
+    m_grid[X] = (Int_t)m_X.size() + 1;
+    m_X.push_back(X);
+    m_cluster.push_back(m_nClusters);
+  }
+
+  /// @brief Check the frame's clusters and clear the validator.
+  ///
+  /// @return Were the clusters valid?
+  Bool_t EndFrame();
+
+  /// @brief Get the number of clusters given in the frame.
+  Int_t GetNClusters() const { return m_lastClusters; }
+
+  /// @brief Get the number of distinct pixels in the frame.
+  Int_t GetNPixels() const { return m_lastPixels; }
+
+  /// @brief Get the number of groups of touching pixels in the frame
+  /// (the number of clusters the BlobFinder finds).
+  Int_t GetNGroups() const { return m_lastGroups; }
+
+  /// @brief Get the number of pixels outside of the frame.
+  Int_t GetNOutside() const { return m_lastOutside; }
+
+  /// @brief Get the number of pixels given more than once.
+  Int_t GetNDuplicates() const { return m_lastDuplicates; }
+
+  /// @brief Get the number of clusters split into separate groups.
+  Int_t GetNSplit() const { return m_lastSplit; }
+
+  /// @brief Get the number of clusters sharing a group with an
+  /// earlier cluster.
+  Int_t GetNTouching() const { return m_lastTouching; }
+
+ private:
+
+  /// @brief Cluster problem flags.
+  enum { kSplit = 1, kTouching = 2 };
+
+  /// @brief The frame width [pixels].
+  Int_t m_width;
+
+  /// @brief The frame height [pixels].
+  Int_t m_height;
+
+  /// @brief The pixel index + 1 at each X (0: no pixel).
+  vector<Int_t> m_grid;
+
+  /// @brief Groups the touching pixels.
+  ClusterFinder m_finder;
+
+  /// @brief The X (y*width + x) of each pixel in the frame.
+  vector<Int_t> m_X;
+
+  /// @brief The cluster (from 1) of each pixel in the frame.
+  vector<Int_t> m_cluster;
+
+  /// @brief The first cluster seen in each group.
+  vector<Int_t> m_owner;
+
+  /// @brief The group of each cluster's first pixel (by cluster).
+  vector<Int_t> m_root;
+
+  /// @brief The problems found with each cluster (kSplit, kTouching).
+  vector<UChar_t> m_flags;
+
+  /// @brief The number of clusters started in the frame.
+  Int_t m_nClusters;
+
+  /// @brief The number of pixels outside of the frame.
+  Int_t m_nOutside;
+
+  /// @brief The number of pixels given more than once.
+  Int_t m_nDuplicates;
+
+  // The results for the last frame checked.
+  Int_t m_lastClusters;
+  Int_t m_lastPixels;
+  Int_t m_lastGroups;
+  Int_t m_lastOutside;
+  Int_t m_lastDuplicates;
+  Int_t m_lastSplit;
+  Int_t m_lastTouching;
+
+};//end of ClusterValidator class definition.
+
+#endif
@@ -0,0 +1,121 @@
+/// @file ColumnarFile.h
+/// @brief Header file for the ColumnarWriter class.
+///
+/// The file layout and the (ROOT-free) reader are in ColumnarReader.h.
+
+#ifndef ColumnarFile_h
+#define ColumnarFile_h 1
+
+// Standard include statements.
+#include <stdio.h>
+#include <iostream>
+#include <vector>
+
+// ROOT include statements.
+#include "TROOT.h"
+#include "TString.h"
+
+// Local include statements.
+#include "Frames.h"
+#include "ColumnarReader.h"
+
+using namespace std;
+
+/// @brief Writes frames to a columnar file.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// The X column goes straight to the file and the C column to a
+/// temporary file. The per-frame columns are held in memory, and
+/// everything is put together when the file is closed.
+class ColumnarWriter {
+
+ public:
+
+  /// @brief Constructor.
+  ///
+  /// @param [in] path The path of the file to create.
+  /// @param [in] dataset The dataset ID.
+  ColumnarWriter(TString path, TString dataset);
+
+  /// @brief Destructor (closes the file if needed).
+  ~ColumnarWriter();
+
+  /// @brief Was the file created?
+  Bool_t IsOpen() const { return m_file != 0; }
+
+  /// @brief Add a frame to the file.
+  ///
+  /// @param [in] frame The frame to write.
+  void fillFrame(FrameStruct & frame);
+
+  /// @brief Write the remaining columns and the directory.
+  ///
+  /// @return Was the file written successfully?
+  Bool_t Close();
+
+  /// @brief Get the number of bytes written so far.
+  Long64_t GetBytesWritten() const { return 2*sizeof(Int_t)*m_nPixels; }
+
+  /// @brief Get the path of the file.
+  TString GetFileName() const { return m_path; }
+
+ private:
+
+  /// @brief Copy constructor (not implemented).
+  ColumnarWriter(const ColumnarWriter &);
+
+  /// @brief Copy assignment operator (not implemented).
+  ColumnarWriter & operator=(const ColumnarWriter &);
+
+  /// @brief Write an array as a column (aligned to 64 bytes).
+  void writeColumn(const char * name, Char_t type, UInt_t elemSize,
+                   void const * data, ULong64_t count);
+
+  /// @brief Pad the file to a 64-byte boundary.
+  void align();
+
+  /// @brief The path of the file.
+  TString m_path;
+
+  /// @brief The dataset ID.
+  TString m_dataset;
+
+  /// @brief The output file.
+  FILE * m_file;
+
+  /// @brief The temporary file for the C column.
+  FILE * m_cfile;
+
+  /// @brief The number of pixels written.
+  ULong64_t m_nPixels;
+
+  /// @brief The column directory.
+  vector<ColumnarEntry> m_dir;
+
+  /// @brief Scratch space for one frame's pixel indices.
+  vector<Int_t> m_X;
+
+  /// @brief Scratch space for one frame's pixel counts.
+  vector<Int_t> m_C;
+
+  // The per-frame columns
+  //-----------------------
+
+  vector<ULong64_t> m_pixelOffset; ///< Index of each frame's first pixel (n+1 entries).
+  vector<Int_t>     m_frameId;     ///< Frame ID.
+  vector<Double_t>  m_startTime;   ///< Start time [s].
+  vector<Double_t>  m_acqTime;     ///< Acquisition time [s].
+  vector<Int_t>     m_width;       ///< Frame width [pixels].
+  vector<Int_t>     m_height;      ///< Frame height [pixels].
+  vector<Double_t>  m_latitude;    ///< Latitude [deg].
+  vector<Double_t>  m_longitude;   ///< Longitude [deg].
+  vector<Double_t>  m_altitude;    ///< Altitude [km].
+  vector<Int_t>     m_totalToT;    ///< Sum of the pixel counts.
+  vector<Int_t>     m_maxToT;      ///< Largest pixel count.
+  vector<Int_t>     m_nClusters;   ///< Number of clusters.
+
+};//end of ColumnarWriter class definition.
+
+#endif
@@ -0,0 +1,194 @@
+/// @file ColumnarReader.h
+/// @brief Header file for the columnar MAFalda file layout and reader.
+///
+/// This header (and src/ColumnarReader.cc) uses plain C++ only, so a
+/// program without ROOT can read the .mpxc files, e.g.
+/// @verbatim
+/// g++ -Iinclude mytool.cpp src/ColumnarReader.cc
+/// @endverbatim
+
+#ifndef ColumnarReader_h
+#define ColumnarReader_h 1
+
+// Standard include statements.
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <map>
+
+/// @brief The columnar file signature.
+static const char kColumnarMagic[9] = "MPXCOLMN";
+
+/// @brief The version of the columnar file layout.
+static const uint32_t kColumnarVersion = 1;
+
+/// @brief The header at the start of a columnar file.
+///
+/// A columnar (.mpxc) file is laid out as:
+/// * this header (64 bytes);
+/// * the column arrays, each starting on a 64-byte boundary;
+/// * the column directory (nColumns ColumnarEntry records).
+///
+/// Everything is little-endian and only fixed-size types are used,
+/// so the file can be read without ROOT.
+struct ColumnarHeader {
+
+  /// @brief The file signature ("MPXCOLMN").
+  char magic[8];
+
+  /// @brief The version of the layout.
+  uint32_t version;
+
+  /// @brief Written as 0x01020304 to check the byte order.
+  uint32_t byteOrder;
+
+  /// @brief The number of frames.
+  uint64_t nFrames;
+
+  /// @brief The total number of pixels.
+  uint64_t nPixels;
+
+  /// @brief The offset of the column directory [bytes].
+  uint64_t dirOffset;
+
+  /// @brief The number of columns in the directory.
+  uint32_t nColumns;
+
+  /// @brief Unused (zero).
+  char reserved[20];
+
+};
+
+/// @brief A column directory record.
+struct ColumnarEntry {
+
+  /// @brief The column name (e.g. "pixel.X"), zero padded.
+  char name[32];
+
+  /// @brief The element type: 'i' (int32_t), 'l' (uint64_t), 'd' (double) or 'c' (char).
+  char type;
+
+  /// @brief Unused (zero).
+  char reserved[3];
+
+  /// @brief The size of an element [bytes].
+  uint32_t elemSize;
+
+  /// @brief The offset of the array [bytes].
+  uint64_t offset;
+
+  /// @brief The number of elements.
+  uint64_t count;
+
+};
+
+/// @brief The pixels of one frame in a mapped columnar file.
+struct PixelSpan {
+
+  /// @brief The pixel indices (X = y*width + x).
+  int32_t const * X;
+
+  /// @brief The pixel counts (C).
+  int32_t const * C;
+
+  /// @brief The number of pixels.
+  int64_t n;
+
+};
+
+/// @brief Reads a columnar file by mapping it into memory.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// Nothing is copied: the accessors point straight into the mapping,
+/// which stays valid for the lifetime of the reader.
+class ColumnarReader {
+
+ public:
+
+  /// @brief Constructor (maps the file).
+  ///
+  /// @param [in] path The path of the file.
+  ColumnarReader(std::string const & path);
+
+  /// @brief Destructor (unmaps the file).
+  ~ColumnarReader();
+
+  /// @brief Was the file mapped and recognised?
+  bool IsOpen() const { return m_header != 0; }
+
+  /// @brief Get the number of frames.
+  int64_t GetNFrames() const { return m_header ? (int64_t)m_header->nFrames : 0; }
+
+  /// @brief Get the total number of pixels.
+  int64_t GetNPixels() const { return m_header ? (int64_t)m_header->nPixels : 0; }
+
+  /// @brief Get the dataset ID.
+  std::string GetDataSet() const;
+
+  /// @brief Get the pixels of a frame.
+  ///
+  /// @param [in] i The frame index.
+  /// @return Pointers to the frame's pixel X and C arrays.
+  PixelSpan GetPixels(int64_t i) const;
+
+  /// @brief Get a column by name.
+  ///
+  /// @param [in] name The column name (e.g. "frame.startTime").
+  /// @param [in] type The expected element type (see ColumnarEntry).
+  /// @param [out] count The number of elements.
+  /// @return The array, or 0 if there is no such column of that type.
+  void const * GetColumn(std::string const & name, char type, int64_t & count) const;
+
+  // Per-frame values
+  //------------------
+
+  int32_t GetFrameId(int64_t i)   const { return m_frameId[i];   } ///< Frame ID.
+  double  GetStartTime(int64_t i) const { return m_startTime[i]; } ///< Start time [s].
+  double  GetAcqTime(int64_t i)   const { return m_acqTime[i];   } ///< Acquisition time [s].
+  int32_t GetWidth(int64_t i)     const { return m_width[i];     } ///< Frame width.
+  int32_t GetHeight(int64_t i)    const { return m_height[i];    } ///< Frame height.
+  int32_t GetTotalToT(int64_t i)  const { return m_totalToT[i];  } ///< Sum of the counts.
+  int32_t GetNClusters(int64_t i) const { return m_nClusters[i]; } ///< Number of clusters.
+
+ private:
+
+  /// @brief Copy constructor (not implemented).
+  ColumnarReader(const ColumnarReader &);
+
+  /// @brief Copy assignment operator (not implemented).
+  ColumnarReader & operator=(const ColumnarReader &);
+
+  /// @brief Get the size of an element of a type (0 for an unknown type).
+  static uint32_t elementSize(char type);
+
+  /// @brief Get a required column of nFrames (+extra) elements.
+  void const * frameColumn(const char * name, char type, int64_t extra = 0);
+
+  /// @brief Unmap the file (after a failed check).
+  void unmap();
+
+  /// @brief The size of the mapping [bytes].
+  size_t m_size;
+
+  /// @brief The mapped file (0 if not open).
+  ColumnarHeader const * m_header;
+
+  /// @brief The columns, by name.
+  std::map<std::string, ColumnarEntry const *> m_columns;
+
+  uint64_t const * m_pixelOffset; ///< Index of each frame's first pixel.
+  int32_t const *  m_pixelX;      ///< The pixel X column.
+  int32_t const *  m_pixelC;      ///< The pixel C column.
+  int32_t const *  m_frameId;     ///< The frame ID column.
+  double const *   m_startTime;   ///< The start time column.
+  double const *   m_acqTime;     ///< The acquisition time column.
+  int32_t const *  m_width;       ///< The frame width column.
+  int32_t const *  m_height;      ///< The frame height column.
+  int32_t const *  m_totalToT;    ///< The total counts column.
+  int32_t const *  m_nClusters;   ///< The number of clusters column.
+
+};//end of ColumnarReader class definition.
+
+#endif
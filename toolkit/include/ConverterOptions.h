@@ -0,0 +1,182 @@
+/// @file ConverterOptions.h
+/// @brief Header file for the ConverterOptions class.
+
+#ifndef ConverterOptions_h
+#define ConverterOptions_h 1
+
+// Standard include statements.
+#include <iostream>
+#include <vector>
+
+// ROOT include statements.
+#include "TROOT.h"
+#include "TString.h"
+
+class TTree;
+
+using namespace std;
+
+/// @brief Optional settings shared by the converters.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// The executables take these as "--name=value" flags, which may be
+/// given anywhere among the usual positional arguments. The defaults
+/// reproduce the behaviour of the converters without any flags.
+class ConverterOptions {
+
+ public:
+
+  /// @brief Constructor (the default settings).
+  ConverterOptions();
+
+  /// @brief Extract the "--name=value" flags from the arguments.
+  ///
+  /// @param [in,out] argc The number of arguments.
+  /// @param [in,out] argv The arguments (the flags are removed).
+  /// @return Were all of the flags recognised?
+  Bool_t Parse(int & argc, char ** argv);
+
+  /// @brief Print the available flags.
+  static void PrintUsage();
+
+  /// @brief Get the ROOT compression settings for the output files.
+  ///
+  /// @return 100*algorithm + level, or -1 for ROOT's default.
+  Int_t GetCompressionSettings() const;
+
+  /// @brief Apply the AutoFlush and AutoSave settings to a TTree.
+  ///
+  /// @param [in] tree The output TTree.
+  void ConfigureTree(TTree * tree) const;
+
+  // Live frame publishing
+  //-----------------------
+
+  /// @brief Name of the shared-memory frame ring ("" for none).
+  TString shmRing;
+
+  /// @brief The number of frame slots in the ring.
+  Int_t shmRingSlots;
+
+  /// @brief The maximum number of pixels stored per frame in the ring.
+  Int_t shmRingMaxPixels;
+
+  // Input reading
+  //---------------
+
+  /// @brief The number of threads parsing the input (0: read it line
+  /// by line on the main thread). Used by Cl2Mf-converter.
+  Int_t readThreads;
+
+  /// @brief The size of the input mapped at once by the parsing
+  /// threads [MB].
+  Int_t readWindowMB;
+
+  // Validation
+  //------------
+
+  /// @brief Re-cluster every Nth frame with the BlobFinder and compare
+  /// it with the clusters in the file (0: never). Used by Cl2Mf-converter.
+  Int_t blobFinderEvery;
+
+  // Clustering
+  //------------
+
+  /// @brief The number of threads clustering the frames (0: one per
+  /// core). Used by Mf-cluster.
+  Int_t clusterThreads;
+
+  /// @brief The number of frames held by the clustering threads at once.
+  Int_t clusterBuffers;
+
+  /// @brief Cluster and classify each frame written, to the file
+  /// DATASET_NNNNNNNNNN.clusters.root beside each output file (see
+  /// ClusterTreeWriter). Used by the converters.
+  Bool_t classify;
+
+  /// @brief The table of cuts classifying the clusters ("" for the
+  /// classes of rate-plotter.py; see ClusterClassifier). Implies
+  /// classify.
+  TString cutTable;
+
+  // Frame selection
+  //-----------------
+
+  /// @brief A cut, lo <= value <= hi, on a quantity of the zone map.
+  struct ZoneCut {
+    Int_t    q;  ///< The quantity (see ZoneMap::Quantity).
+    Double_t lo; ///< The lower limit.
+    Double_t hi; ///< The upper limit.
+  };
+
+  /// @brief The cuts on the frames read from MAFalda files, which skip
+  /// the entry clusters that can't pass them (see MfReader::AddZoneCut).
+  /// Used by Mf-cluster.
+  vector<ZoneCut> zoneCuts;
+
+  // Ntuple writing
+  //----------------
+
+  /// @brief Fill and write the ntuple on a separate thread?
+  Bool_t asyncWrite;
+
+  /// @brief The number of frame buffers for the asynchronous writer.
+  Int_t writeBuffers;
+
+  /// @brief The number of threads filling and compressing the ntuple
+  /// in parallel (0: a single writer).
+  Int_t writeThreads;
+
+  // Output compression and buffering
+  //----------------------------------
+
+  /// @brief The compression codec ("" for ROOT's default, "none",
+  /// "zlib", "lzma", "lz4" or "zstd").
+  TString compression;
+
+  /// @brief The compression level of the chosen codec (1-9; -1 for the
+  /// codec's default).
+  Int_t compressionLevel;
+
+  /// @brief The basket size of the FramesData branch [bytes].
+  Int_t basketSize;
+
+  /// @brief TTree::SetAutoFlush: entries if > 0, bytes if < 0, 0 for off
+  /// (with writeThreads, the frames in each thread's block if > 0).
+  Long64_t autoFlush;
+
+  /// @brief TTree::SetAutoSave: entries if > 0, bytes if < 0, 0 for off
+  /// (not used with writeThreads).
+  Long64_t autoSave;
+
+  // Output files
+  //--------------
+
+  /// @brief Start a new output file once this many MB (compressed)
+  /// have been written (0: no limit).
+  Int_t fileSizeMB;
+
+  /// @brief The number of output files written at once, each on its
+  /// own thread (0: one at a time). The frames go to the files by
+  /// count, so this can't be used with fileSizeMB.
+  Int_t shardWriters;
+
+  /// @brief The output format: "root" (the default), "columnar" (the
+  /// mmap-able .mpxc files, see ColumnarReader.h), "both", or "rntuple"
+  /// (ROOT files holding an RNTuple instead of MPXTree, see RNTupleIO.h).
+  TString outputFormat;
+
+  /// @brief Are ROOT files (with MPXTree) written?
+  Bool_t WritesRoot() const { return outputFormat == "root" || outputFormat == "both"; }
+
+  /// @brief Are ROOT files with an RNTuple written?
+  Bool_t WritesRNTuple() const { return outputFormat == "rntuple"; }
+
+  /// @brief Are columnar files written?
+  Bool_t WritesColumnar() const { return outputFormat == "columnar" || outputFormat == "both"; }
+
+};//end of ConverterOptions class definition.
+
+#endif
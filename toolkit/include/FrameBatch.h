@@ -0,0 +1,207 @@
+/// @file FrameBatch.h
+/// @brief Header file for the FrameBatch class.
+
+#ifndef FrameBatch_h
+#define FrameBatch_h 1
+
+// Standard include statements.
+#include <iostream>
+#include <vector>
+#include <map>
+
+// ROOT include statements.
+#include "TROOT.h"
+#include "TString.h"
+
+// Local include statements.
+#include "Frames.h"
+
+using namespace std;
+
+/// @brief A batch of frames in structure-of-arrays form.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// The hit pixels of every frame in the batch are concatenated into
+/// flat X and C arrays, with frame i occupying the range
+/// [GetFrameBegin(i), GetFrameEnd(i)). The level 1 maps and cluster
+/// IDs are stored the same way. The per-frame quantities used in
+/// selections (ID, times, size and the summary statistics) are held
+/// as columns, while the remaining metadata of each frame is kept
+/// alongside (without its payload) so that GetFrame() gives back the
+/// complete FrameStruct.
+///
+/// MfReader::ReadBatch() fills a batch from a MAFalda file (with any
+/// overlay applied). A ClusterService takes each frame's pixels
+/// straight from the flat arrays (see Mf-cluster), and
+/// OutputManager::fillBatch() writes a whole batch, clustering it with
+/// ClusterProperties::AddBatch() when classifying (see Mf-convert), so
+/// reading, clustering and writing only meet once per batch rather
+/// than once per frame.
+class FrameBatch {
+
+ public:
+
+  /// @brief Constructor.
+  ///
+  /// @param [in] capacity The number of frames the batch holds.
+  FrameBatch(UInt_t capacity = 256);
+
+  /// @brief Destructor.
+  ~FrameBatch() {};
+
+  /// @brief Empty the batch (the allocated memory is kept).
+  void Clear();
+
+  /// @brief Get the number of frames in the batch.
+  inline UInt_t GetNFrames() const { return m_nFrames; }
+
+  /// @brief Get the number of frames the batch can hold.
+  inline UInt_t GetCapacity() const { return m_capacity; }
+
+  /// @brief Is the batch full?
+  inline Bool_t IsFull() const { return m_nFrames >= m_capacity; }
+
+  // Filling the batch
+  //-------------------
+
+  /// @brief Add a frame to the end of the batch.
+  ///
+  /// @param [in] frame The frame to add.
+  /// @param [in] entry The frame's entry in its file (-1 if not known).
+  /// @return Was the frame added (false if the batch is full)?
+  Bool_t AddFrame(FrameStruct & frame, Long64_t entry = -1);
+
+  // Getting the frames back
+  //-------------------------
+
+  /// @brief Copy a frame of the batch into a FrameStruct.
+  ///
+  /// @param [in] i The index of the frame in the batch.
+  /// @param [out] frame The frame to fill (payload and metadata).
+  void GetFrame(UInt_t i, FrameStruct & frame) const;
+
+  // Pixel arrays
+  //--------------
+
+  /// @brief Get the total number of pixels in the batch.
+  inline UInt_t GetNPixels() const { return m_pixelX.size(); }
+
+  /// @brief Get the index of the first pixel of frame i.
+  inline UInt_t GetFrameBegin(UInt_t i) const { return m_offsets[i]; }
+
+  /// @brief Get the index after the last pixel of frame i.
+  inline UInt_t GetFrameEnd(UInt_t i) const { return m_offsets[i+1]; }
+
+  /// @brief Get the pixel X values (frame by frame, sorted in X).
+  inline Int_t const * GetPixelX() const { return m_pixelX.empty() ? 0 : &m_pixelX[0]; }
+
+  /// @brief Get the pixel ToT counts (matching GetPixelX()).
+  inline Int_t const * GetPixelC() const { return m_pixelC.empty() ? 0 : &m_pixelC[0]; }
+
+  /// @brief Were the cluster IDs of frame i's pixels stored with it?
+  inline Bool_t HasClusterIds(UInt_t i) const { return m_idOffsets[i+1] > m_idOffsets[i]; }
+
+  /// @brief Get the cluster IDs of frame i's pixels (matching its
+  /// pixels, 0 if they weren't stored).
+  inline Int_t const * GetClusterIds(UInt_t i) const {
+    return HasClusterIds(i) ? &m_clusterIds[m_idOffsets[i]] : 0;
+  }
+
+  // Per-frame columns
+  //-------------------
+
+  /// @brief Get the entry of each frame in its file (-1 if not known).
+  inline vector<Long64_t> const & GetInputEntries() const { return m_entry; }
+
+  /// @brief Get the frame IDs.
+  inline vector<Long64_t> const & GetFrameIds() const { return m_frameId; }
+
+  /// @brief Get the frame start times [s].
+  inline vector<Double_t> const & GetStartTimes() const { return m_startTime; }
+
+  /// @brief Get the frame acquisition times [s].
+  inline vector<Double_t> const & GetAcqTimes() const { return m_acqTime; }
+
+  /// @brief Get the frame widths [pixels].
+  inline vector<Int_t> const & GetWidths() const { return m_width; }
+
+  /// @brief Get the frame heights [pixels].
+  inline vector<Int_t> const & GetHeights() const { return m_height; }
+
+  /// @brief Get the total ToT counts of each frame.
+  inline vector<Int_t> const & GetTotalToTs() const { return m_totalToT; }
+
+  /// @brief Get the maximum pixel ToT of each frame.
+  inline vector<Int_t> const & GetMaxToTs() const { return m_maxToT; }
+
+  /// @brief Get the number of clusters in each frame (-1 if not known).
+  inline vector<Int_t> const & GetNClusters() const { return m_nClusters; }
+
+ private:
+
+  /// @brief The number of frames the batch holds.
+  UInt_t m_capacity;
+
+  /// @brief The number of frames in the batch.
+  UInt_t m_nFrames;
+
+  /// @brief Offsets of each frame's pixels (m_nFrames + 1 entries).
+  vector<UInt_t> m_offsets;
+
+  /// @brief The pixel X values of all frames.
+  vector<Int_t> m_pixelX;
+
+  /// @brief The pixel ToT counts of all frames.
+  vector<Int_t> m_pixelC;
+
+  /// @brief Offsets of each frame's level 1 entries.
+  vector<UInt_t> m_lvl1Offsets;
+
+  /// @brief The level 1 pixel X values of all frames.
+  vector<Int_t> m_lvl1X;
+
+  /// @brief The level 1 values of all frames.
+  vector<Int_t> m_lvl1V;
+
+  /// @brief Offsets of each frame's cluster IDs (no entries for a frame
+  /// without them).
+  vector<UInt_t> m_idOffsets;
+
+  /// @brief The pixel cluster IDs of all frames.
+  vector<Int_t> m_clusterIds;
+
+  /// @brief The entry of each frame in its file.
+  vector<Long64_t> m_entry;
+
+  /// @brief The frame IDs.
+  vector<Long64_t> m_frameId;
+
+  /// @brief The frame start times [s].
+  vector<Double_t> m_startTime;
+
+  /// @brief The frame acquisition times [s].
+  vector<Double_t> m_acqTime;
+
+  /// @brief The frame widths [pixels].
+  vector<Int_t> m_width;
+
+  /// @brief The frame heights [pixels].
+  vector<Int_t> m_height;
+
+  /// @brief The total ToT counts of each frame.
+  vector<Int_t> m_totalToT;
+
+  /// @brief The maximum pixel ToT of each frame.
+  vector<Int_t> m_maxToT;
+
+  /// @brief The number of clusters in each frame.
+  vector<Int_t> m_nClusters;
+
+  /// @brief The full metadata of each frame (with empty pixel maps).
+  vector<FrameStruct> m_meta;
+
+};//end of FrameBatch class definition.
+
+#endif
@@ -0,0 +1,157 @@
+/// @file FrameIndex.h
+/// @brief Header file for the FrameIndex class.
+
+#ifndef FrameIndex_h
+#define FrameIndex_h 1
+
+// Standard include statements.
+#include <iostream>
+#include <vector>
+
+// ROOT include statements.
+#include "TROOT.h"
+#include "TString.h"
+
+using namespace std;
+
+// Forward declarations.
+class TDirectory;
+class FrameStruct;
+
+/// @brief Sorted start time and frame ID indices of a MAFalda file.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// The writers add each frame as it is written and store the index
+/// in the file when it is closed, as two small TTrees:
+/// * MPXTimeIndex - (startTime, entry), sorted by start time;
+/// * MPXIdIndex - (dataset, frameId, entry), sorted by dataset and ID.
+///
+/// A reader loads the index (a few bytes per frame, without touching
+/// MPXTree) and finds entries by binary search, e.g.
+///
+///     FrameIndex index;
+///     if (index.Read(file)) {
+///       vector<Long64_t> entries;
+///       index.GetTimeWindow(t0, t1, entries);
+///       for (...) tree->GetEntry(entries[i]);
+///     }
+///
+/// The keys are kept sorted as entries are added, read or appended,
+/// so the searches don't change the index and may be called from
+/// several threads at once (as long as none is filling it).
+class FrameIndex {
+
+ public:
+
+  /// @brief Constructor.
+  FrameIndex();
+
+  /// @brief Destructor.
+  ~FrameIndex();
+
+  /// @brief Add the next entry of the tree.
+  ///
+  /// @param [in] frame The frame written as the next entry.
+  void Add(FrameStruct & frame);
+
+  /// @brief Write the index to a directory (file).
+  ///
+  /// @param [in] dir The directory to write to.
+  /// @return Was the index written?
+  Bool_t Write(TDirectory * dir);
+
+  /// @brief Read the index from a directory (file).
+  ///
+  /// @param [in] dir The directory holding the index trees.
+  /// @return Was an index found?
+  Bool_t Read(TDirectory * dir);
+
+  /// @brief Add the entries of another file's index after these ones.
+  ///
+  /// Used when that file's tree is copied to the end of this one.
+  ///
+  /// @param [in] other The index of the copied tree.
+  void Append(FrameIndex const & other);
+
+  /// @brief Forget all of the entries.
+  void Clear();
+
+  /// @brief Get the number of entries indexed.
+  Long64_t GetNEntries() const { return (Long64_t)m_time.size(); }
+
+  /// @brief Find the frame that was running at a given time.
+  ///
+  /// @param [in] t The time [s].
+  /// @return The entry of the last frame started at or before t (-1 if none).
+  Long64_t FindTime(Double_t t) const;
+
+  /// @brief Find the frames started in a time window.
+  ///
+  /// @param [in] t0 The start of the window [s].
+  /// @param [in] t1 The end of the window [s] (not included).
+  /// @param [out] entries The entries, in increasing order.
+  void GetTimeWindow(Double_t t0, Double_t t1, vector<Long64_t> & entries) const;
+
+  /// @brief Find a frame by its ID.
+  ///
+  /// @param [in] frameId The frame ID.
+  /// @param [in] dataset The dataset ID ("" for any dataset).
+  /// @return The entry of the frame (-1 if there is none).
+  Long64_t FindFrame(Int_t frameId, TString dataset = "") const;
+
+  /// @brief Get all of the entries in start time order.
+  ///
+  /// @param [out] entries The entries, sorted by start time (then entry).
+  void GetTimeOrder(vector<Long64_t> & entries) const;
+
+  /// @brief Get the time range of the indexed frames.
+  ///
+  /// @param [out] tmin The earliest start time [s].
+  /// @param [out] tmax The latest start time [s].
+  /// @return Are there any entries?
+  Bool_t GetTimeRange(Double_t & tmin, Double_t & tmax) const;
+
+ private:
+
+  /// @brief An entry of the time index.
+  struct TimeKey {
+    Double_t t;     ///< The frame start time [s].
+    Long64_t entry; ///< The tree entry.
+  };
+
+  /// @brief An entry of the ID index.
+  struct IdKey {
+    Int_t    dataset; ///< The position of the dataset ID in m_datasets.
+    Int_t    id;      ///< The frame ID.
+    Long64_t entry;   ///< The tree entry.
+  };
+
+  /// @brief Order the time keys by start time (then entry).
+  static Bool_t timeLess(TimeKey const & a, TimeKey const & b) { return a.t < b.t; }
+
+  /// @brief Order the ID keys by dataset and frame ID (then entry).
+  static Bool_t idLess(IdKey const & a, IdKey const & b) {
+    if (a.dataset != b.dataset) return a.dataset < b.dataset;
+    return a.id < b.id;
+  }
+
+  /// @brief Sort the keys (if they aren't already).
+  void sort();
+
+  /// @brief Get the position of a dataset ID in m_datasets (-1 if absent).
+  Int_t findDataset(TString const & dataset) const;
+
+  /// @brief The time index (sorted).
+  vector<TimeKey> m_time;
+
+  /// @brief The ID index (sorted).
+  vector<IdKey> m_id;
+
+  /// @brief The dataset IDs, in the order they were seen.
+  vector<TString> m_datasets;
+
+};//end of FrameIndex class definition.
+
+#endif
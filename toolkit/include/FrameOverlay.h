@@ -0,0 +1,176 @@
+/// @file FrameOverlay.h
+/// @brief Header file for the FrameOverlay class.
+
+#ifndef FrameOverlay_h
+#define FrameOverlay_h 1
+
+// Standard include statements.
+#include <iostream>
+#include <vector>
+
+// ROOT include statements.
+#include "TROOT.h"
+#include "TString.h"
+
+using namespace std;
+
+// Forward declarations.
+class TDirectory;
+class TTree;
+class FrameStruct;
+
+/// @brief Metadata that replaces the values stored in MPXTree.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// Rather than rewriting (and recompressing) every frame to change a
+/// few metadata fields, Mf-updater and Mf-filter store the new values
+/// in the file as a small friend tree, MPXOverlay, with one entry per
+/// MPXTree entry and a branch for each field changed. A pixel mask is
+/// stored once, as the MPXOverlayMask tree. MfReader applies the
+/// overlay to each frame as it is read.
+///
+/// Each update rewrites the overlay with the fields already in it plus
+/// the new ones, so the file only ever has the one overlay.
+class FrameOverlay {
+
+ public:
+
+  /// @brief The fields (or groups of fields) an overlay can hold.
+  enum Field {
+    kDataSet     = 1 << 0,  ///< The dataset ID.
+    kMCData      = 1 << 1,  ///< The simulated (Monte Carlo) data flag.
+    kFrameId     = 1 << 2,  ///< The frame ID.
+    kPosition    = 1 << 3,  ///< Latitude, longitude and altitude.
+    kAttitude    = 1 << 4,  ///< Roll, pitch and yaw.
+    kOmega       = 1 << 5,  ///< The angular velocities.
+    kDetPosition = 1 << 6,  ///< The detector position (x, y, z).
+    kEuler       = 1 << 7,  ///< The detector Euler angles.
+    kCustomName  = 1 << 8,  ///< The detector's custom name.
+    kAppFilters  = 1 << 9,  ///< The applied filters.
+    kSourceId    = 1 << 10, ///< The source ID.
+    kLVL1Mask    = 1 << 11  ///< The pixel (level 1) mask.
+  };
+
+  /// @brief Constructor.
+  FrameOverlay();
+
+  /// @brief Destructor.
+  ~FrameOverlay();
+
+  // Reading
+  //---------
+
+  /// @brief Attach to the overlay in a directory (file), if any.
+  ///
+  /// An overlay without one entry per tree entry is rejected, as
+  /// its values would go to the wrong frames.
+  ///
+  /// @param [in] dir The directory holding MPXOverlay.
+  /// @param [in] nentries The number of tree entries.
+  /// @return Was an overlay found (with nentries entries)?
+  Bool_t Read(TDirectory * dir, Long64_t nentries);
+
+  /// @brief Get the fields held (a combination of Field values).
+  UInt_t GetFields() const { return m_fields; }
+
+  /// @brief Load the values of an entry.
+  ///
+  /// @param [in] entry The MPXTree entry.
+  void LoadEntry(Long64_t entry);
+
+  /// @brief Set the overlay's fields of a frame to the values loaded.
+  ///
+  /// @param [in,out] frame The frame read from MPXTree.
+  void Apply(FrameStruct & frame);
+
+  // Writing
+  //---------
+
+  /// @brief Start a new overlay, keeping the fields of any attached one.
+  ///
+  /// For each entry, call LoadEntry, Take the new values and Fill.
+  ///
+  /// @param [in] dir The directory (file) to write to.
+  /// @param [in] fields The fields to be added.
+  void BeginWrite(TDirectory * dir, UInt_t fields);
+
+  /// @brief Copy fields from a frame.
+  ///
+  /// @param [in] frame The frame holding the new values.
+  /// @param [in] fields The fields to copy.
+  void Take(FrameStruct & frame, UInt_t fields);
+
+  /// @brief Set the pixel mask applied to every frame.
+  ///
+  /// @param [in] xs The pixel x coordinates.
+  /// @param [in] ys The pixel y coordinates.
+  /// @param [in] values The mask values.
+  void SetLVL1Mask(vector<Int_t> const & xs,
+                   vector<Int_t> const & ys,
+                   vector<Int_t> const & values);
+
+  /// @brief Add an entry holding the current values.
+  void Fill();
+
+  /// @brief Write the new overlay, replacing any old one.
+  ///
+  /// @return Was the overlay written?
+  Bool_t EndWrite();
+
+ private:
+
+  /// @brief Copy constructor (not implemented).
+  FrameOverlay(const FrameOverlay &);
+
+  /// @brief Copy assignment operator (not implemented).
+  FrameOverlay & operator=(const FrameOverlay &);
+
+  /// @brief Point a tree's branches at the buffers.
+  ///
+  /// @param [in] tree The tree.
+  /// @param [in] create Create the branches (or set their addresses)?
+  void connect(TTree * tree, Bool_t create);
+
+  /// @brief The fields held.
+  UInt_t m_fields;
+
+  /// @brief The overlay being read (0 if none).
+  TTree * m_in;
+
+  /// @brief The overlay being written (0 if none).
+  TTree * m_out;
+
+  /// @brief The directory being written to.
+  TDirectory * m_dir;
+
+  // The values of the current entry
+  //---------------------------------
+
+  Char_t   m_dataSet[256];    ///< Dataset ID.
+  Bool_t   m_mcData;          ///< Simulated data?
+  Int_t    m_frameId;         ///< Frame ID.
+  Double_t m_position[3];     ///< Latitude, longitude and altitude.
+  Double_t m_attitude[3];     ///< Roll, pitch and yaw.
+  Double_t m_omega[3];        ///< Angular velocities.
+  Double_t m_detPosition[3];  ///< Detector position.
+  Double_t m_euler[3];        ///< Euler angles.
+  Char_t   m_customName[256]; ///< Custom name.
+  Char_t   m_appFilters[256]; ///< Applied filters.
+  Char_t   m_sourceId[256];   ///< Source ID.
+
+  // The pixel mask
+  //----------------
+
+  vector<Int_t> m_maskXs;  ///< Mask pixel x coordinates.
+  vector<Int_t> m_maskYs;  ///< Mask pixel y coordinates.
+  vector<Int_t> m_maskVs;  ///< Mask values.
+
+  Int_t m_maskWidth;       ///< The frame width m_maskX was made for.
+  vector<Int_t> m_maskX;   ///< The mask's pixel indices (sorted).
+  vector<Int_t> m_maskV;   ///< The mask's values.
+
+};//end of FrameOverlay class definition.
+
+#endif
@@ -0,0 +1,93 @@
+/// @file FrameQueue.h
+/// @brief Header file for the FrameQueue class.
+
+#ifndef FrameQueue_h
+#define FrameQueue_h 1
+
+// Standard include statements.
+#include <deque>
+#include <set>
+#include <mutex>
+#include <condition_variable>
+
+// ROOT include statements.
+#include "TROOT.h"
+#include "TString.h"
+
+// Local include statements.
+#include "Frames.h"
+
+using namespace std;
+
+/// @brief A bounded queue of reusable frame buffers between two threads.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// The producer takes an empty buffer with GetFree(), fills it and
+/// hands it over with PutFull(); the consumer takes it with GetFull()
+/// and gives it back with PutFree(). No frames are allocated while
+/// running, and since there is a fixed number of buffers the producer
+/// waits in GetFree() whenever the consumer falls behind.
+class FrameQueue {
+
+ public:
+
+  /// @brief Constructor.
+  ///
+  /// @param [in] nbuffers The number of frame buffers to allocate.
+  /// @param [in] datasetid The dataset ID for the new frames.
+  FrameQueue(UInt_t nbuffers, TString datasetid);
+
+  /// @brief Destructor (deletes the buffers allocated by the queue).
+  ~FrameQueue();
+
+  /// @brief Get an empty buffer, waiting for one if necessary.
+  FrameStruct * GetFree();
+
+  /// @brief Return a buffer once it has been used.
+  void PutFree(FrameStruct * frame);
+
+  /// @brief Hand over a filled buffer.
+  void PutFull(FrameStruct * frame);
+
+  /// @brief Get the next filled buffer, waiting for one if necessary.
+  ///
+  /// @return The next filled buffer, or 0 once closed and drained.
+  FrameStruct * GetFull();
+
+  /// @brief Signal that no more filled buffers will be handed over.
+  void Close();
+
+ private:
+
+  /// @brief Copy constructor (not implemented).
+  FrameQueue(const FrameQueue &);
+
+  /// @brief Copy assignment operator (not implemented).
+  FrameQueue & operator=(const FrameQueue &);
+
+  /// @brief The buffers allocated by the queue.
+  set<FrameStruct*> m_owned;
+
+  /// @brief The empty buffers.
+  deque<FrameStruct*> m_free;
+
+  /// @brief The filled buffers, in the order they were handed over.
+  deque<FrameStruct*> m_full;
+
+  /// @brief Has the producer finished?
+  Bool_t m_closed;
+
+  /// @brief Guards the queues.
+  mutable mutex m_mutex;
+
+  /// @brief Signalled when a buffer is freed.
+  condition_variable m_freeCond;
+
+  /// @brief Signalled when a buffer is filled (or the queue closed).
+  condition_variable m_fullCond;
+
+};//end of FrameQueue class definition.
+
+#endif
@@ -0,0 +1,235 @@
+/// @file FrameRing.h
+/// @brief Header file for the shared-memory frame ring classes.
+
+#ifndef FrameRing_h
+#define FrameRing_h 1
+
+// Standard include statements.
+#include <iostream>
+#include <vector>
+
+// ROOT include statements.
+#include "TROOT.h"
+#include "TString.h"
+
+// Local include statements.
+#include "Frames.h"
+
+using namespace std;
+
+/// @brief The header at the start of the shared-memory ring.
+///
+/// The layout is shared between processes, so only fixed-size
+/// types are used.
+struct FrameRingHeader {
+
+  /// @brief Identifies an initialised ring (FrameRingWriter::kMagic).
+  UInt_t magic;
+
+  /// @brief The version of the ring layout.
+  UInt_t version;
+
+  /// @brief The number of frame slots.
+  UInt_t nSlots;
+
+  /// @brief The maximum number of pixels per slot.
+  UInt_t maxPixels;
+
+  /// @brief The size of each slot [bytes].
+  ULong64_t slotSize;
+
+  /// @brief The number of frames published so far.
+  ULong64_t writeSeq;
+
+};
+
+/// @brief The fixed part of a frame slot (the pixels follow it).
+struct FrameRingSlot {
+
+  /// @brief Sequence word: 2n+1 while frame n is written, 2n+2 after.
+  ULong64_t seq;
+
+  /// @brief The frame ID.
+  Long64_t frameId;
+
+  /// @brief The frame start time [s].
+  Double_t startTime;
+
+  /// @brief The acquisition time [s].
+  Double_t acqTime;
+
+  /// @brief The latitude [deg.].
+  Double_t latitude;
+
+  /// @brief The longitude [deg.].
+  Double_t longitude;
+
+  /// @brief The altitude [km].
+  Double_t altitude;
+
+  /// @brief The frame width [pixels].
+  Int_t width;
+
+  /// @brief The frame height [pixels].
+  Int_t height;
+
+  /// @brief The number of pixels stored in the slot.
+  Int_t nPixels;
+
+  /// @brief The number of hit pixels in the frame (may exceed nPixels).
+  Int_t occupancy;
+
+  /// @brief The total ToT counts.
+  Int_t totalToT;
+
+  /// @brief The number of clusters (-1 if not known).
+  Int_t nClusters;
+
+  /// @brief The dataset ID (null terminated).
+  Char_t dataset[64];
+
+};
+
+/// @brief A frame as copied out of the ring by a FrameRingReader.
+struct FrameRingFrame {
+
+  /// @brief The position of the frame in the stream of published frames.
+  ULong64_t seq;
+
+  Long64_t frameId;     ///< The frame ID.
+  Double_t startTime;   ///< The frame start time [s].
+  Double_t acqTime;     ///< The acquisition time [s].
+  Double_t latitude;    ///< The latitude [deg.].
+  Double_t longitude;   ///< The longitude [deg.].
+  Double_t altitude;    ///< The altitude [km].
+  Int_t width;          ///< The frame width [pixels].
+  Int_t height;         ///< The frame height [pixels].
+  Int_t occupancy;      ///< The number of hit pixels in the frame.
+  Int_t totalToT;       ///< The total ToT counts.
+  Int_t nClusters;      ///< The number of clusters (-1 if not known).
+  TString dataset;      ///< The dataset ID.
+
+  /// @brief The pixel X values (sorted; truncated to the ring's limit).
+  vector<Int_t> pixelX;
+
+  /// @brief The pixel ToT counts.
+  vector<Int_t> pixelC;
+
+};
+
+/// @brief Publishes frames to a POSIX shared-memory ring buffer.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// There is one writer (the converter) and any number of readers.
+/// The writer never waits for the readers: each slot carries a
+/// sequence word that is odd while the slot is being written, and a
+/// reader that finds it changed while copying drops that frame. Live
+/// monitors therefore see each frame as soon as it is finalised,
+/// without going through a ROOT file.
+class FrameRingWriter {
+
+ public:
+
+  /// @brief The value of FrameRingHeader::magic for a ready ring.
+  static const UInt_t kMagic = 0x4D505852; // "MPXR"
+
+  /// @brief The version of the ring layout.
+  static const UInt_t kVersion = 1;
+
+  /// @brief Constructor: creates (or replaces) the named ring.
+  ///
+  /// @param [in] name The shared-memory object name (e.g. "/cernatschool").
+  /// @param [in] nSlots The number of frames held in the ring.
+  /// @param [in] maxPixels The maximum number of pixels per frame.
+  FrameRingWriter(TString name, UInt_t nSlots = 64, UInt_t maxPixels = 65536);
+
+  /// @brief Destructor: unmaps and removes the ring.
+  ~FrameRingWriter();
+
+  /// @brief Was the ring created successfully?
+  inline Bool_t IsOpen() const { return m_header != 0; }
+
+  /// @brief Publish a frame to the ring.
+  ///
+  /// @param [in] frame The finalised frame.
+  void Publish(FrameStruct & frame);
+
+ private:
+
+  /// @brief Copy constructor (not implemented).
+  FrameRingWriter(const FrameRingWriter &);
+
+  /// @brief Copy assignment operator (not implemented).
+  FrameRingWriter & operator=(const FrameRingWriter &);
+
+  /// @brief The shared-memory object name.
+  TString m_name;
+
+  /// @brief The size of the mapping [bytes].
+  size_t m_size;
+
+  /// @brief The ring header (start of the mapping).
+  FrameRingHeader * m_header;
+
+};//end of FrameRingWriter class definition.
+
+/// @brief Reads frames from a shared-memory ring buffer.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// Each reader keeps its own position in the stream of frames. A
+/// reader that falls more than a ring's worth of frames behind skips
+/// forward, and the frames it missed are counted in GetNDropped().
+class FrameRingReader {
+
+ public:
+
+  /// @brief Constructor: attaches to the named ring.
+  ///
+  /// @param [in] name The shared-memory object name.
+  /// @param [in] fromStart Start from the oldest frame in the ring
+  ///                       (rather than the next frame published)?
+  FrameRingReader(TString name, Bool_t fromStart = false);
+
+  /// @brief Destructor.
+  ~FrameRingReader();
+
+  /// @brief Is the reader attached to a ring?
+  inline Bool_t IsOpen() const { return m_header != 0; }
+
+  /// @brief Get the next frame.
+  ///
+  /// @param [out] frame The frame copied out of the ring.
+  /// @param [in] timeout_ms How long to wait for a new frame [ms].
+  /// @return Was a frame read?
+  Bool_t Next(FrameRingFrame & frame, Int_t timeout_ms = 0);
+
+  /// @brief Get the number of frames published that were not read.
+  inline ULong64_t GetNDropped() const { return m_nDropped; }
+
+ private:
+
+  /// @brief Copy constructor (not implemented).
+  FrameRingReader(const FrameRingReader &);
+
+  /// @brief Copy assignment operator (not implemented).
+  FrameRingReader & operator=(const FrameRingReader &);
+
+  /// @brief The size of the mapping [bytes].
+  size_t m_size;
+
+  /// @brief The ring header (start of the mapping).
+  FrameRingHeader const * m_header;
+
+  /// @brief The sequence number of the next frame to read.
+  ULong64_t m_cursor;
+
+  /// @brief The number of frames skipped.
+  ULong64_t m_nDropped;
+
+};//end of FrameRingReader class definition.
+
+#endif
@@ -69,6 +69,15 @@ class FrameContainer {
   /// Note that detector effects included at the digitization step.
   std::map<int, double> m_frameXC_E;
 
+  /// @brief Map of pixel X to cluster ID (from 1).
+  ///
+  /// Only filled by converters whose input is already clustered;
+  /// empty otherwise.
+  std::map<int, int> m_clusterIds;
+
+  /// @brief Scratch buffer for the encoded payload (not persisted).
+  vector<UChar_t> m_codecBuffer; //!
+
  public:
 
   /// @brief Constructor.
@@ -118,6 +127,16 @@ class FrameContainer {
   /// @brief Clear the level 1 pixel trigger map.
   inline void ClearLVL1() { m_lvl1.clear(); }
 
+  /// @brief Set the cluster a pixel belongs to.
+  ///
+  /// @param [in] x The pixel x coordinate.
+  /// @param [in] y The pixel y coordinate.
+  /// @param [in] w The width of the frame.
+  /// @param [in] id The cluster ID (from 1).
+  ///
+  /// A pixel given more than once keeps its first cluster.
+  void SetClusterId(Int_t x, Int_t y, Int_t w, Int_t id);
+
   /// @brief Get the pixel level 1 mask.
   ///
   /// @return The level 1 pixel mask.
@@ -133,6 +152,65 @@ class FrameContainer {
   /// @return The map of pixel X to pixel energy E (keV).
   inline map<int,double> const & GetPixelEnergies() { return m_frameXC_E; }
 
+  /// @brief Get the pixel cluster IDs map.
+  ///
+  /// @return The map of pixel X to cluster ID (empty if not known).
+  inline map<int,int> const & GetClusterIds() { return m_clusterIds; }
+
+  /// @brief Is the cluster of every pixel known?
+  inline Bool_t HasClusterIds() {
+    return !m_clusterIds.empty() && m_clusterIds.size() == m_frameXC.size();
+  }
+
+  /// @brief Get the pixels grouped by cluster.
+  ///
+  /// @param [out] offsets The start of each cluster in X, then the
+  /// number of pixels (so cluster i is X[offsets[i]] to X[offsets[i+1]-1]).
+  /// @param [out] X The pixel X values, cluster by cluster in cluster
+  /// ID order (and in X order within each cluster).
+  /// @return The number of clusters (0 if the cluster IDs aren't known).
+  UInt_t GetClusters(vector<Int_t> & offsets, vector<Int_t> & X);
+
+  /// @brief Replace the pixel ToT counts map from arrays.
+  ///
+  /// @param [in] X The pixel X values (sorted in X).
+  /// @param [in] C The pixel ToT counts.
+  /// @param [in] n The number of pixels.
+  ///
+  /// The frame counters are left as they are.
+  void SetPixelCounts(Int_t const * X, Int_t const * C, UInt_t n);
+
+  /// @brief Replace the level 1 pixel map from arrays.
+  ///
+  /// @param [in] X The pixel X values (sorted in X).
+  /// @param [in] lvl1 The level 1 values.
+  /// @param [in] n The number of entries.
+  void SetLVL1Map(Int_t const * X, Int_t const * lvl1, UInt_t n);
+
+  /// @brief Replace the pixel energies map from arrays.
+  ///
+  /// @param [in] X The pixel X values (sorted in X).
+  /// @param [in] E The pixel energies [keV].
+  /// @param [in] n The number of pixels.
+  void SetPixelEnergies(Int_t const * X, Double_t const * E, UInt_t n);
+
+  /// @brief Replace the pixel cluster IDs map from arrays.
+  ///
+  /// @param [in] X The pixel X values (sorted in X).
+  /// @param [in] ids The cluster IDs.
+  /// @param [in] n The number of pixels.
+  void SetClusterIds(Int_t const * X, Int_t const * ids, UInt_t n);
+
+  /// @brief Swap the pixel, level 1 and cluster ID maps with another
+  /// container.
+  ///
+  /// @param [in] other The container to swap the payload with.
+  inline void SwapPayload(FrameContainer & other) {
+    m_frameXC.swap(other.m_frameXC);
+    m_lvl1.swap(other.m_lvl1);
+    m_clusterIds.swap(other.m_clusterIds);
+  }
+
   /// @brief Reset the frame's pixel counters.
   void ResetCountersPad();
 
@@ -145,6 +223,9 @@ class FrameContainer {
   /// @brief Set the frame as real data.
   void SetFrameAsData()   { m_isMCData = false; };
 
+  /// @brief Is the frame a simulated frame?
+  Bool_t IsMCData() { return m_isMCData; };
+
   /// @brief Get the number of hit pixels.
   Int_t GetEntriesPad()  { return m_nEntriesPad; };
 
@@ -155,7 +236,11 @@ class FrameContainer {
   Int_t GetChargeInPad() { return m_nChargeInPad; };
 
   // Class definition macro for the ROOT dictionary.
-  ClassDef(FrameContainer,3)
+  //
+  // From version 4 the pixel maps are written by a custom Streamer
+  // using the PayloadCodec (delta or dense, whichever is smaller).
+  // Version 5 adds the pixel cluster IDs.
+  ClassDef(FrameContainer,5)
 
 };//end of FrameContainer class definition.
 
@@ -249,7 +334,57 @@ class FrameStruct : public FrameContainer {
   /// @brief Get the frame occupancy (percentage).
   ///
   /// @return The frame occupancy (% of pixels hit).
-  Double_t GetOccupancyPc(); 
+  Double_t GetOccupancyPc();
+
+  /// @brief Compute the frame summary statistics from the payload.
+  ///
+  /// A single pass over the pixel map fills the occupancy, the total
+  /// and maximum ToT counts, and the bounding box of the hit pixels.
+  /// Each is stored as its own (light) branch, so frame selections
+  /// can be made without reading the pixel payload.
+  void UpdateFrameStats();
+
+  /// @brief Get the total ToT counts of the hit pixels.
+  ///
+  /// @return The total ToT counts (from the last UpdateFrameStats()).
+  inline Int_t GetTotalToT() { return m_totalToT; }
+
+  /// @brief Get the maximum ToT count recorded by a single pixel.
+  ///
+  /// @return The maximum pixel ToT count.
+  inline Int_t GetMaxToT() { return m_maxToT; }
+
+  /// @brief Get the minimum x of the hit pixels' bounding box.
+  ///
+  /// @return The minimum hit pixel x [pixels] (-1 for an empty frame).
+  inline Int_t GetXMin() { return m_xMin; }
+
+  /// @brief Get the maximum x of the hit pixels' bounding box.
+  ///
+  /// @return The maximum hit pixel x [pixels] (-1 for an empty frame).
+  inline Int_t GetXMax() { return m_xMax; }
+
+  /// @brief Get the minimum y of the hit pixels' bounding box.
+  ///
+  /// @return The minimum hit pixel y [pixels] (-1 for an empty frame).
+  inline Int_t GetYMin() { return m_yMin; }
+
+  /// @brief Get the maximum y of the hit pixels' bounding box.
+  ///
+  /// @return The maximum hit pixel y [pixels] (-1 for an empty frame).
+  inline Int_t GetYMax() { return m_yMax; }
+
+  /// @brief Get the number of clusters in the frame.
+  ///
+  /// @return The number of clusters (-1 if not known).
+  inline Int_t GetNClusters() { return m_nClusters; }
+
+  /// @brief Set the number of clusters in the frame.
+  ///
+  /// @param [in] n The number of clusters in the frame.
+  ///
+  /// Used by converters whose input is already clustered.
+  inline void SetNClusters(Int_t n) { m_nClusters = n; }
 
   /// @brief Calculate the dose and equivalent dose rates.
   ///
@@ -753,6 +888,27 @@ class FrameStruct : public FrameContainer {
   /// @brief The frame occupancy as a percentage of the total pixels.
   Double_t m_occupancyPc;
 
+  /// @brief The total ToT counts of the hit pixels.
+  Int_t m_totalToT;
+
+  /// @brief The maximum ToT count of any one pixel.
+  Int_t m_maxToT;
+
+  /// @brief The minimum x of the hit pixels [pixels].
+  Int_t m_xMin;
+
+  /// @brief The maximum x of the hit pixels [pixels].
+  Int_t m_xMax;
+
+  /// @brief The minimum y of the hit pixels [pixels].
+  Int_t m_yMin;
+
+  /// @brief The maximum y of the hit pixels [pixels].
+  Int_t m_yMax;
+
+  /// @brief The number of clusters in the frame (-1 if not known).
+  Int_t m_nClusters;
+
   /// @brief The dose rate of the frame (uGy/min.).
   Double_t m_DoseRate;
 
@@ -914,13 +1070,14 @@ class FrameStruct : public FrameContainer {
 
 
   // Macro for the ROOT dictionary.
-  ClassDef(FrameStruct,4)
+  ClassDef(FrameStruct,5)
 
 };//end of the FrameStruct class definition.
 
 
-// Forward declaration.
+// Forward declarations.
 class WriteToNtuple;
+class OutputManager;
 
 /// @brief A class for handling frame information.
 ///
@@ -1019,14 +1176,14 @@ class FramesHandler {
   /// @param [in] datafile The path of the payload file.
   /// @param [in] dscfile The path of the DSC file.
   /// @param [in] idxfile The path of the index file.
-  /// @param [out] wte Pointer to the ntuple file container.
+  /// @param [out] wte Pointer to the ntuple output manager.
   /// @param [in] ftype The payload format (type) code.
   /// @return Did the frame processing work?
   Bool_t ProcessMultiframe(
     TString datafile,
     TString dscfile,
     TString idxfile,
-    WriteToNtuple * wte,
+    OutputManager * wte,
     int ftype);
 
   /// @brief Fill a single pixel in the frame container (incl. energy).
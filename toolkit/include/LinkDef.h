@@ -5,4 +5,4 @@
 #pragma link off all functions;
     
 #pragma link C++ class FrameStruct+;
-#pragma link C++ class FrameContainer+;
+#pragma link C++ class FrameContainer-;
@@ -16,6 +16,7 @@
 
 // Local include statements.
 #include "Frames.h"
+#include "MfReader.h"
 #include "Utils.h"
 
 using namespace std;
@@ -27,6 +28,9 @@ using namespace std;
 ///
 /// This class owes a debt to J. Idarraga's Mafalda code:
 /// * [Mafalda](https://twiki.cern.ch/twiki/bin/view/Main/MAFalda).
+///
+/// The mask and filter name are written to the file's FrameOverlay;
+/// the frames themselves aren't read or rewritten.
 class MfFilter {
 
  public:
@@ -62,23 +66,8 @@ class MfFilter {
   /// @brief Closes the current ntuple file.
   void closeNtuple();
 
-  /// @brief Pointer to the current ntuple file.
-  TFile * m_pNt;
-
-  /// @brief Pointer to the TTree.
-  TTree * m_pTr;
-
-  /// @brief Pointer to the new TTree.
-  TTree * m_pTrNew;
-
-  /// @brief Pointer to the current frame container.
-  FrameStruct * m_pFrame; 
-
-  /// @brief Pointer to the TTree frame branch.
-  TBranch * m_pBr;
-
-  /// @brief The current frame number.
-  Long_t m_currentFrameNumber; 
+  /// @brief The reader of the ntuple file (and its overlay).
+  MfReader * m_pReader;
 
 }; //end of MfFilter class definition.
 
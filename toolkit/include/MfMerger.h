@@ -0,0 +1,155 @@
+/// @file MfMerger.h
+/// @brief Header file for the MfMerger class.
+
+#ifndef MfMerger_h
+#define MfMerger_h 1
+
+// Standard include statements.
+#include <iostream>
+#include <vector>
+
+// ROOT include statements.
+#include "TROOT.h"
+#include "TString.h"
+#include "TFile.h"
+#include "TTree.h"
+
+// Local include statements.
+#include "Frames.h"
+#include "ConverterOptions.h"
+
+using namespace std;
+
+// Forward declarations.
+class MfReader;
+class FrameIndex;
+class ZoneMap;
+
+/// @brief Merges MAFalda files into one, optionally in time order.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// The inputs are the pieces written by the converters (rolled over
+/// files, parallel or separate runs). Where a file's frames go to the
+/// output unchanged, its compressed baskets are copied as they are
+/// (TTree::CopyEntries "fast"), and its frame index and zone map are
+/// appended rather than rebuilt. Files with an overlay (see
+/// FrameOverlay) or an RNTuple are read and written frame by frame.
+///
+/// With SetTimeOrder the output is sorted by frame start time. If the
+/// inputs are each sorted and don't overlap in time they are simply
+/// copied in order; otherwise they are k-way merged. The merge holds
+/// one frame and the time order of each input open, so inputs are
+/// merged in groups that fit the memory budget (SetMemoryMB), through
+/// temporary files next to the output, until one group is left.
+///
+/// Copied baskets keep the compression they were written with; the
+/// ConverterOptions compression applies to the frames written again.
+class MfMerger {
+
+ public:
+
+  /// @brief Constructor.
+  ///
+  /// @param [in] outputFile The path of the merged file.
+  /// @param [in] options The output settings.
+  MfMerger(TString outputFile, ConverterOptions const & options);
+
+  /// @brief Destructor.
+  ~MfMerger();
+
+  /// @brief Add an input file.
+  void AddInput(TString path) { m_inputs.push_back(path); }
+
+  /// @brief Sort the frames by start time?
+  void SetTimeOrder(Bool_t on) { m_timeOrder = on; }
+
+  /// @brief Set the memory budget of the time-ordered merge [MB].
+  void SetMemoryMB(Int_t mb) { m_memoryMB = mb; }
+
+  /// @brief Merge the inputs.
+  ///
+  /// @return Was the output file written?
+  Bool_t Merge();
+
+  /// @brief Get the number of frames written.
+  Long64_t GetNFrames() const { return m_nFrames; }
+
+  /// @brief Get the number of frames whose baskets were copied.
+  Long64_t GetNFramesCopied() const { return m_nCopied; }
+
+ private:
+
+  /// @brief What is known about an input before merging.
+  struct Input {
+    TString  path;     ///< The file.
+    Long64_t nentries; ///< The number of frames.
+    Double_t tmin;     ///< The earliest start time [s].
+    Double_t tmax;     ///< The latest start time [s].
+    Bool_t   sorted;   ///< Are the frames in start time order?
+    Bool_t   copyable; ///< Can the baskets be copied?
+    Long64_t bytes;    ///< The memory needed to merge it [bytes].
+  };
+
+  /// @brief Copy constructor (not implemented).
+  MfMerger(const MfMerger &);
+
+  /// @brief Copy assignment operator (not implemented).
+  MfMerger & operator=(const MfMerger &);
+
+  /// @brief Look at an input file.
+  ///
+  /// @param [in,out] input The input (with its path set).
+  /// @return Could the file be read?
+  Bool_t scan(Input & input);
+
+  /// @brief Get (or work out) the start time order of a file's frames.
+  ///
+  /// @param [in] reader The file.
+  /// @param [out] index The file's frame index.
+  /// @param [out] order The entries in start time order.
+  void getTimeOrder(MfReader & reader, FrameIndex & index, vector<Long64_t> & order);
+
+  /// @brief Write the inputs one after the other.
+  Bool_t concatenate(vector<Input> const & inputs, TString path);
+
+  /// @brief Write the frames of the inputs in start time order.
+  Bool_t mergeSorted(vector<Input> const & inputs, TString path);
+
+  /// @brief Create an output file with an empty MPXTree.
+  TFile * createOutput(TString path, TTree *& tree);
+
+  /// @brief Write the tree, index and zone map and close the file.
+  Bool_t closeOutput(TFile * file, TTree * tree, FrameIndex & index, ZoneMap & zones);
+
+  /// @brief The path of the merged file.
+  TString m_output;
+
+  /// @brief The output settings.
+  ConverterOptions m_options;
+
+  /// @brief The input files.
+  vector<TString> m_inputs;
+
+  /// @brief Sort the frames by start time?
+  Bool_t m_timeOrder;
+
+  /// @brief The memory budget of the time-ordered merge [MB].
+  Int_t m_memoryMB;
+
+  /// @brief The frame written (the output branch address).
+  FrameStruct * m_frame;
+
+  /// @brief The frame the branch points to between inputs.
+  FrameStruct * m_ownFrame;
+
+  /// @brief The number of frames written.
+  Long64_t m_nFrames;
+
+  /// @brief The number of frames whose baskets were copied.
+  Long64_t m_nCopied;
+
+};//end of MfMerger class definition.
+
+#endif
@@ -0,0 +1,151 @@
+/// @file MfReader.h
+/// @brief Header file for the MfReader class.
+
+#ifndef MfReader_h
+#define MfReader_h 1
+
+// Standard include statements.
+#include <iostream>
+#include <vector>
+#include <utility>
+
+// ROOT include statements.
+#include "TROOT.h"
+#include "TString.h"
+#include "TFile.h"
+#include "TTree.h"
+
+// Local include statements.
+#include "Frames.h"
+#include "FrameOverlay.h"
+#include "ZoneMap.h"
+
+using namespace std;
+
+// Forward declarations.
+class RNTupleFrameReader;
+class FrameBatch;
+
+/// @brief Reads the frames of a MAFalda file, applying any overlay.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// The metadata written by Mf-updater and Mf-filter (see FrameOverlay)
+/// replace the values stored with each frame, so the frames read are
+/// the same as if MPXTree itself had been rewritten.
+///
+/// Files written with --format=rntuple (an MPXNTuple instead of
+/// MPXTree) are read through an RNTupleFrameReader in the same way.
+///
+/// Cuts on the frame quantities of the zone map (see ZoneMap) make
+/// NextEntry() and ReadBatch() skip the entry clusters that can't pass
+/// them, without reading them, and then the frames that don't pass.
+/// GetFrame() reads any entry asked for.
+class MfReader {
+
+ public:
+
+  /// @brief Constructor (opens the file).
+  ///
+  /// @param [in] path The path of the ROOT file.
+  /// @param [in] mode The mode to open the file in ("READ" or "UPDATE").
+  MfReader(TString path, Option_t * mode = "READ");
+
+  /// @brief Destructor (closes the file).
+  ~MfReader();
+
+  /// @brief Was the file opened and MPXTree (or MPXNTuple) found?
+  Bool_t IsOpen() const { return m_tree != 0 || m_rntuple != 0; }
+
+  /// @brief Is the file an RNTuple one?
+  Bool_t IsRNTuple() const { return m_rntuple != 0; }
+
+  /// @brief Get the number of frames.
+  Long64_t GetEntries() const;
+
+  /// @brief Read a frame.
+  ///
+  /// @param [in] entry The entry to read.
+  /// @return The frame (owned by the reader; 0 on failure).
+  FrameStruct * GetFrame(Long64_t entry);
+
+  /// @brief Read frames passing the zone cuts into a batch until it
+  /// is full.
+  ///
+  /// @param [in,out] entry The entry to read from (then the entry after
+  ///                       the last one read).
+  /// @param [out] batch The batch (emptied first).
+  /// @return The number of frames read (0 at the end or on failure).
+  UInt_t ReadBatch(Long64_t & entry, FrameBatch & batch);
+
+  /// @brief Only read the frames with some values lo <= q <= hi.
+  ///
+  /// @param [in] q The quantity (see ZoneMap::Quantity).
+  /// @param [in] lo The lower limit.
+  /// @param [in] hi The upper limit.
+  void AddZoneCut(Int_t q, Double_t lo, Double_t hi);
+
+  /// @brief Find the next entry that might pass the zone cuts.
+  ///
+  /// @param [in] entry The entry to start from.
+  /// @return The first entry at or after it in a zone that might pass
+  ///         (GetEntries() if there is none).
+  Long64_t NextEntry(Long64_t entry) const;
+
+  /// @brief Get the number of frames the zone map let ReadBatch() skip
+  /// without reading them.
+  Long64_t GetNZoneSkipped() const { return m_nZoneSkipped; }
+
+  /// @brief Only read the frame metadata, not the pixels.
+  ///
+  /// @param [in] on Skip the pixel data?
+  void SetMetadataOnly(Bool_t on);
+
+  /// @brief Get the file.
+  TFile * GetFile() { return m_file; }
+
+  /// @brief Get MPXTree (0 for an RNTuple file).
+  TTree * GetTree() { return m_tree; }
+
+  /// @brief Get the overlay (empty if the file has none).
+  FrameOverlay & GetOverlay() { return m_overlay; }
+
+ private:
+
+  /// @brief Copy constructor (not implemented).
+  MfReader(const MfReader &);
+
+  /// @brief Copy assignment operator (not implemented).
+  MfReader & operator=(const MfReader &);
+
+  /// @brief The file.
+  TFile * m_file;
+
+  /// @brief The frame tree.
+  TTree * m_tree;
+
+  /// @brief The RNTuple reader (0 unless the file holds MPXNTuple).
+  RNTupleFrameReader * m_rntuple;
+
+  /// @brief The frame read.
+  FrameStruct * m_frame;
+
+  /// @brief The file's overlay.
+  FrameOverlay m_overlay;
+
+  /// @brief The file's zone map (with the cuts).
+  ZoneMap m_zones;
+
+  /// @brief Was a zone map found (when the first cut was added)?
+  Bool_t m_hasZones;
+
+  /// @brief The entry ranges that might pass the cuts.
+  vector< pair<Long64_t,Long64_t> > m_ranges;
+
+  /// @brief The number of frames skipped by ReadBatch() without reading.
+  Long64_t m_nZoneSkipped;
+
+};//end of MfReader class definition.
+
+#endif
@@ -29,6 +29,8 @@
 // Local include statements.
 #include "AddMetadata.h"
 #include "Frames.h"
+#include "MfReader.h"
+#include "FrameIndex.h"
 #include "Utils.h"
 //#include "BlobFinder.h"
 
@@ -46,6 +48,11 @@ using namespace rapidjson;
 ///
 /// This class owes a debt to J. Idarraga's Mafalda code:
 /// * [Mafalda](https://twiki.cern.ch/twiki/bin/view/Main/MAFalda).
+///
+/// The new metadata are written to the file's FrameOverlay; only the
+/// frames' metadata are read, and MPXTree isn't rewritten. The frame
+/// index (MPXIdIndex, MPXTimeIndex) and zone map (MPXZoneMap), which
+/// hold some of the metadata changed, are rewritten from the new values.
 class MfUpdater {
 
  public:
@@ -83,22 +90,27 @@ class MfUpdater {
   /// @brief The meta data for the calibration data.
   AddMetadata * m_pAddMetadata; 
 
-  /// @brief Pointer to the current ntuple file.
-  TFile * m_pNt;
-
-  /// @brief Pointer to the TTree.
-  TTree * m_pTr;
-
-  TTree * m_pTrNew;
+  /// @brief The reader of the ntuple file (and its overlay).
+  MfReader * m_pReader;
 
   /// @brief Pointer to the current frame container.
   FrameStruct * m_pFrame; 
 
-  TBranch * m_pBr;
-
   /// @brief The current frame number.
   Long_t m_currentFrameNumber; 
 
+  /// @brief The frame index of the updated frames.
+  FrameIndex m_index;
+
+  /// @brief The updated latitude of each frame [deg].
+  vector<Double_t> m_latitudes;
+
+  /// @brief The updated longitude of each frame [deg].
+  vector<Double_t> m_longitudes;
+
+  /// @brief The updated altitude of each frame [km].
+  vector<Double_t> m_altitudes;
+
 }; //end of MfUpdater class definition.
 
 #endif
@@ -18,6 +18,9 @@
 // Local include statements.
 #include "Utils.h"
 #include "Frames.h"
+#include "FrameRing.h"
+#include "OutputManager.h"
+#include "ConverterOptions.h"
 #include "MoEDALMetadata.h"
 //#include "BlobFinder.h"
 
@@ -45,13 +48,15 @@ class Mo2MfConverter {
   /// @param [in] frames_per_root_file The number of frames per ROOT file.
   /// @param [in] num_frames_to_read The number of frames to read.
   /// @param [in] dbg Run in debug mode.
+  /// @param [in] options The optional converter settings.
   explicit Mo2MfConverter(
     TString datasetpath,
     TString datasetmetadata,
     TString outputdir,
     Int_t   frames_per_root_file,
     Int_t   num_frames_to_read,
-    Bool_t dbg = false
+    Bool_t dbg = false,
+    ConverterOptions const & options = ConverterOptions()
     );
 
   /// @brief Destructor.
@@ -80,13 +85,18 @@ class Mo2MfConverter {
 
 */
 
-  /// @brief Closes the current ntuple file.
+  /// @brief Closes the ntuple files.
   void closeNtuple();
 
  private:
 
   // Private methods
 
+  /// @brief Opens the output ntuple files.
+  ///
+  /// @param [in] frames_per_root_file The number of frames per ROOT file.
+  void openNtuple(Int_t frames_per_root_file);
+
   /// @brief Process the next frame from the cluster log file.
   Bool_t processNextFrame(Bool_t dbg = false);
 
@@ -149,15 +159,18 @@ class Mo2MfConverter {
   /// @brief The current output path.
   TString m_outputPath;
 
-  /// @brief Pointer to the current ntuple file.
-  TFile * m_pNt;
+  /// @brief The output manager writing the ntuple files.
+  OutputManager * m_pOutput;
 
-  /// @brief Pointer to the TTree.
-  TTree * m_pTr;
+  /// @brief The optional converter settings (used for each new file).
+  ConverterOptions m_options;
 
   /// @brief Pointer to the current frame container.
   FrameStruct * m_pFrame; 
 
+  /// @brief The shared-memory ring the frames are published to (if any).
+  FrameRingWriter * m_pRing;
+
   /// @brief The current frame number.
   Long_t m_currentFrameNumber; 
 
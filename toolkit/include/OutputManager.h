@@ -0,0 +1,223 @@
+/// @file OutputManager.h
+/// @brief Header file for the OutputManager class.
+
+#ifndef OutputManager_h
+#define OutputManager_h 1
+
+// Standard include statements.
+#include <vector>
+#include <deque>
+#include <thread>
+
+// ROOT include statements.
+#include "TROOT.h"
+#include "TString.h"
+
+// Local include statements.
+#include "Frames.h"
+#include "ConverterOptions.h"
+
+using namespace std;
+
+// Forward declarations.
+class WriteToNtuple;
+class ColumnarWriter;
+class RNTupleFrameWriter;
+class FrameRingWriter;
+class ClusterFinder;
+class ClusterProperties;
+class ClusterClassifier;
+class ClusterTreeWriter;
+class FrameBatch;
+
+/// @brief Writes a dataset's frames to a sequence of ntuple files.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// The frames go, in order, to the files DATASET_NNNNNNNNNN.root in
+/// the output directory. A new file is started once the current one
+/// holds the maximum number of frames, or once the compressed data
+/// written reaches the fileSizeMB option. Every file but the last,
+/// the first included, holds exactly framesPerFile frames (the
+/// converters used to put one frame fewer in their first file).
+///
+/// By default only one file is filled at a time. When the writers are
+/// threaded (asyncWrite or writeThreads) a full file is finished (its
+/// last baskets compressed and written, and the file closed) on its
+/// own thread while the next one is being filled.
+///
+/// With the shardWriters option set to N, each file is written by a
+/// thread of its own (see Shard), which takes the file's frames, in
+/// order, from a queue. The frames go to the files by count, so up to
+/// N files are compressed and written at once while the next frames
+/// are handed over. The files hold the same frames as they would
+/// without the option (which can't be used with fileSizeMB).
+///
+/// With the outputFormat option set to "columnar" or "both" the frames
+/// (also) go to the columnar files DATASET_NNNNNNNNNN.mpxc, which are
+/// rolled over with the ROOT files. With "rntuple" the ROOT files hold
+/// the frames as an RNTuple (see RNTupleFrameWriter) instead of MPXTree.
+///
+/// With the classify option each frame is also clustered and its
+/// clusters classified, and written to DATASET_NNNNNNNNNN.clusters.root
+/// (see ClusterTreeWriter). The files are rolled over with the others,
+/// and the cluster tree's entries match the frames' entries in the
+/// matching file, so it can be added to MPXTree as a friend.
+///
+/// A whole FrameBatch can be written with fillBatch(): its clusters
+/// are then found in one pass over the batch's pixel arrays (see
+/// ClusterProperties::AddBatch) before its frames are written.
+class OutputManager {
+
+ public:
+
+  /// @brief Constructor.
+  ///
+  /// @param [in] dataSet The dataset ID.
+  /// @param [in] outputDir The output directory ("" for here).
+  /// @param [in] options The converter settings.
+  /// @param [in] firstFileNum The number of the first file.
+  /// @param [in] framesPerFile The maximum frames per file (0: no limit).
+  OutputManager(TString dataSet,
+                TString outputDir,
+                ConverterOptions const & options,
+                Int_t firstFileNum = 1,
+                Long64_t framesPerFile = 0);
+
+  /// @brief Destructor (closes the files).
+  ~OutputManager();
+
+  /// @brief Write a frame (see WriteToNtuple::fillFrame).
+  ///
+  /// @param [in,out] frame The frame to write.
+  void fillFrame(FrameStruct & frame);
+
+  /// @brief Write every frame of a batch, in batch order.
+  ///
+  /// @param [in] batch The frames to write.
+  void fillBatch(FrameBatch const & batch);
+
+  /// @brief Write the FramesHandler's frame and rewind it.
+  ///
+  /// @param [in] frameHandlerObj Pointer to the frame data's container.
+  /// @param [in] rewind_metadata Reset the frame data and metadata?
+  void fillVars(FramesHandler * frameHandlerObj, bool rewind_metadata = true);
+
+  /// @brief Close the current file and wait for all files to finish.
+  void Close();
+
+  /// @brief Publish each frame written to a shared-memory ring.
+  ///
+  /// @param [in] ring The ring to publish to (not owned; 0 for none).
+  void SetFrameRing(FrameRingWriter * ring);
+
+  /// @brief Get the name of the file currently being filled (the
+  /// ROOT file, or the columnar file if only that is written).
+  TString GetCurrentFileName() const;
+
+  /// @brief Get the names of all of the files started so far.
+  vector<TString> const & GetFileNames() const { return m_fileNames; }
+
+ private:
+
+  /// @brief Copy constructor (not implemented).
+  OutputManager(const OutputManager &);
+
+  /// @brief Copy assignment operator (not implemented).
+  OutputManager & operator=(const OutputManager &);
+
+  /// @brief A file written on its own thread (with shardWriters).
+  class Shard;
+
+  /// @brief Start the next file if the current one is full.
+  void rollOver();
+
+  /// @brief Write a frame to the current file (after its clusters).
+  ///
+  /// @param [in,out] frame The frame to write.
+  void writeFrame(FrameStruct & frame);
+
+  /// @brief Start the next file.
+  void openFile();
+
+  /// @brief Finish the current file.
+  void closeFile();
+
+  /// @brief Cluster and classify a frame, and write it to the cluster file.
+  ///
+  /// @param [in] frame The frame.
+  void classifyFrame(FrameStruct & frame);
+
+  /// @brief The dataset ID.
+  TString m_dataSet;
+
+  /// @brief The output directory.
+  TString m_outputDir;
+
+  /// @brief The converter settings.
+  ConverterOptions m_options;
+
+  /// @brief The maximum frames per file (0: no limit).
+  Long64_t m_framesPerFile;
+
+  /// @brief The maximum compressed bytes per file (0: no limit).
+  Long64_t m_bytesPerFile;
+
+  /// @brief Finish full files on their own threads?
+  Bool_t m_closeInBackground;
+
+  /// @brief Write each file on its own thread (see Shard)?
+  Bool_t m_sharded;
+
+  /// @brief The number of the current file.
+  Int_t m_fileNum;
+
+  /// @brief The frames written to the current file.
+  Long64_t m_framesInFile;
+
+  /// @brief The total number of frames written.
+  Long64_t m_framesWritten;
+
+  /// @brief Is a file open?
+  Bool_t m_open;
+
+  /// @brief The writer for the current file (0 if none).
+  WriteToNtuple * m_writer;
+
+  /// @brief The columnar writer for the current file (0 if none).
+  ColumnarWriter * m_columnar;
+
+  /// @brief The RNTuple writer for the current file (0 if none).
+  RNTupleFrameWriter * m_rntuple;
+
+  /// @brief The shared-memory ring (if any).
+  FrameRingWriter * m_ring;
+
+  /// @brief The cluster classifier (0 if not classifying).
+  ClusterClassifier * m_classifier;
+
+  /// @brief The cluster finder for the current frame size (0 if none yet).
+  ClusterFinder * m_finder;
+
+  /// @brief The properties of the current frame's clusters.
+  ClusterProperties * m_properties;
+
+  /// @brief The frame of a batch being written.
+  FrameStruct m_batchFrame;
+
+  /// @brief The cluster file writer for the current file (0 if none).
+  ClusterTreeWriter * m_clusters;
+
+  /// @brief The names of the files started so far.
+  vector<TString> m_fileNames;
+
+  /// @brief The threads finishing the full files.
+  vector<thread> m_closers;
+
+  /// @brief The files being written on their own threads, oldest first.
+  deque<Shard*> m_shards;
+
+};//end of OutputManager class definition.
+
+#endif
@@ -0,0 +1,564 @@
+/// @file PayloadCodec.h
+/// @brief Header file for the frame payload codec.
+
+#ifndef PayloadCodec_h
+#define PayloadCodec_h 1
+
+// Standard include statements.
+#include <iostream>
+#include <map>
+#include <vector>
+
+// ROOT include statements.
+#include "TROOT.h"
+#include "TBuffer.h"
+
+using namespace std;
+
+/// @brief Encodes and decodes the pixel payload of a frame.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// Each pixel map (X -> C) is written in whichever of two
+/// representations is smaller for that particular frame:
+/// * delta: the first hit pixel X, then the gap to each following hit
+///   pixel as a varint (one byte for gaps below 128, so tracks of
+///   adjacent pixels cost one byte per pixel);
+/// * dense: a bitmap of the hit pixels.
+/// In both cases the values then follow in X order, bit-packed at the
+/// width of the largest value in the frame (e.g. 9 bits for ToT < 512).
+///
+/// Background frames with a handful of hits are stored as short delta
+/// lists, while saturated beam frames pay one bit per pixel rather
+/// than an index for every hit. Both decode straight back into the
+/// std::map used by FrameContainer, so readers see the same pixel API.
+///
+/// The cluster of each pixel (when the input was already clustered)
+/// is written after the maps as the cluster IDs alone, bit-packed in
+/// the X order of the pixel map, so the pixel X values aren't repeated.
+class PayloadCodec {
+
+ public:
+
+  /// @brief The payload encodings (first byte of an encoded payload).
+  enum PayloadEncoding {
+    kDeltaVarint  = 3, ///< Varint X deltas followed by bit-packed values.
+    kDensePacked  = 4  ///< Bitmap followed by bit-packed values.
+  };
+
+  /// @brief Encode a pixel map, choosing the smaller representation.
+  ///
+  /// @param [in] pixels The map of pixel X to value.
+  /// @param [out] out The encoded payload (replaces any contents).
+  static void Encode(map<int,int> const & pixels, vector<UChar_t> & out);
+
+  /// @brief Decode an encoded payload into a pixel map.
+  ///
+  /// @param [in] data Pointer to the encoded payload.
+  /// @param [in] size The size of the encoded payload [bytes].
+  /// @param [out] pixels The decoded pixel map (replaces any contents).
+  /// @return Was the payload decoded successfully?
+  static Bool_t Decode(UChar_t const * data, UInt_t size,
+                       map<int,int> & pixels);
+
+  /// @brief Encode the cluster IDs of a frame's pixels.
+  ///
+  /// @param [in] pixels The map of pixel X to ToT counts.
+  /// @param [in] ids The map of pixel X to cluster ID.
+  /// @param [out] out The encoded IDs (replaces any contents).
+  ///
+  /// Nothing but an empty marker is written unless there is an ID
+  /// for every pixel (and no others).
+  static void EncodeClusterIds(map<int,int> const & pixels,
+                               map<int,int> const & ids,
+                               vector<UChar_t> & out);
+
+  /// @brief Decode the cluster IDs of a frame's pixels.
+  ///
+  /// @param [in] data Pointer to the encoded IDs.
+  /// @param [in] size The size of the encoded IDs [bytes].
+  /// @param [in] pixels The frame's (decoded) pixel map.
+  /// @param [out] ids The map of pixel X to cluster ID (replaces any contents).
+  /// @return Were the IDs decoded successfully?
+  static Bool_t DecodeClusterIds(UChar_t const * data, UInt_t size,
+                                 map<int,int> const & pixels,
+                                 map<int,int> & ids);
+
+  /// @brief Write a pixel map to a ROOT buffer.
+  ///
+  /// @param [in] b The ROOT buffer to write to.
+  /// @param [in] pixels The map of pixel X to value.
+  /// @param [in] scratch Reusable buffer for the encoded payload.
+  static void WritePixelMap(TBuffer & b, map<int,int> const & pixels,
+                            vector<UChar_t> & scratch);
+
+  /// @brief Read a pixel map from a ROOT buffer.
+  ///
+  /// @param [in] b The ROOT buffer to read from.
+  /// @param [out] pixels The decoded pixel map.
+  /// @param [in] scratch Reusable buffer for the encoded payload.
+  static void ReadPixelMap(TBuffer & b, map<int,int> & pixels,
+                           vector<UChar_t> & scratch);
+
+  /// @brief Write the cluster IDs of a frame's pixels to a ROOT buffer.
+  ///
+  /// @param [in] b The ROOT buffer to write to.
+  /// @param [in] pixels The map of pixel X to ToT counts.
+  /// @param [in] ids The map of pixel X to cluster ID.
+  /// @param [in] scratch Reusable buffer for the encoded IDs.
+  static void WriteClusterIds(TBuffer & b, map<int,int> const & pixels,
+                              map<int,int> const & ids,
+                              vector<UChar_t> & scratch);
+
+  /// @brief Read the cluster IDs of a frame's pixels from a ROOT buffer.
+  ///
+  /// @param [in] b The ROOT buffer to read from.
+  /// @param [in] pixels The frame's (decoded) pixel map.
+  /// @param [out] ids The map of pixel X to cluster ID.
+  /// @param [in] scratch Reusable buffer for the encoded IDs.
+  static void ReadClusterIds(TBuffer & b, map<int,int> const & pixels,
+                             map<int,int> & ids,
+                             vector<UChar_t> & scratch);
+
+  /// @brief Write a pixel energy map to a ROOT buffer.
+  ///
+  /// @param [in] b The ROOT buffer to write to.
+  /// @param [in] energies The map of pixel X to energy [keV].
+  static void WriteEnergyMap(TBuffer & b, map<int,double> const & energies);
+
+  /// @brief Read a pixel energy map from a ROOT buffer.
+  ///
+  /// @param [in] b The ROOT buffer to read from.
+  /// @param [out] energies The map of pixel X to energy [keV].
+  static void ReadEnergyMap(TBuffer & b, map<int,double> & energies);
+
+};//end of PayloadCodec class definition.
+
+// The codec is implemented here, inline, so that the ROOT macros
+// (toolkit-python/Frame.C) can read the payload by including this
+// header alone, without compiling or loading the toolkit library.
+
+/// @brief Helpers for the PayloadCodec methods.
+namespace PayloadCodecDetail {
+
+  /// @brief Map a signed value onto an unsigned one (0,-1,1,-2,... ->
+  /// 0,1,2,3,...) so that small magnitudes stay small.
+  inline UInt_t zigzag(Int_t v) { return ((UInt_t)v << 1) ^ (UInt_t)(v >> 31); }
+
+  /// @brief Inverse of zigzag().
+  inline Int_t unzigzag(UInt_t u) { return (Int_t)(u >> 1) ^ -(Int_t)(u & 1); }
+
+  /// @brief The number of bytes a varint takes.
+  inline Int_t varintSize(UInt_t v) {
+    Int_t n = 1;
+    while (v >= 0x80) { v >>= 7; ++n; }
+    return n;
+  }
+
+  /// @brief Append a varint (7 bits per byte, high bit = more to come).
+  inline void putVarint(vector<UChar_t> & out, UInt_t v) {
+    while (v >= 0x80) { out.push_back((UChar_t)(v | 0x80)); v >>= 7; }
+    out.push_back((UChar_t)v);
+  }
+
+  /// @brief Read a varint, advancing p (false if it runs past end).
+  inline Bool_t getVarint(UChar_t const * & p, UChar_t const * end, UInt_t & v) {
+    v = 0;
+    for (Int_t shift = 0; shift < 35; shift += 7) {
+      if (p == end) return false;
+      UChar_t byte = *p++;
+      v |= (UInt_t)(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) return true;
+    }
+    return false;
+  }
+
+  /// @brief The number of bits needed to store v.
+  inline Int_t bitWidth(UInt_t v) {
+    Int_t n = 0;
+    while (v) { v >>= 1; ++n; }
+    return n;
+  }
+
+  /// @brief Writes fixed-width values packed end to end.
+  class BitWriter {
+   public:
+    BitWriter(vector<UChar_t> & out, Int_t bits)
+      : m_out(out), m_bits(bits), m_acc(0), m_n(0) {}
+    inline void Put(UInt_t v) {
+      m_acc |= (ULong64_t)v << m_n;
+      m_n += m_bits;
+      while (m_n >= 8) { m_out.push_back((UChar_t)m_acc); m_acc >>= 8; m_n -= 8; }
+    }
+    inline void Flush() { if (m_n > 0) m_out.push_back((UChar_t)m_acc); m_acc = 0; m_n = 0; }
+   private:
+    vector<UChar_t> & m_out;
+    Int_t m_bits;
+    ULong64_t m_acc;
+    Int_t m_n;
+  };
+
+  /// @brief Reads fixed-width values packed end to end.
+  class BitReader {
+   public:
+    BitReader(UChar_t const * p, UChar_t const * end, Int_t bits)
+      : m_p(p), m_end(end), m_bits(bits),
+        m_mask(bits == 32 ? 0xFFFFFFFFu : ((1u << bits) - 1)), m_acc(0), m_n(0) {}
+    inline UInt_t Get() {
+      while (m_n < m_bits) {
+        // Missing bytes read as zero; the caller checks the length.
+        ULong64_t byte = (m_p < m_end) ? *m_p : 0;
+        ++m_p;
+        m_acc |= byte << m_n;
+        m_n += 8;
+      }
+      UInt_t v = (UInt_t)m_acc & m_mask;
+      m_acc >>= m_bits;
+      m_n -= m_bits;
+      return v;
+    }
+   private:
+    UChar_t const * m_p;
+    UChar_t const * m_end;
+    Int_t m_bits;
+    UInt_t m_mask;
+    ULong64_t m_acc;
+    Int_t m_n;
+  };
+
+  /// @brief The number of bytes taken by n packed values of the given width.
+  inline ULong64_t packedSize(UInt_t n, Int_t bits) {
+    return ((ULong64_t)n*bits + 7)/8;
+  }
+
+}//end of PayloadCodecDetail namespace.
+
+//
+// PayloadCodec::Encode
+//
+inline void PayloadCodec::Encode(map<int,int> const & pixels, vector<UChar_t> & out) {
+
+  using namespace PayloadCodecDetail;
+
+  out.clear();
+
+  UInt_t n = pixels.size();
+
+  // One pass for the value range and the size of the X deltas
+  // (the map is sorted in X, so every delta is at least one).
+  Int_t xmin = 0, xmax = -1;
+  Bool_t negValues = false;
+  UInt_t vmax = 0;
+  ULong64_t deltaBytes = 0;
+  map<int,int>::const_iterator it;
+  if (n > 0) {
+    xmin = pixels.begin()->first;
+    xmax = pixels.rbegin()->first;
+    Int_t prev = xmin;
+    deltaBytes = varintSize(zigzag(xmin));
+    for (it = pixels.begin(); it != pixels.end(); ++it) {
+      if (it != pixels.begin()) {
+        deltaBytes += varintSize((UInt_t)(it->first - prev - 1));
+        prev = it->first;
+      }
+      if (it->second < 0) negValues = true;
+    }
+    for (it = pixels.begin(); it != pixels.end(); ++it) {
+      UInt_t v = negValues ? zigzag(it->second) : (UInt_t)it->second;
+      if (v > vmax) vmax = v;
+    }
+  }
+
+  // The value bit width; the top bit of the width byte flags zigzag.
+  Int_t vbits = bitWidth(vmax);
+  UChar_t vbyte = (UChar_t)(vbits | (negValues ? 0x80 : 0));
+
+  // Encoded sizes [bytes].
+  ULong64_t deltaSize = 1 + varintSize(n) + 1 + deltaBytes + packedSize(n, vbits);
+  ULong64_t denseSize = deltaSize + 1; // Not available by default.
+  UInt_t nbits = xmax + 1;
+  if (n > 0 && xmin >= 0) {
+    denseSize = 1 + varintSize(nbits) + 1 + ((ULong64_t)nbits + 7)/8
+              + packedSize(n, vbits);
+  }
+
+  if (denseSize < deltaSize) {
+
+    // Dense: [enc][nbits][vbits][bitmap][packed values]
+    out.reserve(denseSize);
+    out.push_back((UChar_t)kDensePacked);
+    putVarint(out, nbits);
+    out.push_back(vbyte);
+    size_t bitmap = out.size();
+    out.resize(bitmap + (nbits + 7)/8, 0);
+    for (it = pixels.begin(); it != pixels.end(); ++it) {
+      out[bitmap + (it->first >> 3)] |= (UChar_t)(1 << (it->first & 7));
+    }
+
+  } else {
+
+    // Delta: [enc][n][vbits][X0][X(i) - X(i-1) - 1 ...][packed values]
+    out.reserve(deltaSize);
+    out.push_back((UChar_t)kDeltaVarint);
+    putVarint(out, n);
+    if (n == 0) return;
+    out.push_back(vbyte);
+    Int_t prev = xmin;
+    putVarint(out, zigzag(xmin));
+    for (it = pixels.begin(); it != pixels.end(); ++it) {
+      if (it == pixels.begin()) continue;
+      putVarint(out, (UInt_t)(it->first - prev - 1));
+      prev = it->first;
+    }
+
+  }
+
+  // The values follow in X order in both encodings.
+  if (vbits > 0) {
+    BitWriter w(out, vbits);
+    for (it = pixels.begin(); it != pixels.end(); ++it) {
+      w.Put(negValues ? zigzag(it->second) : (UInt_t)it->second);
+    }
+    w.Flush();
+  }
+
+}//end of PayloadCodec::Encode method.
+
+//
+// PayloadCodec::Decode
+//
+inline Bool_t PayloadCodec::Decode(UChar_t const * data, UInt_t size,
+                                   map<int,int> & pixels) {
+
+  using namespace PayloadCodecDetail;
+
+  pixels.clear();
+
+  if (size == 0) return false;
+
+  UChar_t const * end = data + size;
+
+  if (data[0] == kDeltaVarint) {
+
+    UChar_t const * p = data + 1;
+    UInt_t n, u;
+    if (!getVarint(p, end, n)) return false;
+    if (n == 0) return (p == end);
+    if (p == end) return false;
+    Int_t vbits = *p & 0x3F;
+    Bool_t negValues = (*p & 0x80);
+    ++p;
+    if (vbits > 32) return false;
+
+    // Each X takes at least a byte, so a larger count is corrupt
+    // (and mustn't be allocated).
+    if ((ULong64_t)n > (ULong64_t)(end - p)) return false;
+
+    // The X values come first, then the packed values.
+    vector<Int_t> xs(n);
+    if (!getVarint(p, end, u)) return false;
+    xs[0] = unzigzag(u);
+    for (UInt_t i = 1; i < n; ++i) {
+      if (!getVarint(p, end, u)) return false;
+      xs[i] = xs[i-1] + (Int_t)u + 1;
+    }
+    if ((ULong64_t)(end - p) != packedSize(n, vbits)) return false;
+
+    BitReader r(p, end, vbits);
+    for (UInt_t i = 0; i < n; ++i) {
+      UInt_t v = (vbits > 0) ? r.Get() : 0;
+      // The X values are written in order, so insert at the end.
+      pixels.insert(pixels.end(),
+        make_pair(xs[i], negValues ? unzigzag(v) : (Int_t)v));
+    }
+    return true;
+
+  } else if (data[0] == kDensePacked) {
+
+    UChar_t const * p = data + 1;
+    UInt_t nbits;
+    if (!getVarint(p, end, nbits)) return false;
+    if (p == end) return false;
+    Int_t vbits = *p & 0x3F;
+    Bool_t negValues = (*p & 0x80);
+    ++p;
+    if (vbits > 32) return false;
+    ULong64_t nbytes = ((ULong64_t)nbits + 7)/8;
+    if ((ULong64_t)(end - p) < nbytes) return false;
+
+    UChar_t const * bitmap = p;
+    UChar_t const * vs     = p + nbytes;
+    BitReader r(vs, end, vbits);
+    UInt_t n = 0;
+    for (ULong64_t B = 0; B < nbytes; ++B) {
+      UChar_t byte = bitmap[B];
+      while (byte) {
+        Int_t b = __builtin_ctz(byte);
+        byte &= byte - 1;
+        UInt_t v = (vbits > 0) ? r.Get() : 0;
+        pixels.insert(pixels.end(),
+          make_pair((int)(8*B + b), negValues ? unzigzag(v) : (Int_t)v));
+        ++n;
+      }
+    }
+    return ((ULong64_t)(end - vs) == packedSize(n, vbits));
+
+  }
+
+  cout << "ERROR: unknown payload encoding " << (Int_t)data[0] << endl;
+  return false;
+
+}//end of PayloadCodec::Decode method.
+
+//
+// PayloadCodec::EncodeClusterIds
+//
+inline void PayloadCodec::EncodeClusterIds(map<int,int> const & pixels,
+                                           map<int,int> const & ids,
+                                           vector<UChar_t> & out) {
+
+  using namespace PayloadCodecDetail;
+
+  out.clear();
+
+  // The IDs are only kept if they match the pixels one to one.
+  Bool_t match = (!ids.empty() && ids.size() == pixels.size());
+  UInt_t vmax = 0;
+  map<int,int>::const_iterator it, jt;
+  for (it = pixels.begin(), jt = ids.begin(); match && it != pixels.end(); ++it, ++jt) {
+    if (it->first != jt->first || jt->second < 0) match = false;
+    else if ((UInt_t)jt->second > vmax) vmax = jt->second;
+  }
+
+  // [n][vbits][packed IDs] (n = 0: no IDs)
+  UInt_t n = match ? ids.size() : 0;
+  putVarint(out, n);
+  if (n == 0) return;
+
+  Int_t vbits = bitWidth(vmax);
+  out.push_back((UChar_t)vbits);
+  if (vbits == 0) return;
+
+  out.reserve(out.size() + packedSize(n, vbits));
+  BitWriter w(out, vbits);
+  for (jt = ids.begin(); jt != ids.end(); ++jt) w.Put((UInt_t)jt->second);
+  w.Flush();
+
+}//end of PayloadCodec::EncodeClusterIds method.
+
+//
+// PayloadCodec::DecodeClusterIds
+//
+inline Bool_t PayloadCodec::DecodeClusterIds(UChar_t const * data, UInt_t size,
+                                             map<int,int> const & pixels,
+                                             map<int,int> & ids) {
+
+  using namespace PayloadCodecDetail;
+
+  ids.clear();
+
+  if (size == 0) return false;
+
+  UChar_t const * p   = data;
+  UChar_t const * end = data + size;
+  UInt_t n;
+  if (!getVarint(p, end, n)) return false;
+  if (n == 0) return (p == end);
+  if (n != pixels.size() || p == end) return false;
+  Int_t vbits = *p++;
+  if (vbits > 32) return false;
+  if ((ULong64_t)(end - p) != packedSize(n, vbits)) return false;
+
+  BitReader r(p, end, vbits);
+  map<int,int>::const_iterator it;
+  for (it = pixels.begin(); it != pixels.end(); ++it) {
+    ids.insert(ids.end(), make_pair(it->first, (vbits > 0) ? (Int_t)r.Get() : 0));
+  }
+
+  return true;
+
+}//end of PayloadCodec::DecodeClusterIds method.
+
+//
+// PayloadCodec::WritePixelMap
+//
+inline void PayloadCodec::WritePixelMap(TBuffer & b, map<int,int> const & pixels,
+                                        vector<UChar_t> & scratch) {
+  Encode(pixels, scratch);
+  UInt_t size = scratch.size();
+  b << size;
+  if (size > 0) b.WriteFastArray(&scratch[0], size);
+}//end of PayloadCodec::WritePixelMap method.
+
+//
+// PayloadCodec::ReadPixelMap
+//
+inline void PayloadCodec::ReadPixelMap(TBuffer & b, map<int,int> & pixels,
+                                       vector<UChar_t> & scratch) {
+  UInt_t size;
+  b >> size;
+  scratch.resize(size);
+  if (size > 0) b.ReadFastArray(&scratch[0], size);
+  if (!Decode(size > 0 ? &scratch[0] : 0, size, pixels)) {
+    cout << "ERROR: corrupt frame payload (" << size << " bytes)." << endl;
+  }
+}//end of PayloadCodec::ReadPixelMap method.
+
+//
+// PayloadCodec::WriteClusterIds
+//
+inline void PayloadCodec::WriteClusterIds(TBuffer & b, map<int,int> const & pixels,
+                                          map<int,int> const & ids,
+                                          vector<UChar_t> & scratch) {
+  EncodeClusterIds(pixels, ids, scratch);
+  UInt_t size = scratch.size();
+  b << size;
+  if (size > 0) b.WriteFastArray(&scratch[0], size);
+}//end of PayloadCodec::WriteClusterIds method.
+
+//
+// PayloadCodec::ReadClusterIds
+//
+inline void PayloadCodec::ReadClusterIds(TBuffer & b, map<int,int> const & pixels,
+                                         map<int,int> & ids,
+                                         vector<UChar_t> & scratch) {
+  UInt_t size;
+  b >> size;
+  scratch.resize(size);
+  if (size > 0) b.ReadFastArray(&scratch[0], size);
+  if (!DecodeClusterIds(size > 0 ? &scratch[0] : 0, size, pixels, ids)) {
+    cout << "ERROR: corrupt frame cluster IDs (" << size << " bytes)." << endl;
+  }
+}//end of PayloadCodec::ReadClusterIds method.
+
+//
+// PayloadCodec::WriteEnergyMap
+//
+inline void PayloadCodec::WriteEnergyMap(TBuffer & b,
+                                         map<int,double> const & energies) {
+  UInt_t n = energies.size();
+  b << n;
+  map<int,double>::const_iterator it = energies.begin();
+  for ( ; it != energies.end(); ++it) {
+    b << (Int_t)it->first;
+    b << (Double_t)it->second;
+  }
+}//end of PayloadCodec::WriteEnergyMap method.
+
+//
+// PayloadCodec::ReadEnergyMap
+//
+inline void PayloadCodec::ReadEnergyMap(TBuffer & b, map<int,double> & energies) {
+  energies.clear();
+  UInt_t n;
+  b >> n;
+  for (UInt_t i = 0; i < n; ++i) {
+    Int_t X; Double_t E;
+    b >> X;
+    b >> E;
+    energies.insert(energies.end(), make_pair(X, E));
+  }
+}//end of PayloadCodec::ReadEnergyMap method.
+
+#endif
@@ -0,0 +1,131 @@
+/// @file RNTupleIO.h
+/// @brief Header file for the RNTuple frame writer and reader classes.
+
+#ifndef RNTupleIO_h
+#define RNTupleIO_h 1
+
+// Standard include statements.
+#include <iostream>
+
+// ROOT include statements.
+#include "TROOT.h"
+#include "TString.h"
+
+// Local include statements.
+#include "Frames.h"
+#include "ConverterOptions.h"
+
+using namespace std;
+
+/// @brief Writes frames to an RNTuple (MPXNTuple) in a ROOT file.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// Each FrameStruct data member is a field of the same (or the
+/// equivalent standard) type. The pixel maps become collections:
+/// pixelX/pixelC, lvl1X/lvl1V and energyX/energyE. The MC truth
+/// energies aren't stored.
+///
+/// RNTuple needs ROOT 6.34 or later. With older versions the writer
+/// reports an error and writes nothing (see IsAvailable).
+class RNTupleFrameWriter {
+
+ public:
+
+  /// @brief Constructor (creates the file).
+  ///
+  /// @param [in] path The path of the ROOT file.
+  /// @param [in] options The converter settings (for the compression).
+  RNTupleFrameWriter(TString path, ConverterOptions const & options);
+
+  /// @brief Destructor (closes the file if needed).
+  ~RNTupleFrameWriter();
+
+  /// @brief Can this ROOT write and read RNTuples?
+  static Bool_t IsAvailable();
+
+  /// @brief Was the file created?
+  Bool_t IsOpen() const { return m_impl != 0; }
+
+  /// @brief Add a frame to the RNTuple.
+  ///
+  /// @param [in] frame The frame to write.
+  void fillFrame(FrameStruct & frame);
+
+  /// @brief Write the remaining clusters and close the file.
+  void Close();
+
+  /// @brief Get the size of the file so far [bytes].
+  Long64_t GetBytesWritten() const;
+
+  /// @brief Get the path of the file.
+  TString GetFileName() const { return m_path; }
+
+ private:
+
+  /// @brief The RNTuple model and writer.
+  class Impl;
+
+  /// @brief Copy constructor (not implemented).
+  RNTupleFrameWriter(const RNTupleFrameWriter &);
+
+  /// @brief Copy assignment operator (not implemented).
+  RNTupleFrameWriter & operator=(const RNTupleFrameWriter &);
+
+  /// @brief The path of the file.
+  TString m_path;
+
+  /// @brief The writer (0 if none).
+  Impl * m_impl;
+
+};//end of RNTupleFrameWriter class definition.
+
+/// @brief Reads the frames of an RNTuple written by RNTupleFrameWriter.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+class RNTupleFrameReader {
+
+ public:
+
+  /// @brief Constructor (opens the RNTuple).
+  ///
+  /// @param [in] path The path of the ROOT file.
+  RNTupleFrameReader(TString path);
+
+  /// @brief Destructor.
+  ~RNTupleFrameReader();
+
+  /// @brief Was the RNTuple found?
+  Bool_t IsOpen() const { return m_impl != 0; }
+
+  /// @brief Get the number of frames.
+  Long64_t GetEntries() const;
+
+  /// @brief Read a frame.
+  ///
+  /// @param [in] entry The entry to read.
+  /// @return The frame (owned by the reader; 0 on failure).
+  FrameStruct * GetFrame(Long64_t entry);
+
+ private:
+
+  /// @brief The RNTuple reader.
+  class Impl;
+
+  /// @brief Copy constructor (not implemented).
+  RNTupleFrameReader(const RNTupleFrameReader &);
+
+  /// @brief Copy assignment operator (not implemented).
+  RNTupleFrameReader & operator=(const RNTupleFrameReader &);
+
+  /// @brief The reader (0 if none).
+  Impl * m_impl;
+
+  /// @brief The frame read.
+  FrameStruct * m_frame;
+
+};//end of RNTupleFrameReader class definition.
+
+#endif
@@ -0,0 +1,191 @@
+/// @file ValidationCounters.h
+/// @brief Header file for the ValidationCounters class.
+
+#ifndef ValidationCounters_h
+#define ValidationCounters_h 1
+
+// Standard include statements.
+#include <vector>
+
+// ROOT include statements.
+#include "TROOT.h"
+
+using namespace std;
+
+// Forward declarations.
+class TDirectory;
+class TH1D;
+
+/// @brief The cluster log conversion validation counts.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// Cl2MfConverter counts the lines, frames, clusters and pixels it
+/// reads here, as plain integers and compact histograms of the counts
+/// per frame and per cluster, rather than filling a TH1D each time.
+/// Each parsing thread has its own counters; they are merged at the
+/// end and written as the MPXVal_ histograms (same names and binning).
+class ValidationCounters {
+
+ public:
+
+  /// @brief Constructor.
+  ValidationCounters();
+
+  /// @brief Count a line of the file.
+  void AddLine() { ++m_nLines; }
+
+  /// @brief Count a frame header.
+  void AddHeader() { ++m_nHeaders; }
+
+  /// @brief Count a blank line (the end of a frame).
+  void AddBlank() { ++m_nBlanks; }
+
+  /// @brief Count a cluster.
+  ///
+  /// @param [in] npixels The number of pixels in the cluster.
+  void AddCluster(Long64_t npixels) {
+    ++m_nClusters;
+    m_pixelsPerCluster.Add(npixels);
+  }
+
+  /// @brief Count a complete frame.
+  ///
+  /// @param [in] pixelsRead The pixels read from the file.
+  /// @param [in] pixelsStored The pixels in the frame container.
+  /// @param [in] clustersRead The clusters read from the file.
+  /// @param [in] clustersFound The groups of touching pixels (the
+  /// clusters the BlobFinder finds, see ClusterValidator).
+  void AddFrame(Long64_t pixelsRead, Long64_t pixelsStored,
+                Long64_t clustersRead, Long64_t clustersFound) {
+    m_pixelsRead.Add(pixelsRead);
+    m_pixelsStored.Add(pixelsStored);
+    m_clustersRead.Add(clustersRead);
+    m_clustersFound.Add(clustersFound);
+  }
+
+  /// @brief Count the problems found with a frame's clusters.
+  ///
+  /// @param [in] outside The pixels outside of the frame.
+  /// @param [in] duplicates The pixels given more than once.
+  /// @param [in] split The clusters split into separate groups.
+  /// @param [in] touching The clusters touching another cluster.
+  void AddProblems(Long64_t outside, Long64_t duplicates,
+                   Long64_t split, Long64_t touching) {
+    m_nOutside    += outside;
+    m_nDuplicates += duplicates;
+    m_nSplit      += split;
+    m_nTouching   += touching;
+    if (outside + duplicates + split + touching > 0) ++m_nBadFrames;
+  }
+
+  /// @brief Count a frame re-clustered by the BlobFinder.
+  ///
+  /// @param [in] agreed Did it find the clusters in the file?
+  void AddBlobFinderCheck(Bool_t agreed) {
+    ++m_nBfChecked;
+    if (!agreed) ++m_nBfMismatched;
+  }
+
+  /// @brief Get the number of frames with invalid clusters.
+  Long64_t GetNBadFrames() const { return m_nBadFrames; }
+
+  /// @brief Get the number of frames re-clustered by the BlobFinder.
+  Long64_t GetNBfChecked() const { return m_nBfChecked; }
+
+  /// @brief Get the number of those where it found other clusters.
+  Long64_t GetNBfMismatched() const { return m_nBfMismatched; }
+
+  /// @brief Add another set of counts to these.
+  void Merge(ValidationCounters const & other);
+
+  /// @brief Write the counts to a directory as the validation histograms.
+  ///
+  /// @param [in] dir The directory (the validation file).
+  void Write(TDirectory * dir) const;
+
+ private:
+
+  /// @brief The number of times each (non-negative) value was seen.
+  class Counts {
+
+   public:
+
+    /// @brief Count a value.
+    void Add(Long64_t v) {
+      if (v < 0) v = 0;
+      if ((UInt_t)v >= m_n.size()) m_n.resize(v + 1, 0);
+      ++m_n[v];
+    }
+
+    /// @brief Add another set of counts to these.
+    void Merge(Counts const & other);
+
+    /// @brief Fill a histogram with the counts.
+    ///
+    /// @param [in] h The histogram.
+    /// @param [in] shift Added to each value filled.
+    void Fill(TH1D * h, Double_t shift) const;
+
+   private:
+
+    /// @brief The number of times each value was seen.
+    vector<Long64_t> m_n;
+
+  };
+
+  /// @brief Fill a single-bin counter histogram.
+  static void fillCount(TH1D * h, Long64_t n);
+
+  /// @brief The number of lines.
+  Long64_t m_nLines;
+
+  /// @brief The number of frame headers.
+  Long64_t m_nHeaders;
+
+  /// @brief The number of blank lines.
+  Long64_t m_nBlanks;
+
+  /// @brief The number of clusters.
+  Long64_t m_nClusters;
+
+  /// @brief The number of pixels outside of their frame.
+  Long64_t m_nOutside;
+
+  /// @brief The number of pixels given more than once in their frame.
+  Long64_t m_nDuplicates;
+
+  /// @brief The number of clusters split into separate groups.
+  Long64_t m_nSplit;
+
+  /// @brief The number of clusters touching another cluster.
+  Long64_t m_nTouching;
+
+  /// @brief The number of frames with any of the above.
+  Long64_t m_nBadFrames;
+
+  /// @brief The number of frames re-clustered by the BlobFinder.
+  Long64_t m_nBfChecked;
+
+  /// @brief The number of those where it found other clusters.
+  Long64_t m_nBfMismatched;
+
+  /// @brief The pixels per cluster.
+  Counts m_pixelsPerCluster;
+
+  /// @brief The pixels per frame (read from the file).
+  Counts m_pixelsRead;
+
+  /// @brief The pixels per frame (in the frame container).
+  Counts m_pixelsStored;
+
+  /// @brief The clusters per frame (read from the file).
+  Counts m_clustersRead;
+
+  /// @brief The clusters per frame (groups of touching pixels).
+  Counts m_clustersFound;
+
+};//end of ValidationCounters class definition.
+
+#endif
@@ -7,6 +7,7 @@
 // Standard include statements.
 #include <vector>
 #include <iostream>
+#include <atomic>
 
 // ROOT include statements.
 #include <TROOT.h>
@@ -22,22 +23,48 @@
 // Local include statements.
 #include "Frames.h"
 #include "FramesConsts.h"
+#include "ConverterOptions.h"
 
 // Forward declarations.
 class FramesHandler;
 class FrameStruct;
+class FrameRingWriter;
+class FrameIndex;
+class ZoneMap;
 
 /// @brief A class for handling the ntuple writing.
 ///
 /// @author J. Idárraga (principle author - idarraga@cern.ch)
 /// @author T. Whyntie (editor, CERN\@school - t.whyntie@qmul.ac.uk)
 /// @date August 2006 (ed. January 2014)
+///
+/// With the asyncWrite option the TTree is filled, compressed and
+/// written on a separate thread. The pixel data of each frame are
+/// moved into one of a small pool of frames and queued; when the pool
+/// runs out the caller waits for the writer to catch up.
+///
+/// With writeThreads > 0 the queued frames are filled and compressed
+/// by several threads, each with its own in-memory TTree, and merged
+/// into the one output file with ROOT's TBufferMerger. The threads take
+/// consecutive blocks of frames and hand them to the merger in turn, so
+/// the frames stay in the order they were written.
+///
+/// The start time and frame ID of each frame are also added to a
+/// FrameIndex, and its summary quantities to a ZoneMap; both are
+/// stored in the file when it is closed.
 class WriteToNtuple {
 
  public:
 
   /// @brief Constructor.
-  WriteToNtuple(TString, TString);
+  ///
+  /// @param [in] dataSet The dataset ID.
+  /// @param [in] tempScratchDir The output directory ("" for here).
+  /// @param [in] options The converter settings (for the writer mode).
+  /// @param [in] fileNum The number of the file in the dataset.
+  WriteToNtuple(TString dataSet, TString tempScratchDir,
+                ConverterOptions const & options = ConverterOptions(),
+                Int_t fileNum = 1);
 
   /// @brief Desctructor.
   ~WriteToNtuple();
@@ -48,17 +75,64 @@ class WriteToNtuple {
   /// @param [in] rewind_metadata Reset the frame data and metadata?
   void fillVars(FramesHandler * frameHandlerObj, bool rewind_metadata = true);
 
-  /// @brief Closes the ntuple.
+  /// @brief Write a frame to the ntuple.
+  ///
+  /// The frame's summary statistics and occupancy are computed here
+  /// (see FrameStruct::UpdateFrameStats), so callers needn't.
+  ///
+  /// When writing asynchronously the pixel data are moved out of the
+  /// frame, which is left with the metadata only.
+  ///
+  /// @param [in,out] frame The frame to write.
+  void fillFrame(FrameStruct & frame);
+
+  /// @brief Closes the ntuple (writing any frames still queued).
   void closeNtuple();
 
+  /// @brief Publish each frame written to a shared-memory ring.
+  ///
+  /// @param [in] ring The ring to publish to (not owned; 0 for none).
+  inline void SetFrameRing(FrameRingWriter * ring) { m_ring = ring; }
+
+  /// @brief Get the number of compressed bytes written so far.
+  ///
+  /// Baskets still being filled aren't counted, and when writing
+  /// asynchronously the count lags behind the frames handed over.
+  ///
+  /// @return The number of bytes written to the file (or merger).
+  Long64_t GetBytesWritten() const {
+    return m_bytesWritten.load(std::memory_order_relaxed);
+  }
+
   /// @brief Returns the ntuple file name.
   TString GetNtupleFileName() { return m_ntupleFileName; };
 
 private:
-  
+
+  /// @brief The frame queue and thread of the asynchronous writer.
+  class AsyncWriter;
+
+  /// @brief The frame queue, threads and merger of the parallel writer.
+  class ParallelWriter;
+
+  /// @brief The asynchronous writer thread's loop.
+  void writeLoop();
+
+  /// @brief A parallel writer thread's loop.
+  void mergeLoop();
+
   /// @brief Pointer to the frame container.
   FrameStruct * m_frame;
 
+  /// @brief The frame container created with the ntuple.
+  FrameStruct * m_ownFrame;
+
+  /// @brief The asynchronous writer (0 if not used).
+  AsyncWriter * m_async;
+
+  /// @brief The parallel writer (0 if not used).
+  ParallelWriter * m_parallel;
+
   /// @brief Histogram - what is this for?
   TH2 * h1;
 
@@ -74,6 +148,18 @@ private:
   /// @brief The ntuple file name.
   TString m_ntupleFileName;
 
+  /// @brief The shared-memory ring the frames are published to (if any).
+  FrameRingWriter * m_ring;
+
+  /// @brief The number of compressed bytes written (see GetBytesWritten).
+  std::atomic<Long64_t> m_bytesWritten;
+
+  /// @brief The start time and frame ID index of the frames written.
+  FrameIndex * m_index;
+
+  /// @brief The quantity ranges of each entry cluster of the frames written.
+  ZoneMap * m_zones;
+
   //ClassDef(WriteToNtuple,1)
 
 };
@@ -0,0 +1,203 @@
+/// @file ZoneMap.h
+/// @brief Header file for the ZoneMap class.
+
+#ifndef ZoneMap_h
+#define ZoneMap_h 1
+
+// Standard include statements.
+#include <iostream>
+#include <vector>
+#include <utility>
+
+// ROOT include statements.
+#include "TROOT.h"
+#include "TString.h"
+
+using namespace std;
+
+// Forward declarations.
+class TDirectory;
+class TTree;
+class FrameStruct;
+
+/// @brief Minimum and maximum frame quantities of each entry cluster.
+///
+/// @author T. Whyntie (CERN\@school - t.whyntie@qmul.ac.uk)
+/// @date October 2026
+///
+/// The writers add each frame as it is written. When the file is
+/// closed the ranges of the quantities over each of MPXTree's entry
+/// clusters (the entries whose baskets are flushed together) are
+/// stored in the file as the MPXZoneMap TTree, one entry per cluster.
+///
+/// A reader sets some cuts and asks for the entry ranges that might
+/// pass them; the clusters that can't are never read or decompressed:
+///
+///     ZoneMap zones;
+///     zones.Read(file);
+///     zones.AddCut(ZoneMap::kOccupancy, 100, 1e9);
+///     vector< pair<Long64_t,Long64_t> > ranges;
+///     zones.GetEntryRanges(ranges);
+///
+/// MfReader::AddZoneCut() reads a file in this way (Mf-cluster's
+/// --zone-cut option).
+class ZoneMap {
+
+ public:
+
+  /// @brief The quantities recorded.
+  enum Quantity {
+    kStartTime = 0, ///< Frame start time [s].
+    kOccupancy,     ///< Number of pixels hit.
+    kTotalToT,      ///< Sum of the pixel counts.
+    kLatitude,      ///< Latitude [deg].
+    kLongitude,     ///< Longitude [deg].
+    kAltitude,      ///< Altitude [km].
+    kHV,            ///< Bias voltage [V].
+    kNQuantities
+  };
+
+  /// @brief Get the name of a quantity (as used for the branches).
+  static const char * GetQuantityName(Int_t q);
+
+  /// @brief Find a quantity by name.
+  ///
+  /// @return The quantity (-1 if there is none of that name).
+  static Int_t FindQuantity(TString name);
+
+  /// @brief Get the value of a quantity for a frame.
+  static Double_t GetValue(FrameStruct & frame, Int_t q);
+
+  /// @brief Constructor.
+  ZoneMap();
+
+  /// @brief Destructor.
+  ~ZoneMap();
+
+  /// @brief Add the next entry of the tree.
+  ///
+  /// @param [in] frame The frame written as the next entry.
+  void Add(FrameStruct & frame);
+
+  /// @brief Add the zones of another file after the entries so far.
+  ///
+  /// Used when that file's tree is copied to the end of this one
+  /// without reading the frames; its zones are kept as they are.
+  ///
+  /// @param [in] other The zone map of the copied tree.
+  /// @param [in] nentries The number of entries in the copied tree.
+  void Append(ZoneMap const & other, Long64_t nentries);
+
+  /// @brief Work out the cluster ranges and write them to a directory.
+  ///
+  /// @param [in] dir The directory (file) to write to.
+  /// @param [in] tree The written tree, for its entry clusters.
+  /// @return Was the zone map written?
+  Bool_t Write(TDirectory * dir, TTree * tree);
+
+  /// @brief Write the zones as they are (e.g. read and updated) to a
+  /// directory, replacing any zone map there.
+  ///
+  /// @param [in] dir The directory (file) to write to.
+  /// @return Was the zone map written?
+  Bool_t WriteZones(TDirectory * dir);
+
+  /// @brief Recompute the ranges of a quantity from new values.
+  ///
+  /// Used when an overlay changes the values of the frames, whose
+  /// entry clusters stay the same.
+  ///
+  /// @param [in] q The quantity.
+  /// @param [in] values The new value for each entry.
+  void SetValues(Int_t q, vector<Double_t> const & values);
+
+  /// @brief Read the zone map from a directory (file).
+  ///
+  /// @param [in] dir The directory holding MPXZoneMap.
+  /// @return Was a zone map found?
+  Bool_t Read(TDirectory * dir);
+
+  /// @brief Get the number of zones (entry clusters).
+  Int_t GetNZones() const { return (Int_t)m_first.size(); }
+
+  /// @brief Get the first entry of a zone.
+  Long64_t GetFirstEntry(Int_t zone) const { return m_first[zone]; }
+
+  /// @brief Get the entry after the last one of a zone.
+  Long64_t GetEndEntry(Int_t zone) const { return m_end[zone]; }
+
+  /// @brief Get the smallest value of a quantity in a zone.
+  Double_t GetMin(Int_t zone, Int_t q) const { return m_min[zone*kNQuantities + q]; }
+
+  /// @brief Get the largest value of a quantity in a zone.
+  Double_t GetMax(Int_t zone, Int_t q) const { return m_max[zone*kNQuantities + q]; }
+
+  /// @brief Only keep the zones with some values lo <= q <= hi.
+  void AddCut(Int_t q, Double_t lo, Double_t hi);
+
+  /// @brief Remove the cuts.
+  void ClearCuts() { m_cuts.clear(); }
+
+  /// @brief Are there any cuts?
+  Bool_t HasCuts() const { return !m_cuts.empty(); }
+
+  /// @brief Might a zone have frames passing all of the cuts?
+  Bool_t Passes(Int_t zone) const;
+
+  /// @brief Does a frame pass all of the cuts?
+  ///
+  /// The zones only rule out whole entry clusters, so the frames read
+  /// from the ranges that remain are checked one by one with this.
+  Bool_t Passes(FrameStruct & frame) const;
+
+  /// @brief Get the entry ranges that might pass the cuts.
+  ///
+  /// Neighbouring zones are joined into one range.
+  ///
+  /// @param [out] ranges The (first, end) entry pairs.
+  /// @return The number of entries in the ranges.
+  Long64_t GetEntryRanges(vector< pair<Long64_t,Long64_t> > & ranges) const;
+
+ private:
+
+  /// @brief A cut on a quantity.
+  struct Cut {
+    Int_t    q;  ///< The quantity.
+    Double_t lo; ///< The lower limit.
+    Double_t hi; ///< The upper limit.
+  };
+
+  /// @brief Consecutive entries added with Add.
+  struct Run {
+    Long64_t first;  ///< The first entry.
+    Long64_t end;    ///< The entry after the last one.
+    Long64_t offset; ///< The position of the first frame in m_values.
+  };
+
+  /// @brief The quantities of each frame added (kNQuantities per frame).
+  vector<Double_t> m_values;
+
+  /// @brief The entries of the frames in m_values.
+  vector<Run> m_runs;
+
+  /// @brief The number of entries added or appended.
+  Long64_t m_nEntries;
+
+  /// @brief The first entry of each zone (or appended zone, until written).
+  vector<Long64_t> m_first;
+
+  /// @brief The entry after the last one of each zone.
+  vector<Long64_t> m_end;
+
+  /// @brief The smallest values (kNQuantities per zone).
+  vector<Double_t> m_min;
+
+  /// @brief The largest values (kNQuantities per zone).
+  vector<Double_t> m_max;
+
+  /// @brief The cuts.
+  vector<Cut> m_cuts;
+
+};//end of ZoneMap class definition.
+
+#endif
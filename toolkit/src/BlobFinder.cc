@@ -1,8 +1,35 @@
 /// @file BlobFinder.cpp
 /// @brief Implementation of the BlobFinder class (and related classes).
 
+// Standard include statements.
+#include <memory>
+
 #include "BlobFinder.h"
 
+namespace {
+
+  /// @brief The clustering state kept between BlobFinders on a thread.
+  ///
+  /// A BlobFinder is made for each frame, so the finder and the hit
+  /// grid are kept between them, and only made again when the frame
+  /// size changes.
+  struct SharedState {
+    unique_ptr<ClusterFinder> finder; ///< The cluster finder.
+    vector<UChar_t> hit;              ///< Is each pixel X hit? (All clear between frames.)
+  };
+
+  /// @brief Get this thread's state for a frame size.
+  SharedState & sharedState(Int_t C, Int_t R) {
+    static thread_local SharedState state;
+    if (!state.finder || state.finder->GetWidth() != C || state.finder->GetHeight() != R) {
+      state.finder.reset(new ClusterFinder(C, R));
+      state.hit.assign(C > 0 && R > 0 ? C*R : 0, 0);
+    }
+    return state;
+  }
+
+}
+
 //
 // Pixel constructor.
 //
@@ -109,93 +136,94 @@ BlobFinder::BlobFinder(std::map<int,int> const & data,
   // An arbitrary check on number of pixels in the frame.
   //if (data.size()>=10000) return;
 
-  Int_t dirX[8] = {-1, -1,  0,  1,  1,  1,  0, -1};
-  Int_t dirY[8] = { 0,  1,  1,  1,  0, -1, -1, -1};
-
-  std::map<int, Pixel*> mapPixel;          // Map of the pixels.
-
-
-  // Loop over the data supplied to the BlobFinder.
-  // * Puts all of the data into the pixel map;
-  // * Assigns neighbouring pixels where it find them.
-  //std::map<int,double>::iterator mapIter; // Iterator for the pixel map.
+  // Copy the data supplied to the BlobFinder into arrays (in X order).
+  std::vector<Int_t> X, counts;
+  X.reserve(data.size());
+  counts.reserve(data.size());
   std::map<int,int>::const_iterator mapIter; // Iterator for the pixel map.
   //
   for(mapIter=data.begin(); mapIter!=data.end(); mapIter++) {
-//            int xplace = r*C + c; //xplace is increasing
-    int xplace=mapIter->first; // The current pixel X.
-    Int_t r=xplace/C;          // The current row.
-    Int_t c=xplace%C;          // The current column.
-    //if(dbg) cout<<"DEBUG: xplace,r,c="<<xplace<<", "<<r<<", "<<c<<endl;
-
-    // Create (a pointer to) a new pixel.
-    double counts = mapIter->second;
-    //Pixel* p = new Pixel(c, r, double(data[xplace]), -1);
-    Pixel* p = new Pixel(c, r, counts, -1);
-    //Pixel* p = new Pixel(c, r, data[xplace], -1);
-    mapPixel[xplace] = p; //put the pixel on the map.
-
-    // Loop over the eight possible directions.
-    for(Int_t dir = 0; dir < 8; dir++) {
-      Int_t nr = r + dirY[dir]; // Next row.    // SH be careful
-      Int_t nc = c + dirX[dir]; // Next column.
-
-      // If the next row or column is on an edge, skip it.
-      if(nr<0 || nr>=R || nc<0 || nc>=C) continue;
-
-      // Find the next X pixel value.
-      Int_t nplace = nr * C + nc;    // The next X value.
-      std::map<Int_t,Pixel*>::iterator pIter; // Iterator to search the map.
-      pIter = mapPixel.find(nplace); // Search the map.
-      if( pIter!=mapPixel.end()) {   // We have a pixel at the next X! // SH - hit
-        Pixel * n = pIter->second;   // The neighbouring pixel.
-        p->setNeighbor(dir,n);       // Set the found pixel as a neighbour.
-        n->setNeighbor((dir+4)%8,p); // And return the favour.
-      }//end of hit pixel check.
-    }//end over the loop of the possible directions.
+    X.push_back(mapIter->first);
+    counts.push_back(mapIter->second);
   }//end of loop over the pixel map.
 
-  //if (dbg) cout<<"DEBUG: * Size of Pixel map = "<<mapPixel.size()<<endl;
-
-  // Now loop over the pixels
-  std::map<int, Pixel*>::iterator iter;
-  for(iter=mapPixel.begin(); iter!=mapPixel.end(); iter++) {
-    Pixel * p = iter->second;
-
-    // So, the mask determines if the pixel has been clustered???
-    if(p->getMask()==-1) { //start a new blob
-      Blob aBlob; // The new blob
-      p->setMask(0);
-      aBlob.insert(p);
-
-      // Loop over the list of pixels in the blob.
-      std::list<Pixel*>::iterator listIter=aBlob.listPixel.begin();
-      while(listIter!=aBlob.listPixel.end()) {
-        Pixel* px = (*listIter);
-        for(Int_t dir = 0; dir < 8; dir++){
-          Pixel * n = px->getNeighbor(dir);
-          if (n) {
-            px->setMask(px->getMask() + pow(2.0,1.0*dir));
-            // If the Pixel isn't already in the Blob, add it.
-            if(aBlob.isNotContain(n)) {
-              n->setMask(0);
-              aBlob.insert(n);
-            }//end of Pixel presence check.
-          }//end of Pixel existence check.
-        }//end of loop over the directions.
-        listIter++;
-      }//end of while loop over the Blob contents.
-      aBlob.getBlobProperties();
-      insert(aBlob);   
-    }//end of check on the Pixel mask.
-  }//end of loop over the Pixels.
-  //getBlobProperties();
+  findBlobs(X.empty() ? 0 : &X[0], counts.empty() ? 0 : &counts[0], X.size(), R, C);
 
 }//end of BlobFinder constructor (doubles).
 
+//
+// BlobFinder constructor (pixel arrays)
+//
+BlobFinder::BlobFinder(Int_t const * X,
+                       Int_t const * counts,
+                       UInt_t n,
+                       Int_t R,
+                       Int_t C)
+{
+
+  listBlob.clear();
+
+  findBlobs(X, counts, n, R, C);
+
+}//end of BlobFinder constructor (pixel arrays).
+
+//
+// BlobFinder::findBlobs
+//
+void BlobFinder::findBlobs(Int_t const * X, Int_t const * counts, UInt_t n,
+                           Int_t R, Int_t C) {
+
+  // The directions of the neighbour mask bits (as in the original
+  // neighbour search: bit dir is set for a neighbour at dirX, dirY).
+  static const Int_t dirX[8] = {-1, -1,  0,  1,  1,  1,  0, -1};
+  static const Int_t dirY[8] = { 0,  1,  1,  1,  0, -1, -1, -1};
+
+  // Label the pixels (C columns, R rows) with the ClusterFinder, then
+  // make a blob of each cluster, in the order of its first pixel.
+  SharedState & state = sharedState(C, R);
+  ClusterFinder & finder = *state.finder;
+  finder.Find(X, n);
+
+  Int_t size = state.hit.size();
+  for (UInt_t i = 0; i < n; ++i) {
+    if (X[i] >= 0 && X[i] < size) state.hit[X[i]] = 1;
+  }
+
+  // The pixels are made in one block, owned by the BlobFinder.
+  m_pixels.clear();
+  m_pixels.reserve(n);
+
+  for (UInt_t b = 0; b < finder.GetNClusters(); ++b) {
+    Blob aBlob; // The new blob
+    UInt_t const * px = finder.GetClusterPixels(b);
+    for (UInt_t j = 0; j < finder.GetClusterSize(b); ++j) {
+      Int_t xplace = X[px[j]];
+      Int_t r = xplace/C, c = xplace%C;
+      // The mask has a bit for each neighbour hit.
+      Int_t mask = 0;
+      for (Int_t dir = 0; dir < 8; ++dir) {
+        Int_t nr = r + dirY[dir], nc = c + dirX[dir];
+        if (nr < 0 || nr >= R || nc < 0 || nc >= C) continue;
+        if (state.hit[nr*C + nc]) mask |= 1 << dir;
+      }
+      m_pixels.push_back(Pixel(c, r, counts[px[j]], mask));
+      aBlob.insert(&m_pixels.back());
+    }
+    aBlob.getBlobProperties();
+    insert(aBlob);
+  }//end of loop over the clusters.
+
+  for (UInt_t i = 0; i < n; ++i) {
+    if (X[i] >= 0 && X[i] < size) state.hit[X[i]] = 0;
+  }
+
+}//end of BlobFinder::findBlobs method.
+
 //
 // BlobFinder destructor.
 //
 BlobFinder::~BlobFinder(){
 
+  // The pixels are freed with m_pixels.
+
 }//end of BlobFinder destructor.
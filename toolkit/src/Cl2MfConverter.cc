@@ -1,8 +1,79 @@
 /// @file Cl2MfConverter.cc
 /// @brief Implementation of the cal->ROOT data converter class.
 
+// Standard include statements.
+#include <thread>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 #include "Cl2MfConverter.h"
 
+namespace {
+
+  /// @brief Find the start of the first frame at or after p.
+  ///
+  /// Frames start after a blank line ("\n\n" or "\n\r\n").
+  ///
+  /// @return The start of the frame (end if there is none).
+  const char * nextFrameStart(const char * p, const char * end) {
+
+    while (p < end) {
+      const char * nl = (const char *)memchr(p, '\n', end - p);
+      if (!nl) return end;
+      if (nl + 1 < end && nl[1] == '\n') return nl + 2;
+      if (nl + 2 < end && nl[1] == '\r' && nl[2] == '\n') return nl + 3;
+      p = nl + 1;
+    }
+
+    return end;
+
+  }
+
+  /// @brief Find the start of the last frame starting in [begin, end).
+  ///
+  /// @return The start of the frame (0 if there is none after begin).
+  const char * lastFrameStart(const char * begin, const char * end) {
+
+    for (const char * p = end - 1; p > begin; --p) {
+      if (*p != '\n') continue;
+      if (p[-1] == '\n') return p + 1;
+      if (p - 1 > begin && p[-1] == '\r' && p[-2] == '\n') return p + 1;
+    }
+
+    return 0;
+
+  }
+
+  /// @brief The frames each parsing thread may have waiting to be written.
+  const UInt_t kFramesPerPart = 64;
+
+  /// @brief A window of the cluster log file being parsed.
+  ///
+  /// Each part of the window is parsed on its own thread into its own
+  /// queue, and the queues are drained in file order.
+  struct ParseWindow {
+
+    /// @brief The mapping of the window.
+    void * map;
+
+    /// @brief The length of the mapping.
+    off_t len;
+
+    /// @brief The parsed frames of each part.
+    vector<FrameQueue*> queues;
+
+    /// @brief The parsing threads.
+    vector<thread> workers;
+
+    /// @brief The validation counts of each parsing thread.
+    vector<ValidationCounters> counters;
+
+  };
+
+}
+
 //
 // Cl2MfConverter constructor
 //
@@ -12,15 +83,18 @@ Cl2MfConverter::Cl2MfConverter(
     TString outputdir,
     Int_t frames_per_root_file,
     Int_t num_frames_to_read,
-    Bool_t dbg
+    Bool_t dbg,
+    ConverterOptions const & options
 )
  :
   m_outputDir(outputdir),
+  m_options(options),
   //m_MPXDataSetNumber(dataSet),
   //m_ntupleFileBaseName(outputdir + "/"),
   m_currentNtupleFileNum(0),
   m_currentFrameNumber(1),
-  m_clfis(datasetpath)
+  m_clfis(datasetpath),
+  m_pValidator(0)
 {
 
   // Get the info from the XML file
@@ -65,36 +139,34 @@ Cl2MfConverter::Cl2MfConverter(
   // Create the validation ROOT file.
   m_pVf = new TFile(m_valPath, "RECREATE");
 
-  // Create the validation histograms.
-  m_hg_nframes_ex   = new TH1D("nFrames_ex",   "",1,0.0,1.0);
-  m_hg_nLines_ex    = new TH1D("nLines_ex",    "",1,0.0,1.0);
-  m_hg_nHeaders_ex  = new TH1D("nHeaders_ex",  "",1,0.0,1.0);
-  m_hg_nClusters_ex = new TH1D("nClusters_ex", "",1,0.0,1.0);
-  m_hg_nBlanks_ex   = new TH1D("nBlanks_ex",   "",1,0.0,1.0);
-  //
-  m_hg_nPixelsPf_ex   = new TH1D("nPixelsPf_ex","",65536,0.0,65536.0);
-  m_hg_nPixelsPf_fc   = new TH1D("nPixelsPf_fc","",65536,0.0,65536.0);
-  //
-  m_hg_nClustersPf_ex = new TH1D("nClustersPf_ex","",16384,0.,16384.0);
-  m_hg_nClustersPf_bf = new TH1D("nClustersPf_bf","",16384,0.,16384.0);
-  //
-  m_hg_ppc_ex = new TH1D("ppc_ex","",11811,0.,11811.0);
-  //
+  // Create the start and end times pseudo-histogram. (The validation
+  // counts are kept in m_counters and written at the end.)
   m_phg_times = new TH1D("times","",2,0.0,2.0);
 
-  // Create the first ROOT ntuple file.
-  m_pNt = new TFile(m_outputPath, "RECREATE");
-
-  // Create the ROOT TTree.
-  m_pTr = new TTree("MPXTree","Medi/TimePix data");
-
   // Create the frame container.
   m_pFrame = new FrameStruct(m_pCalibMetadata->GetMPXDataSetNumber());
 
-  // Create the branch for the frame information.
-  m_pTr->Branch("FramesData", "FrameStruct", &m_pFrame, 128000, 2);
+  // Create the cluster validator.
+  m_pValidator = new ClusterValidator(m_pCalibMetadata->GetFrameWidth(),
+                                      m_pCalibMetadata->GetFrameHeight());
+
+  // Publish the frames to a shared-memory ring for live monitors?
+  m_pRing = 0;
+  if (options.shmRing.Length() > 0) {
+    m_pRing = new FrameRingWriter(options.shmRing,
+                                  options.shmRingSlots,
+                                  options.shmRingMaxPixels);
+  }
+
+  // Create the first ROOT ntuple file. The output manager starts a
+  // new file every frames_per_root_file frames (or --file-size MB),
+  // the first file included.
+  openNtuple(frames_per_root_file);
+
+  // Parse the file on several threads?
+  if (options.readThreads > 0) processParallel(datasetpath, num_frames_to_read, dbg);
 
-  Bool_t more_frames = true;
+  Bool_t more_frames = (options.readThreads == 0);
 
   while (more_frames) {
 
@@ -111,57 +183,6 @@ Cl2MfConverter::Cl2MfConverter(
       }//end of dbg check.
     }//end of end of frames check.
 
-    // Check if the frames/ROOT file limit has been reached.
-    // If the limit has been reached, close the ROOT file
-    // and create a new one.
-    if ((m_currentFrameNumber % frames_per_root_file == 0) && more_frames) {
-
-      if (dbg) {
-        cout
-          << "DEBUG:" << endl
-          << "DEBUG: Reached the frames_per_root_file limit."               << endl
-          << "DEBUG: Current ROOT file number = " << m_currentNtupleFileNum << endl
-          << "DEBUG: m_currentFrameNumber = " << m_currentFrameNumber       << endl;
-      }
-
-      // Close the current old ntuple file.
-      closeNtuple();
-
-      // Increment the ROOT file number.
-      m_currentNtupleFileNum++;
-
-      // Add the data set label to the ROOT file name.
-      m_currentNtupleFileName.str("");
-      m_currentNtupleFileName
-        //<< "MPXNtuple_"
-        << m_pCalibMetadata->GetMPXDataSetNumber() << "_"
-        << setw(10) << setfill('0') << m_currentNtupleFileNum
-        << ".root";
-      m_outputPath = m_outputDir + "/" + m_currentNtupleFileName.str();
-      
-      // Create a new ntuple file.
-      m_pNt = new TFile(m_outputPath, "RECREATE");
-
-      // Create the ROOT TTree.
-      m_pTr = new TTree("MPXTree","Medi/TimePix data");
-
-      // Create the branch for the frame information.
-      m_pTr->Branch("FramesData", "FrameStruct", &m_pFrame, 128000, 2);
-
-      // Update the user (debug mode).
-      if (dbg) {
-        cout
-          << "DEBUG:" << endl
-          << "DEBUG: Current ROOT file number = " << m_currentNtupleFileNum   << endl
-          << "DEBUG: New ROOT file path = '" << m_currentNtupleFileName.str() << endl
-          << "DEBUG:" << endl;
-      }
-      cout 
-        << "INFO: ROOT file '" << m_currentNtupleFileName.str() 
-        << "', frame "         << m_currentFrameNumber << endl;
-
-    }//end of check of the frames/ROOT file limit.
-
     if (dbg && !more_frames) {
       cout
         << "DEBUG: Exiting the loop over the frames." << endl
@@ -176,7 +197,18 @@ Cl2MfConverter::Cl2MfConverter(
   // Close the last ntuple file.
   closeNtuple();
 
+  if (m_counters.GetNBadFrames() > 0) {
+    cout << "WARNING: " << m_counters.GetNBadFrames()
+         << " frames had invalid clusters (see '" << m_valPath << "')." << endl;
+  }
+  if (m_counters.GetNBfMismatched() > 0) {
+    cout << "WARNING: the BlobFinder found other clusters in "
+         << m_counters.GetNBfMismatched() << " of "
+         << m_counters.GetNBfChecked() << " frames checked." << endl;
+  }
+
   // Write the validation histograms to file.
+  m_counters.Write(m_pVf);
   m_pVf->Write();
   m_pVf->Close();
 
@@ -192,7 +224,10 @@ Cl2MfConverter::~Cl2MfConverter() {
   // Delete the pointer to the calibration data wrapper.
   if (m_pCalibMetadata) delete m_pCalibMetadata;
 
-  if (m_bf) delete m_bf;
+  if (m_pValidator) delete m_pValidator;
+
+  // Remove the shared-memory ring.
+  if (m_pRing) delete m_pRing;
 
   // Close the cluster log file input stream.
   m_clfis.close();
@@ -223,37 +258,30 @@ Bool_t Cl2MfConverter::processNextFrame(Bool_t dbg) {
 
     // Increment the line counter.
     num_lines++;
-    m_hg_nLines_ex->Fill(0.5);
+    m_counters.AddLine();
 
     // Read the next line of the cluster log file.
     getline(this->m_clfis,line);
 
-    // Retrieve frame number, acquisition time and time stamp subroutine
-    
+    const char * lb = line.data();
+    const char * le = lb + line.size();
+
     // Find "Frame n (....., ...s)" by checking if the input data
     // line has a '(' in it.
-    if (line.find ('(') != string::npos) {
+    if (ClusterLogParser::IsHeader(lb, le)) {
 
-      m_hg_nHeaders_ex->Fill(0.5);
+      m_counters.AddHeader();
 
-      // Extract the frame information from the "header".
-      int l_bracket = line.find('(');
-      int r_bracket = line.find(')');
-      int comma     = line.find(',');
-
-      // Extract the frame number from the header.	  
-      int f_num_from_file = atoi(line.substr(6,l_bracket-1).c_str());
+      // Extract the frame number, start time and acquisition time.
+      Int_t    f_num_from_file = 0;
+      Double_t starttime = 0., acqtime = 0.;
+      ClusterLogParser::ParseHeader(lb, le, f_num_from_file, starttime, acqtime);
 
       // Set the frame ID from the frame number.
       m_pFrame->SetId(f_num_from_file);
 
-      // Extract the start time from the header.
-      string timestamp    = line.substr(l_bracket+1,(comma-l_bracket-3));
-      int    timestampdot = timestamp.find('.');
-      string timestampdec = timestamp.substr(timestampdot,timestamp.length()-timestampdot);
-      double starttime = atof(timestamp.c_str());
       Utils::TimeHandler t(starttime);
-      
+
       // Set the frame start time (numeric and string)
       m_pFrame->SetStartTime(starttime);
       m_pFrame->SetStartTimeS(t.GetPixelmanTime());
@@ -261,22 +289,16 @@ Bool_t Cl2MfConverter::processNextFrame(Bool_t dbg) {
       // Store the start time for the validation file.
       if (m_currentFrameNumber==1) m_phg_times->SetBinContent(1,starttime);
 
-      // Extract and the acquisition time from the header.
-      string acqtime = line.substr(comma+2,(r_bracket-comma)-4);
-
       // Set the acquisition time.
-      m_pFrame->SetAcqTime(atof(acqtime.c_str()));
+      m_pFrame->SetAcqTime(acqtime);
 
       // Store the end time for the validation file.
-      m_phg_times->SetBinContent(2,starttime+atof(acqtime.c_str()));
+      m_phg_times->SetBinContent(2,starttime+acqtime);
 	  
       if (dbg) {
-        //cout << "DEBUG: l_bracket = " << l_bracket << endl;
-        //cout << "DEBUG: r_bracket = " << r_bracket << endl;
-        //cout << "DEBUG: comma     = " << comma     << endl;
         cout << "DEBUG: frame number from counter   = '" << m_currentFrameNumber << "'" << endl;
         cout << "DEBUG: frame number from file      = '" << f_num_from_file      << "'" << endl;
-        cout << "DEBUG: start time from file        = '" << timestamp            << "'" << endl;
+        cout << "DEBUG: start time from file        = '" << TString::Format("%.6f", starttime) << "'" << endl;
         cout << "DEBUG: start time from file (str.) = '" << t.GetPixelmanTime()  << "'" << endl;
         cout << "DEBUG: acquisition time from file  = '" << acqtime              << "'" << endl;
       }
@@ -287,13 +309,10 @@ Bool_t Cl2MfConverter::processNextFrame(Bool_t dbg) {
         cout << "ERROR: f_num_from_file = " << f_num_from_file      << endl;
         exit(0);
       }
-    } else if (line.empty() || line=="\r") { // blank line - end of the frame.
-
-      // Increment the number of blanks (extraction) histogram counter.
-      m_hg_nBlanks_ex->Fill(0.5);
+    } else if (ClusterLogParser::IsBlank(lb, le)) { // blank line - end of the frame.
 
-      // Increment the number of frames (extraction) histogram.
-      m_hg_nframes_ex->Fill(0.5);
+      // Count the blank line (and so the frame).
+      m_counters.AddBlank();
 
       if (dbg) {
         cout << "DEBUG: Found a blank line." << endl;
@@ -301,108 +320,22 @@ Bool_t Cl2MfConverter::processNextFrame(Bool_t dbg) {
         cout << "DEBUG: Clusters in the frame = " << clusters_in_frame << endl;
       }
 
-      // Payload 
-      //---------
-      // [Pixel counts added in the cluster processing.]
-      // [No Level 1 trigger.]
-      // [No energy information.]
-      // [No truth energy information.]
-
-      // Add the whole-frame data.
-      // [Hit pixel counter incremented in the cluster processing.]
-      // [Hit counter incremented in the cluster processing.]
-      // [Charge counter incremented in the cluster processing.]
-      m_pFrame->SetFrameAsData();
-
-      // Payload information
-      //---------------------
-      m_pFrame->SetnX(m_pCalibMetadata->GetFrameWidth());
-      m_pFrame->SetnY(m_pCalibMetadata->GetFrameHeight());
-      m_pFrame->SetPayloadFormat(m_pCalibMetadata->GetPayloadFormat());
-      // [Frame ID set from the frame number in the file.]
-      m_pFrame->SetDataSet(m_pCalibMetadata->GetMPXDataSetNumber());
-      m_pFrame->UpdateOccupancy();
-      m_pFrame->CalculateDoseRates();
-
-      // Acquisition information
-      //-------------------------
-      m_pFrame->SetAcqMode(m_pCalibMetadata->GetAcqMode());
-      m_pFrame->SetCounters(m_pCalibMetadata->GetCounters());
-      m_pFrame->SetHwTimerMode(m_pCalibMetadata->GetHwTimerMode());
-      m_pFrame->SetAutoEraseInterval(m_pCalibMetadata->GetAutoEraseInterval());
-      m_pFrame->SetAutoEraseIntervalCounter(
-        m_pCalibMetadata->GetAutoEraseIntervalCounter());
-      m_pFrame->SetLastTriggerTime(m_pCalibMetadata->GetLastTriggerTime());
-      m_pFrame->SetCoincidenceMode(m_pCalibMetadata->GetCoincidenceMode());
-      m_pFrame->SetCoincidenceDelayTime(m_pCalibMetadata->GetCoincidenceDelayTime());
-      m_pFrame->SetCoincidenceLiveTime(m_pCalibMetadata->GetCoincidenceLiveTime());
-      m_pFrame->SetPixelmanVersion(m_pCalibMetadata->GetPixelmanVersion());
-
-      // Geospatial information
-      //------------------------
-      m_pFrame->SetLatitude( m_pCalibMetadata->GetLatitude() );
-      m_pFrame->SetLongitude(m_pCalibMetadata->GetLongitude());
-      m_pFrame->SetAltitude( m_pCalibMetadata->GetAltitude() );
-
-      // Detector settings
-      //-------------------
-      m_pFrame->SetPolarity(m_pCalibMetadata->GetPolarity());
-      m_pFrame->SetHV(      m_pCalibMetadata->GetHV());
-      Bool_t dacsset = m_pFrame->SetDACs(m_pCalibMetadata->GetDACs());
-      m_pFrame->SetMpxClock(m_pCalibMetadata->GetMpxClock());
-      m_pFrame->SetTpxClock(m_pCalibMetadata->GetTpxClock());
-      m_pFrame->SetBsActive(m_pCalibMetadata->GetBsActive());
-
-      // Detector information
-      //----------------------
-      m_pFrame->SetChipboardID(m_pCalibMetadata->GetChipboardID());
-      m_pFrame->SetCustomName( m_pCalibMetadata->GetCustomName() );
-      m_pFrame->SetFirmware(   m_pCalibMetadata->GetFirmware()   );
-      m_pFrame->SetInterface(  m_pCalibMetadata->GetInterface()  );
-      m_pFrame->SetMpxType(    m_pCalibMetadata->GetMpxType()    );
-      m_pFrame->SetAppFilters( m_pCalibMetadata->GetAppFilters() );
-      //
-      m_pFrame->SetDet_x(  m_pCalibMetadata->GetDet_x()  );
-      m_pFrame->SetDet_y(  m_pCalibMetadata->GetDet_y()  );
-      m_pFrame->SetDet_z(  m_pCalibMetadata->GetDet_z()  );
-      m_pFrame->SetOmega_x(m_pCalibMetadata->GetOmega_x());
-      m_pFrame->SetOmega_y(m_pCalibMetadata->GetOmega_y());
-      m_pFrame->SetOmega_z(m_pCalibMetadata->GetOmega_z());
-      m_pFrame->SetRoll(   m_pCalibMetadata->GetRoll()   );
-      m_pFrame->SetPitch(  m_pCalibMetadata->GetPitch()  );
-      m_pFrame->SetYaw(    m_pCalibMetadata->GetYaw()    );
-
-      // Source information
-      //--------------------
-      m_pFrame->SetSourceId(m_pCalibMetadata->GetSourceId());
-      // [No primary vertex information required - real data.]
-
-      // Fill the tree with the frame information.
-      m_pNt->cd();
-      m_pTr->Fill();
+      // Set the frame metadata and summary statistics.
+      completeFrame(m_pFrame, clusters_in_frame);
 
       // Run the cluster validation
       //----------------------------
-      m_bf = new BlobFinder(m_pFrame->GetPixelCounts(),
-                            m_pFrame->GetFrameWidth(),
-                            m_pFrame->GetFrameHeight());
-
-      // Plot the number of pixels per frame (extracted).
-      m_hg_nPixelsPf_ex->Fill(pixels_in_frame);
-
-      // Plot the number of pixels per frame (frame container).
-      m_hg_nPixelsPf_fc->Fill(m_pFrame->GetPixelCounts().size() + 0.5);
-
-      // Plot the number of clusters per frame.
-      m_hg_nClustersPf_bf->Fill(m_bf->getSize() + 0.5);
-      //cout << "DEBUG: * Blobs in the BlobFinder = " << m_bf->getSize() << endl;
-
-      //total_blanks++;
-      //if (clusters_in_frame>0) hg_nc->Fill(double(clusters_in_frame));
-      m_hg_nClustersPf_ex->Fill(clusters_in_frame);
+      // (Before the frame is written, as an asynchronous writer takes
+      // the pixel data out of the frame container.)
+      checkClusters(m_pFrame, pixels_in_frame, clusters_in_frame,
+                    m_pValidator, &m_counters, dbg);
 
       clusters_in_frame = 0;
 
+      // Fill the tree with the frame information
+      // (and publish it to any live monitors).
+      m_pOutput->fillFrame(*m_pFrame);
+
       // Flush out the frame information.
       m_pFrame->ResetCountersPad();
       m_pFrame->CleanUpMatrix();
@@ -415,11 +348,8 @@ Bool_t Cl2MfConverter::processNextFrame(Bool_t dbg) {
       // Increment the cluster counter.
       clusters_in_frame++;
 
-      // Increment the cluster histogram counter.
-      m_hg_nClusters_ex->Fill(0.5);
-
       // Process the cluster.
-      pixels_in_frame += processCluster(line, dbg);
+      pixels_in_frame += processCluster(line, clusters_in_frame, dbg);
 
       //total_clusters++;
 
@@ -435,66 +365,427 @@ Bool_t Cl2MfConverter::processNextFrame(Bool_t dbg) {
 }//end of Cl2MfConverter::processNextFrame method.
 
 //
-// processCluster method.
+// processParallel method
 //
-Int_t Cl2MfConverter::processCluster(string clusterline, Bool_t dbg) {
+void Cl2MfConverter::processParallel(TString datasetpath, Int_t num_frames_to_read, Bool_t dbg) {
+
+  int fd = open(datasetpath.Data(), O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    cout << "ERROR: unable to open '" << datasetpath << "'" << endl;
+    if (fd >= 0) close(fd);
+    return;
+  }
 
-  // Count the pixels in the line.
-  Int_t n_px = count(clusterline.begin(), clusterline.end(), '[');
+  off_t size   = st.st_size;
+  off_t page   = sysconf(_SC_PAGESIZE);
+  off_t window = (off_t)m_options.readWindowMB << 20;
+  Int_t nthreads = m_options.readThreads;
 
-  // Fill the pixels per cluster histogram.
-  m_hg_ppc_ex->Fill(double(n_px));
+  cout << "INFO: parsing the cluster log file on " << nthreads << " threads." << endl;
 
-  //if (dbg) {
-  //  cout
-  //    << "DEBUG: Cluster line = '" << clusterline << "'" << endl
-  //    << "DEBUG: Number of pixels = " << n_px << endl;
-  //}
+  TString dataset = m_pCalibMetadata->GetMPXDataSetNumber();
 
-  // Loop over the clusters.
-  Int_t sb_l = clusterline.find_first_of('[');
-  Int_t sb_r = clusterline.find_first_of(']');
-  for (Int_t i=0; i<n_px; i++) {
+  off_t pos = 0;
+  Bool_t done = false;
 
-    string cl = clusterline.substr(sb_l+1, sb_r-1);
+  // Map the next window and start parsing it (0 at the end of the file).
+  auto startWindow = [&]() -> ParseWindow * {
 
-    //cout << "DEBUG: " << cl << endl;
+    while (pos < size) {
 
-    Int_t c_1 = cl.find_first_of(',');
-    Int_t c_2 = cl.find_last_of(',');
-    Int_t cll = cl.length();
+      // Map the next window (mappings start on a page boundary).
+      off_t base = pos - pos % page;
+      off_t len  = pos - base + window;
+      if (base + len > size) len = size - base;
 
-    string xstr(cl.substr(0    ,c_1)); Int_t x = atoi(xstr.c_str());
-    string ystr(cl.substr(c_1+1,c_2)); Int_t y = atoi(ystr.c_str());
-    string Cstr(cl.substr(c_2+1,cll)); Int_t C = atoi(Cstr.c_str());
+      void * map = mmap(0, len, PROT_READ, MAP_PRIVATE, fd, base);
+      if (map == MAP_FAILED) {
+        cout << "ERROR: unable to map '" << datasetpath << "'" << endl;
+        return 0;
+      }
+      madvise(map, len, MADV_SEQUENTIAL);
+
+      const char * begin = (const char *)map + (pos - base);
+      const char * end   = (const char *)map + len;
+
+      // Only the frames that end in the window are parsed.
+      const char * stop = end;
+      if (base + len < size) {
+        stop = lastFrameStart(begin, end);
+        if (!stop) {
+          // A frame bigger than the window.
+          munmap(map, len);
+          window *= 2;
+          if (dbg) cout << "DEBUG: read window increased to " << (window >> 20) << " MB." << endl;
+          continue;
+        }
+      }
 
-    //cout << "DEBUG: (x,y,C) = ("<<x<<", "<<y<<", "<<C<<")"<<endl;
-    
-    // Write the pixel information to frame.
-    this->m_pFrame->FillOneElement(x, y, m_pCalibMetadata->GetFrameWidth(), C);
+      // Split the window at frame boundaries, one part per thread.
+      vector<const char *> cuts(1, begin);
+      for (Int_t t = 1; t < nthreads; ++t) {
+        const char * cut = nextFrameStart(begin + (stop - begin)*t/nthreads, stop);
+        if (cut > cuts.back() && cut < stop) cuts.push_back(cut);
+      }
+      cuts.push_back(stop);
+
+      ParseWindow * w = new ParseWindow;
+      w->map = map;
+      w->len = len;
+      w->counters.resize(cuts.size() - 1);
+      for (UInt_t c = 0; c + 1 < cuts.size(); ++c) {
+        w->queues.push_back(new FrameQueue(kFramesPerPart, dataset));
+      }
+      for (UInt_t c = 0; c + 1 < cuts.size(); ++c) {
+        w->workers.push_back(thread(&Cl2MfConverter::parseChunk, this, cuts[c], cuts[c+1],
+                                    num_frames_to_read, w->queues[c], &w->counters[c]));
+      }
+
+      pos += stop - begin;
+      return w;
+    }
+
+    return 0;
+  };
+
+  ParseWindow * current = startWindow();
+
+  while (current) {
+
+    ParseWindow * next = 0;
+
+    // Check and write the frames in file order, as they are parsed.
+    for (UInt_t c = 0; c < current->queues.size(); ++c) {
+
+      // Start on the next window while the last part of this one is written.
+      if (c + 1 == current->queues.size() && !done) next = startWindow();
+
+      FrameQueue * queue = current->queues[c];
+      FrameStruct * frame = 0;
+      while ((frame = queue->GetFull())) {
+
+        if (!done) {
+
+          if (m_currentFrameNumber != frame->GetFrameId()) {
+            cout << "ERROR: Frame number mismatch:" << endl;
+            cout << "ERROR: frame_number = "    << m_currentFrameNumber << endl;
+            cout << "ERROR: f_num_from_file = " << frame->GetFrameId()  << endl;
+            exit(0);
+          }
+
+          // Store the start and end times for the validation file.
+          Double_t starttime = frame->GetStartTime();
+          if (m_currentFrameNumber==1) m_phg_times->SetBinContent(1,starttime);
+          m_phg_times->SetBinContent(2,starttime+frame->GetAcqTime());
+
+          // Fill the tree with the frame information
+          // (and publish it to any live monitors).
+          m_pOutput->fillFrame(*frame);
 
-    // Remove the extracted cluster from the string.
-    //cout << "clusterline before extraction = " << clusterline << endl;
-    clusterline.replace(sb_l, sb_r+2, "");
-    //cout << "clusterline after extraction  = " << clusterline << endl;
-    sb_l = clusterline.find_first_of('[');
-    sb_r = clusterline.find_first_of(']');
+          if (m_currentFrameNumber==num_frames_to_read) done = true;
+          m_currentFrameNumber++;
+        }
 
-  }//end of loop over the clusters.
+        // Hand the buffer back to the parsing thread.
+        queue->PutFree(frame);
+      }
+
+    }
+
+    // The parts are all written; unmap the window.
+    for (UInt_t c = 0; c < current->workers.size(); ++c) {
+      current->workers[c].join();
+      m_counters.Merge(current->counters[c]);
+      delete current->queues[c];
+    }
+    munmap(current->map, current->len);
+    delete current;
+
+    current = next;
+
+  }//end of loop over the windows.
+
+  close(fd);
+
+}//end of processParallel method.
+
+//
+// parseChunk method
+//
+void Cl2MfConverter::parseChunk(const char * begin, const char * end, Int_t num_frames_to_read,
+                                FrameQueue * frames, ValidationCounters * counters) {
+
+  Int_t width = m_pCalibMetadata->GetFrameWidth();
+  ClusterValidator validator(width, m_pCalibMetadata->GetFrameHeight());
+
+  FrameStruct * frame = 0;
+  Long_t pixels_in_frame(0);
+  Long_t clusters_in_frame(0);
+
+  // Start a frame in the next free buffer (waiting for the writer if
+  // it is behind).
+  auto start = [&]() {
+    frame = frames->GetFree();
+    frame->ResetCountersPad();
+    frame->CleanUpMatrix();
+  };
+
+  // Finish the frame being read.
+  auto finish = [&]() {
+    completeFrame(frame, clusters_in_frame);
+    checkClusters(frame, pixels_in_frame, clusters_in_frame,
+                  &validator, counters);
+    frames->PutFull(frame);
+    frame = 0;
+    pixels_in_frame = 0;
+    clusters_in_frame = 0;
+  };
+
+  const char * p = begin;
+  while (p < end) {
+
+    const char * nl = (const char *)memchr(p, '\n', end - p);
+    const char * le = nl ? nl : end;
+
+    if (ClusterLogParser::IsBlank(p, le)) {
+      counters->AddLine();
+      counters->AddBlank();
+      if (frame) finish();
+    } else if (ClusterLogParser::IsHeader(p, le)) {
+      Int_t    f_num_from_file = 0;
+      Double_t starttime = 0., acqtime = 0.;
+      ClusterLogParser::ParseHeader(p, le, f_num_from_file, starttime, acqtime);
+
+      // Stop after the last frame wanted (the frame numbers are checked
+      // to run on from 1 as the frames are written).
+      if (num_frames_to_read > 0 && f_num_from_file > num_frames_to_read) break;
+
+      counters->AddLine();
+      counters->AddHeader();
+      if (!frame) start();
+      Utils::TimeHandler t(starttime);
+      frame->SetId(f_num_from_file);
+      frame->SetStartTime(starttime);
+      frame->SetStartTimeS(t.GetPixelmanTime());
+      frame->SetAcqTime(acqtime);
+    } else {
+      counters->AddLine();
+      if (!frame) start();
+      FrameStruct * f = frame;
+      ClusterValidator * v = &validator;
+      Int_t id = ++clusters_in_frame;
+      v->BeginCluster();
+      Int_t n_px = ClusterLogParser::ParseCluster(p, le,
+        [f, v, width, id](Int_t x, Int_t y, Int_t C) {
+          f->FillOneElement(x, y, width, C);
+          f->SetClusterId(x, y, width, id);
+          v->AddPixel(x, y);
+        });
+      counters->AddCluster(n_px);
+      pixels_in_frame += n_px;
+    }
+
+    p = le + 1;
+
+  }//end of loop over the lines.
+
+  // The last frame of the file needn't end with a blank line (the
+  // line-by-line reader counts the end of the file as one).
+  if (frame) {
+    counters->AddLine();
+    counters->AddBlank();
+    finish();
+  }
+
+  frames->Close();
+
+}//end of parseChunk method.
+
+//
+// completeFrame method
+//
+void Cl2MfConverter::completeFrame(FrameStruct * frame, Long_t clusters_in_frame) {
+
+  // Payload 
+  //---------
+  // [Pixel counts added in the cluster processing.]
+  // [No Level 1 trigger.]
+  // [No energy information.]
+  // [No truth energy information.]
+
+  // Add the whole-frame data.
+  // [Hit pixel counter incremented in the cluster processing.]
+  // [Hit counter incremented in the cluster processing.]
+  // [Charge counter incremented in the cluster processing.]
+  frame->SetFrameAsData();
+
+  // Payload information
+  //---------------------
+  frame->SetnX(m_pCalibMetadata->GetFrameWidth());
+  frame->SetnY(m_pCalibMetadata->GetFrameHeight());
+  frame->SetPayloadFormat(m_pCalibMetadata->GetPayloadFormat());
+  // [Frame ID set from the frame number in the file.]
+  frame->SetDataSet(m_pCalibMetadata->GetMPXDataSetNumber());
+  frame->SetNClusters(clusters_in_frame);
+  frame->CalculateDoseRates();
+
+  // Acquisition information
+  //-------------------------
+  frame->SetAcqMode(m_pCalibMetadata->GetAcqMode());
+  frame->SetCounters(m_pCalibMetadata->GetCounters());
+  frame->SetHwTimerMode(m_pCalibMetadata->GetHwTimerMode());
+  frame->SetAutoEraseInterval(m_pCalibMetadata->GetAutoEraseInterval());
+  frame->SetAutoEraseIntervalCounter(
+    m_pCalibMetadata->GetAutoEraseIntervalCounter());
+  frame->SetLastTriggerTime(m_pCalibMetadata->GetLastTriggerTime());
+  frame->SetCoincidenceMode(m_pCalibMetadata->GetCoincidenceMode());
+  frame->SetCoincidenceDelayTime(m_pCalibMetadata->GetCoincidenceDelayTime());
+  frame->SetCoincidenceLiveTime(m_pCalibMetadata->GetCoincidenceLiveTime());
+  frame->SetPixelmanVersion(m_pCalibMetadata->GetPixelmanVersion());
+
+  // Geospatial information
+  //------------------------
+  frame->SetLatitude( m_pCalibMetadata->GetLatitude() );
+  frame->SetLongitude(m_pCalibMetadata->GetLongitude());
+  frame->SetAltitude( m_pCalibMetadata->GetAltitude() );
+
+  // Detector settings
+  //-------------------
+  frame->SetPolarity(m_pCalibMetadata->GetPolarity());
+  frame->SetHV(      m_pCalibMetadata->GetHV());
+  Bool_t dacsset = frame->SetDACs(m_pCalibMetadata->GetDACs());
+  frame->SetMpxClock(m_pCalibMetadata->GetMpxClock());
+  frame->SetTpxClock(m_pCalibMetadata->GetTpxClock());
+  frame->SetBsActive(m_pCalibMetadata->GetBsActive());
+
+  // Detector information
+  //----------------------
+  frame->SetChipboardID(m_pCalibMetadata->GetChipboardID());
+  frame->SetCustomName( m_pCalibMetadata->GetCustomName() );
+  frame->SetFirmware(   m_pCalibMetadata->GetFirmware()   );
+  frame->SetInterface(  m_pCalibMetadata->GetInterface()  );
+  frame->SetMpxType(    m_pCalibMetadata->GetMpxType()    );
+  frame->SetAppFilters( m_pCalibMetadata->GetAppFilters() );
+  //
+  frame->SetDet_x(  m_pCalibMetadata->GetDet_x()  );
+  frame->SetDet_y(  m_pCalibMetadata->GetDet_y()  );
+  frame->SetDet_z(  m_pCalibMetadata->GetDet_z()  );
+  frame->SetOmega_x(m_pCalibMetadata->GetOmega_x());
+  frame->SetOmega_y(m_pCalibMetadata->GetOmega_y());
+  frame->SetOmega_z(m_pCalibMetadata->GetOmega_z());
+  frame->SetRoll(   m_pCalibMetadata->GetRoll()   );
+  frame->SetPitch(  m_pCalibMetadata->GetPitch()  );
+  frame->SetYaw(    m_pCalibMetadata->GetYaw()    );
+
+  // Source information
+  //--------------------
+  frame->SetSourceId(m_pCalibMetadata->GetSourceId());
+  // [No primary vertex information required - real data.]
+
+}//end of completeFrame method.
+
+//
+// checkClusters method
+//
+void Cl2MfConverter::checkClusters(FrameStruct * frame, Long_t pixels_in_frame,
+                                   Long_t clusters_in_frame,
+                                   ClusterValidator * validator,
+                                   ValidationCounters * counters,
+                                   Bool_t dbg) {
+
+  // Check the clusters from the file: the pixels are in the frame,
+  // given once, and grouped as the BlobFinder would group them.
+  Bool_t valid = validator->EndFrame();
+
+  counters->AddProblems(validator->GetNOutside(), validator->GetNDuplicates(),
+                        validator->GetNSplit(),   validator->GetNTouching());
+
+  // Count the pixels per frame (extracted and in the frame container)
+  // and the clusters per frame (extracted and groups of touching pixels).
+  counters->AddFrame(pixels_in_frame,
+                     frame->GetPixelCounts().size(),
+                     clusters_in_frame,
+                     validator->GetNGroups());
+
+  if (dbg && !valid) {
+    cout
+      << "DEBUG: Invalid clusters in frame " << frame->GetFrameId() << ":" << endl
+      << "DEBUG: * Pixels outside of the frame = " << validator->GetNOutside()    << endl
+      << "DEBUG: * Pixels given more than once = " << validator->GetNDuplicates() << endl
+      << "DEBUG: * Clusters split              = " << validator->GetNSplit()      << endl
+      << "DEBUG: * Clusters touching           = " << validator->GetNTouching()   << endl;
+  }
+
+  // Re-cluster a sample of the frames as a cross-check.
+  Int_t every = m_options.blobFinderEvery;
+  if (every > 0 && frame->GetFrameId() % every == 0) {
+    BlobFinder bf(frame->GetPixelCounts(),
+                  frame->GetFrameWidth(),
+                  frame->GetFrameHeight());
+    counters->AddBlobFinderCheck(bf.getSize() == clusters_in_frame);
+    if (dbg) {
+      cout << "DEBUG: * Blobs in the BlobFinder = " << bf.getSize() << endl;
+    }
+  }
+
+}//end of checkClusters method.
+
+//
+// processCluster method.
+//
+Int_t Cl2MfConverter::processCluster(string const & clusterline, Int_t cluster, Bool_t dbg) {
+
+  FrameStruct * frame = m_pFrame;
+  ClusterValidator * validator = m_pValidator;
+  Int_t width = m_pCalibMetadata->GetFrameWidth();
+
+  // Write each pixel and its cluster to the frame (and the validator)
+  // as it is read.
+  validator->BeginCluster();
+  Int_t n_px = ClusterLogParser::ParseCluster(
+    clusterline.data(), clusterline.data() + clusterline.size(),
+    [frame, validator, width, cluster](Int_t x, Int_t y, Int_t C) {
+      frame->FillOneElement(x, y, width, C);
+      frame->SetClusterId(x, y, width, cluster);
+      validator->AddPixel(x, y);
+    });
+
+  // Count the cluster and its pixels.
+  m_counters.AddCluster(n_px);
 
   return n_px;
 
 }//end of processCluster method.
 
+//
+// openNtuple
+//
+void Cl2MfConverter::openNtuple(Int_t frames_per_root_file) {
+
+  // The files are named from the data set and file number.
+  m_pOutput = new OutputManager(m_pCalibMetadata->GetMPXDataSetNumber(),
+                                m_outputDir,
+                                m_options,
+                                m_currentNtupleFileNum,
+                                frames_per_root_file);
+  m_pOutput->SetFrameRing(m_pRing);
+
+}//end of openNtuple method.
+
 //
 // closeNtuple
 //
 void Cl2MfConverter::closeNtuple() {
 
-  // Write the TTree contents.
-  m_pTr->Write();
+  // Write the TTree contents and close the ntuple files.
+  m_pOutput->Close();
+
+  // Keep the name of the last file.
+  m_currentNtupleFileName.str("");
+  m_currentNtupleFileName << m_pOutput->GetCurrentFileName();
 
-  // Close the ntuple file.
-  m_pNt->Close();
+  delete m_pOutput;
+  m_pOutput = 0;
 
 }//end of closeNtuple method.
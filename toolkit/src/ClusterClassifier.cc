@@ -0,0 +1,367 @@
+/// @file ClusterClassifier.cc
+/// @brief Implementation of the ClusterClassifier class.
+
+// Standard include statements.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <stdlib.h>
+
+// Local include statements.
+#include "ClusterClassifier.h"
+#include "ClusterProperties.h"
+
+namespace {
+
+  /// @brief The variable names, in the order of ClusterClassifier::Variable.
+  const char * const kVariableNames[ClusterClassifier::kNVariables] = {
+    "size", "totalToT", "maxToT", "width", "height", "radiusU", "densityU", "linearity"
+  };
+
+  /// @brief A value with no limit.
+  const Double_t kNoLimit = 1e300;
+
+  /// @brief Read a limit from a cut table ("*" for none).
+  ///
+  /// @param [in] word The limit as written.
+  /// @param [in] none The value meaning no limit.
+  /// @param [out] value The limit.
+  /// @return Was it a number (or "*")?
+  Bool_t readLimit(string const & word, Double_t none, Double_t & value) {
+    if (word == "*") {
+      value = none;
+      return true;
+    }
+    char * end;
+    value = strtod(word.c_str(), &end);
+    return end != word.c_str() && *end == '\0';
+  }
+
+}
+
+//
+// ClusterClassifier::GetVariableName
+//
+const char * ClusterClassifier::GetVariableName(Int_t v) {
+
+  if (v < 0 || v >= kNVariables) return "";
+
+  return kVariableNames[v];
+
+}//end of ClusterClassifier::GetVariableName method.
+
+//
+// ClusterClassifier::FindVariable
+//
+Int_t ClusterClassifier::FindVariable(TString name) {
+
+  for (Int_t v = 0; v < kNVariables; ++v) {
+    if (name.EqualTo(kVariableNames[v], TString::kIgnoreCase)) return v;
+  }
+
+  // The name of the radius in rate-plotter.py.
+  if (name == "r_u") return kRadiusU;
+
+  return -1;
+
+}//end of ClusterClassifier::FindVariable method.
+
+//
+// ClusterClassifier constructor
+//
+ClusterClassifier::ClusterClassifier() {
+
+  SetDefaultTable();
+
+}//end of ClusterClassifier constructor.
+
+//
+// ClusterClassifier destructor
+//
+ClusterClassifier::~ClusterClassifier() {}
+
+//
+// ClusterClassifier::Clear
+//
+void ClusterClassifier::Clear() {
+
+  m_classNames.clear();
+  m_cutOffsets.assign(1, 0);
+  m_cuts.clear();
+  m_groupNames.clear();
+  m_groups.clear();
+
+}//end of ClusterClassifier::Clear method.
+
+//
+// ClusterClassifier::SetDefaultTable
+//
+void ClusterClassifier::SetDefaultTable() {
+
+  Clear();
+
+  // The classes of rate-plotter.py: three- and four-pixel clusters are
+  // gamma candidates if they are compact, beta candidates otherwise.
+  AddClass("g1"); AddCut(kSize, 1, 2);
+  AddClass("g2"); AddCut(kSize, 2, 3);
+  AddClass("g3"); AddCut(kSize, 3, 4); AddCut(kRadiusU, -kNoLimit, 0.75);
+  AddClass("b3"); AddCut(kSize, 3, 4);
+  AddClass("g4"); AddCut(kSize, 4, 5); AddCut(kRadiusU, -kNoLimit, 0.71);
+  AddClass("b4"); AddCut(kSize, 4, 5);
+  AddClass("lc"); AddCut(kSize, 5, kNoLimit);
+
+  vector<TString> g, bs, nongam;
+  g.push_back("g1"); g.push_back("g2"); g.push_back("g3"); g.push_back("g4");
+  bs.push_back("b3"); bs.push_back("b4");
+  nongam.push_back("b3"); nongam.push_back("b4"); nongam.push_back("lc");
+  AddGroup("g", g);
+  AddGroup("bs", bs);
+  AddGroup("nongam", nongam);
+
+}//end of ClusterClassifier::SetDefaultTable method.
+
+//
+// ClusterClassifier::ReadCutTable
+//
+Bool_t ClusterClassifier::ReadCutTable(TString path) {
+
+  Clear();
+
+  ifstream tablefile(path.Data());
+  if (!tablefile) {
+    cout << "ERROR: unable to open the cut table '" << path << "'" << endl;
+    return false;
+  }
+
+  Bool_t ok = true;
+  string line;
+  Int_t lineNum = 0;
+
+  while (getline(tablefile, line)) {
+
+    ++lineNum;
+
+    // Remove any comment.
+    size_t hash = line.find('#');
+    if (hash != string::npos) line.erase(hash);
+
+    istringstream words(line);
+    string kind, name;
+    if (!(words >> kind)) continue;
+
+    if (!(words >> name)) {
+      cout << "ERROR: no name on line " << lineNum << " of '" << path << "'" << endl;
+      ok = false;
+      continue;
+    }
+
+    if (kind == "class") {
+
+      if (FindClass(name.c_str()) >= 0) {
+        cout << "ERROR: class '" << name << "' is defined again on line "
+             << lineNum << " of '" << path << "'" << endl;
+        ok = false;
+      }
+      AddClass(name.c_str());
+
+      string var, lo, hi;
+      while (words >> var) {
+        Int_t v = FindVariable(var.c_str());
+        Double_t lov = 0., hiv = 0.;
+        if (v < 0) {
+          cout << "ERROR: unknown variable '" << var << "' on line "
+               << lineNum << " of '" << path << "'" << endl;
+          ok = false;
+          break;
+        }
+        if (!(words >> lo >> hi) ||
+            !readLimit(lo, -kNoLimit, lov) || !readLimit(hi, kNoLimit, hiv)) {
+          cout << "ERROR: the cut on '" << var << "' needs two limits on line "
+               << lineNum << " of '" << path << "'" << endl;
+          ok = false;
+          break;
+        }
+        AddCut(v, lov, hiv);
+      }
+
+    } else if (kind == "group") {
+
+      vector<TString> classes;
+      string c;
+      while (words >> c) classes.push_back(c.c_str());
+      if (!AddGroup(name.c_str(), classes)) {
+        cout << "ERROR: unknown class in group '" << name << "' on line "
+             << lineNum << " of '" << path << "'" << endl;
+        ok = false;
+      }
+
+    } else {
+      cout << "ERROR: expected 'class' or 'group' on line "
+           << lineNum << " of '" << path << "'" << endl;
+      ok = false;
+    }
+
+  }//end of loop over the lines.
+
+  if (ok && m_classNames.empty()) {
+    cout << "ERROR: no classes in the cut table '" << path << "'" << endl;
+    ok = false;
+  }
+
+  if (!ok) Clear();
+
+  return ok;
+
+}//end of ClusterClassifier::ReadCutTable method.
+
+//
+// ClusterClassifier::AddClass
+//
+Int_t ClusterClassifier::AddClass(TString name) {
+
+  m_classNames.push_back(name);
+  m_cutOffsets.push_back(m_cuts.size());
+
+  return m_classNames.size() - 1;
+
+}//end of ClusterClassifier::AddClass method.
+
+//
+// ClusterClassifier::AddCut
+//
+void ClusterClassifier::AddCut(Int_t v, Double_t lo, Double_t hi) {
+
+  if (m_classNames.empty()) {
+    cout << "ERROR: a cut on '" << GetVariableName(v) << "' added before any class." << endl;
+    return;
+  }
+
+  Cut cut;
+  cut.v  = v;
+  cut.lo = lo;
+  cut.hi = hi;
+  m_cuts.push_back(cut);
+  m_cutOffsets.back() = m_cuts.size();
+
+}//end of ClusterClassifier::AddCut method.
+
+//
+// ClusterClassifier::AddGroup
+//
+Bool_t ClusterClassifier::AddGroup(TString name, vector<TString> const & classes) {
+
+  vector<Int_t> members;
+  for (UInt_t i = 0; i < classes.size(); ++i) {
+    Int_t c = FindClass(classes[i]);
+    if (c < 0) return false;
+    members.push_back(c);
+  }
+
+  m_groupNames.push_back(name);
+  m_groups.push_back(members);
+
+  return true;
+
+}//end of ClusterClassifier::AddGroup method.
+
+//
+// ClusterClassifier::FindClass
+//
+Int_t ClusterClassifier::FindClass(TString name) const {
+
+  for (UInt_t c = 0; c < m_classNames.size(); ++c) {
+    if (m_classNames[c] == name) return c;
+  }
+
+  return -1;
+
+}//end of ClusterClassifier::FindClass method.
+
+//
+// ClusterClassifier::Classify
+//
+void ClusterClassifier::Classify(ClusterProperties const & properties, UInt_t frame,
+                                 Int_t * labels, Int_t * counts) const {
+
+  Int_t nclasses = m_classNames.size();
+  for (Int_t i = 0; i < GetNCounts(); ++i) counts[i] = 0;
+
+  UInt_t b = properties.GetFrameBegin(frame), e = properties.GetFrameEnd(frame);
+  if (b == e) return;
+
+  Int_t    const * size   = &properties.GetSize()[0];
+  Int_t    const * tot    = &properties.GetTotalToT()[0];
+  Int_t    const * maxtot = &properties.GetMaxToT()[0];
+  Int_t    const * xmin   = &properties.GetXMin()[0];
+  Int_t    const * xmax   = &properties.GetXMax()[0];
+  Int_t    const * ymin   = &properties.GetYMin()[0];
+  Int_t    const * ymax   = &properties.GetYMax()[0];
+  Double_t const * r      = &properties.GetRadiusU()[0];
+  Double_t const * dens   = &properties.GetDensityU()[0];
+  Double_t const * lin    = &properties.GetLinearity()[0];
+
+  Cut const * cuts = m_cuts.empty() ? 0 : &m_cuts[0];
+  Double_t values[kNVariables];
+
+  for (UInt_t k = b; k < e; ++k) {
+
+    values[kSize]      = size[k];
+    values[kTotalToT]  = tot[k];
+    values[kMaxToT]    = maxtot[k];
+    values[kWidth]     = xmax[k] - xmin[k] + 1;
+    values[kHeight]    = ymax[k] - ymin[k] + 1;
+    values[kRadiusU]   = r[k];
+    values[kDensityU]  = dens[k];
+    values[kLinearity] = lin[k];
+
+    // The first class whose cuts are all passed.
+    Int_t label = -1;
+    for (Int_t c = 0; c < nclasses && label < 0; ++c) {
+      UInt_t i = m_cutOffsets[c], end = m_cutOffsets[c+1];
+      for (; i < end; ++i) {
+        Double_t value = values[cuts[i].v];
+        if (value < cuts[i].lo || value >= cuts[i].hi) break;
+      }
+      if (i == end) label = c;
+    }
+
+    labels[k - b] = label;
+    if (label >= 0) ++counts[label];
+
+  }//end of loop over the clusters.
+
+  for (UInt_t g = 0; g < m_groups.size(); ++g) {
+    Int_t n = 0;
+    for (UInt_t i = 0; i < m_groups[g].size(); ++i) n += counts[m_groups[g][i]];
+    counts[nclasses + g] = n;
+  }
+
+}//end of ClusterClassifier::Classify method.
+
+//
+// ClusterClassifier::Print
+//
+void ClusterClassifier::Print() const {
+
+  for (UInt_t c = 0; c < m_classNames.size(); ++c) {
+    cout << "*   class " << m_classNames[c] << ":";
+    for (UInt_t i = m_cutOffsets[c]; i < m_cutOffsets[c+1]; ++i) {
+      Cut const & cut = m_cuts[i];
+      cout << (i > m_cutOffsets[c] ? ", " : " ");
+      if (cut.lo > -kNoLimit) cout << cut.lo << " <= ";
+      cout << GetVariableName(cut.v);
+      if (cut.hi < kNoLimit) cout << " < " << cut.hi;
+    }
+    cout << endl;
+  }
+
+  for (UInt_t g = 0; g < m_groupNames.size(); ++g) {
+    cout << "*   group " << m_groupNames[g] << ":";
+    for (UInt_t i = 0; i < m_groups[g].size(); ++i) {
+      cout << " " << m_classNames[m_groups[g][i]];
+    }
+    cout << endl;
+  }
+
+}//end of ClusterClassifier::Print method.
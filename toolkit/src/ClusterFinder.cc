@@ -0,0 +1,320 @@
+/// @file ClusterFinder.cc
+/// @brief Implementation of the ClusterFinder class.
+
+// Standard include statements.
+#include <algorithm>
+
+// Local include statements.
+#include "ClusterFinder.h"
+
+namespace {
+
+  /// @brief Get the position of the lowest set bit of a (non-zero) word.
+  inline Int_t lowestBit(ULong64_t w) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(w);
+#else
+    Int_t b = 0;
+    while (!(w & 1)) { w >>= 1; ++b; }
+    return b;
+#endif
+  }
+
+}
+
+//
+// ClusterFinder constructor
+//
+ClusterFinder::ClusterFinder(Int_t width, Int_t height)
+:
+  m_width(width),
+  m_height(height),
+  m_grid(width > 0 && height > 0 ? width*height : 0, 0),
+  m_words(width > 0 ? (width + 63)/64 : 0),
+  m_mask(width > 0 && height > 0 ? m_words*height : 0, 0),
+  m_denseMin(0),
+  m_offsets(1, 0),
+  m_nClusters(0)
+{
+  SetDenseOccupancy(1./8);
+}
+
+//
+// ClusterFinder::SetDenseOccupancy
+//
+void ClusterFinder::SetDenseOccupancy(Double_t occupancy) {
+
+  Double_t pixels = m_grid.size();
+
+  if (pixels == 0 || occupancy > 1.) m_denseMin = kMaxUInt;
+  else m_denseMin = (UInt_t)(occupancy*pixels);
+
+}//end of ClusterFinder::SetDenseOccupancy method.
+
+//
+// ClusterFinder::Find (pixel map)
+//
+UInt_t ClusterFinder::Find(map<int,int> const & pixels) {
+
+  m_X.resize(pixels.size());
+
+  UInt_t i = 0;
+  map<int,int>::const_iterator it;
+  for (it = pixels.begin(); it != pixels.end(); ++it) m_X[i++] = it->first;
+
+  return Find(m_X.empty() ? 0 : &m_X[0], m_X.size());
+
+}//end of ClusterFinder::Find (pixel map) method.
+
+//
+// ClusterFinder::Find
+//
+UInt_t ClusterFinder::Find(Int_t const * X, UInt_t n) {
+
+  Bool_t sorted = kFALSE;
+  if (n >= m_denseMin) sorted = findDense(X, n);
+  else                 findSparse(X, n);
+
+  if (!sorted) sortPixels(n);
+
+  return m_nClusters;
+
+}//end of ClusterFinder::Find method.
+
+//
+// ClusterFinder::findSparse
+//
+void ClusterFinder::findSparse(Int_t const * X, UInt_t n) {
+
+  Int_t size = m_grid.size();
+
+  m_parent.resize(n);
+  m_labels.resize(n);
+
+  // Put the pixels on the grid.
+  for (UInt_t i = 0; i < n; ++i) {
+    m_parent[i] = i;
+    if (X[i] >= 0 && X[i] < size) m_grid[X[i]] = i + 1;
+  }
+
+  // Join each pixel to its neighbours. Looking to the left and at the
+  // three pixels of the row before covers each pair once.
+  for (UInt_t i = 0; i < n; ++i) {
+    Int_t Xi = X[i];
+    if (Xi < 0 || Xi >= size) continue;
+    Int_t x = Xi % m_width;
+    if (x > 0 && m_grid[Xi - 1]) join(i, m_grid[Xi - 1] - 1);
+    if (Xi < m_width) continue;
+    Int_t above = Xi - m_width;
+    if (x > 0 && m_grid[above - 1])           join(i, m_grid[above - 1] - 1);
+    if (m_grid[above])                        join(i, m_grid[above] - 1);
+    if (x < m_width - 1 && m_grid[above + 1]) join(i, m_grid[above + 1] - 1);
+  }
+
+  // Number the clusters in the order of their first pixel (each
+  // group's root).
+  m_nClusters = 0;
+  for (UInt_t i = 0; i < n; ++i) {
+    UInt_t r = find(i);
+    m_labels[i] = (r == i) ? m_nClusters++ : m_labels[r];
+  }
+
+  // Clear the grid.
+  for (UInt_t i = 0; i < n; ++i) {
+    if (X[i] >= 0 && X[i] < size) m_grid[X[i]] = 0;
+  }
+
+}//end of ClusterFinder::findSparse method.
+
+//
+// ClusterFinder::findDense
+//
+Bool_t ClusterFinder::findDense(Int_t const * X, UInt_t n) {
+
+  Int_t size = m_grid.size();
+
+  // Pixels sorted in X (e.g. from the pixel map) are the runs' pixels
+  // in order, with any outside of the frame before or after them.
+  Bool_t sorted = kTRUE;
+  for (UInt_t i = 1; i < n && sorted; ++i) sorted = X[i-1] < X[i];
+
+  // Set the hit mask, one bit per pixel, m_words words per row. Sorted
+  // pixels fill each word in turn, so it is built up before it is
+  // stored, and the rows are stepped through (saving a division).
+  if (sorted) {
+    Int_t y = 0, rowX = 0, word = -1;
+    ULong64_t bits = 0;
+    for (UInt_t i = 0; i < n; ++i) {
+      Int_t Xi = X[i];
+      if (Xi < 0 || Xi >= size) continue;
+      while (Xi >= rowX + m_width) { ++y; rowX += m_width; }
+      Int_t x = Xi - rowX, w = y*m_words + (x >> 6);
+      if (w != word) {
+        if (word >= 0) m_mask[word] = bits;
+        word = w;
+        bits = 0;
+      }
+      bits |= ULong64_t(1) << (x & 63);
+    }
+    if (word >= 0) m_mask[word] = bits;
+  } else {
+    for (UInt_t i = 0; i < n; ++i) {
+      Int_t Xi = X[i];
+      if (Xi < 0 || Xi >= size) continue;
+      Int_t y = Xi / m_width, x = Xi - y*m_width;
+      m_mask[y*m_words + (x >> 6)] |= ULong64_t(1) << (x & 63);
+    }
+  }
+
+  // Find the runs of each row. A run starts at a set bit whose left
+  // neighbour is clear and ends at a set bit whose right neighbour is
+  // clear, so a word gives all of its starts and ends at once. They
+  // come in order along the row, so each end closes the oldest open
+  // run. There are at most as many runs as pixels.
+  m_runStart.resize(n);
+  m_runEnd.resize(n);
+  m_rowRuns.resize(m_height + 1);
+  m_rowRuns[0] = 0;
+  UInt_t nruns = 0;
+  for (Int_t y = 0; y < m_height; ++y) {
+    ULong64_t const * row = &m_mask[y*m_words];
+    UInt_t close = nruns;
+    for (Int_t w = 0; w < m_words; ++w) {
+      ULong64_t bits  = row[w];
+      if (!bits) continue;
+      ULong64_t left  = w > 0           ? row[w-1] >> 63 : 0;
+      ULong64_t right = w < m_words - 1 ? row[w+1] << 63 : 0;
+      ULong64_t starts = bits & ~((bits << 1) | left);
+      ULong64_t ends   = bits & ~((bits >> 1) | right);
+      while (starts) {
+        m_runStart[nruns++] = 64*w + lowestBit(starts);
+        starts &= starts - 1;
+      }
+      while (ends) {
+        m_runEnd[close++] = 64*w + lowestBit(ends) + 1;
+        ends &= ends - 1;
+      }
+    }
+    m_rowRuns[y+1] = nruns;
+  }
+
+  // Join each run to the runs it touches (including diagonally) in the
+  // row before. Both rows' runs are in order, so one sweep finds them.
+  Int_t const * start = n > 0 ? &m_runStart[0] : 0;
+  Int_t const * end   = n > 0 ? &m_runEnd[0]   : 0;
+  m_parent.resize(nruns);
+  for (UInt_t r = 0; r < nruns; ++r) m_parent[r] = r;
+  for (Int_t y = 1; y < m_height; ++y) {
+    UInt_t a = m_rowRuns[y], aEnd = m_rowRuns[y+1];
+    UInt_t b = m_rowRuns[y-1], bEnd = m_rowRuns[y];
+    while (a < aEnd && b < bEnd) {
+      if (start[b] <= end[a] && end[b] >= start[a]) join(a, b);
+      if (end[a] < end[b]) ++a;
+      else ++b;
+    }
+  }
+
+  // Number the clusters in the order of their first pixel.
+  m_labels.resize(n);
+  m_runLabels.assign(nruns, kMaxUInt);
+  m_nClusters = 0;
+
+  if (sorted) {
+
+    // Label the pixels a run at a time, counting the clusters' pixels.
+    UInt_t before = 0;
+    while (before < n && X[before] < 0) ++before;
+    for (UInt_t i = 0; i < before; ++i) m_labels[i] = m_nClusters++;
+    m_offsets.assign(before + 1, 0);
+    UInt_t i = before;
+    for (UInt_t r = 0; r < nruns; ++r) {
+      UInt_t root = find(r), len = end[r] - start[r];
+      if (m_runLabels[root] == kMaxUInt) {
+        m_runLabels[root] = m_nClusters++;
+        m_offsets.push_back(0);
+      }
+      std::fill_n(m_labels.begin() + i, len, m_runLabels[root]);
+      m_offsets[m_runLabels[root] + 1] += len;
+      i += len;
+    }
+    for (; i < n; ++i) {
+      m_labels[i] = m_nClusters++;
+      m_offsets.push_back(1);
+    }
+    for (UInt_t c = 0; c < before; ++c) m_offsets[c+1] = 1;
+    for (UInt_t c = 0; c < m_nClusters; ++c) m_offsets[c+1] += m_offsets[c];
+
+    // Sort the pixels into their clusters a run at a time (the run
+    // labels are no longer needed, so they hold the next place in each
+    // cluster).
+    m_pixels.resize(n);
+    m_runLabels.resize(m_nClusters > nruns ? m_nClusters : nruns);
+    UInt_t * next = m_runLabels.empty() ? 0 : &m_runLabels[0];
+    for (UInt_t c = 0; c < m_nClusters; ++c) next[c] = m_offsets[c];
+    for (i = 0; i < before; ++i) m_pixels[next[m_labels[i]]++] = i;
+    for (UInt_t r = 0; r < nruns; ++r) {
+      UInt_t len = end[r] - start[r], c = m_labels[i];
+      for (UInt_t k = 0; k < len; ++k) m_pixels[next[c] + k] = i + k;
+      next[c] += len;
+      i += len;
+    }
+    for (; i < n; ++i) m_pixels[next[m_labels[i]]++] = i;
+
+    std::fill(m_mask.begin(), m_mask.end(), 0);
+    return kTRUE;
+  }
+
+  // Otherwise look up each pixel's run on the grid.
+  for (Int_t y = 0; y < m_height; ++y) {
+    for (UInt_t r = m_rowRuns[y]; r < m_rowRuns[y+1]; ++r) {
+      std::fill(m_grid.begin() + y*m_width + m_runStart[r],
+                m_grid.begin() + y*m_width + m_runEnd[r], r + 1);
+    }
+  }
+  for (UInt_t i = 0; i < n; ++i) {
+    Int_t Xi = X[i];
+    if (Xi < 0 || Xi >= size) {
+      m_labels[i] = m_nClusters++;
+      continue;
+    }
+    UInt_t root = find(m_grid[Xi] - 1);
+    if (m_runLabels[root] == kMaxUInt) m_runLabels[root] = m_nClusters++;
+    m_labels[i] = m_runLabels[root];
+  }
+
+  // Clear the grid and the mask.
+  for (Int_t y = 0; y < m_height; ++y) {
+    for (UInt_t r = m_rowRuns[y]; r < m_rowRuns[y+1]; ++r) {
+      std::fill(m_grid.begin() + y*m_width + m_runStart[r],
+                m_grid.begin() + y*m_width + m_runEnd[r], 0);
+    }
+  }
+  std::fill(m_mask.begin(), m_mask.end(), 0);
+
+  return kFALSE;
+
+}//end of ClusterFinder::findDense method.
+
+//
+// ClusterFinder::sortPixels
+//
+void ClusterFinder::sortPixels(UInt_t n) {
+
+  // Count the clusters' pixels.
+  m_offsets.assign(m_nClusters + 1, 0);
+  UInt_t * counts = &m_offsets[1];
+  for (UInt_t i = 0; i < n; ++i) ++counts[m_labels[i]];
+  for (UInt_t c = 0; c < m_nClusters; ++c) m_offsets[c+1] += m_offsets[c];
+
+  // Sort the pixels into their clusters (the parents are no longer
+  // needed, so they hold the next place in each cluster).
+  m_pixels.resize(n);
+  if (m_parent.size() < m_nClusters) m_parent.resize(m_nClusters);
+  if (n == 0) return;
+  UInt_t * next = &m_parent[0];
+  UInt_t * pixels = &m_pixels[0];
+  UInt_t const * labels = &m_labels[0];
+  for (UInt_t c = 0; c < m_nClusters; ++c) next[c] = m_offsets[c];
+  for (UInt_t i = 0; i < n; ++i) pixels[next[labels[i]]++] = i;
+
+}//end of ClusterFinder::sortPixels method.
@@ -0,0 +1,63 @@
+/// @file ClusterLogParser.cc
+/// @brief Implementation of the ClusterLogParser class.
+
+// Standard include statements.
+#include <stdlib.h>
+
+// Local include statements.
+#include "ClusterLogParser.h"
+
+namespace {
+
+  /// @brief The longest number read by ClusterLogParser::parseDouble.
+  const Int_t kMaxNumberLength = 64;
+
+}
+
+//
+// ClusterLogParser::ParseHeader
+//
+Bool_t ClusterLogParser::ParseHeader(const char * begin, const char * end,
+                                     Int_t & frame, Double_t & startTime, Double_t & acqTime) {
+
+  const char * lb = (const char *)memchr(begin, '(', end - begin);
+  if (!lb) return false;
+
+  // "Frame n (t s, a s)"
+  const char * p = begin;
+  frame = parseInt(p, lb);
+
+  p = lb + 1;
+  startTime = parseDouble(p, end);
+
+  const char * comma = (const char *)memchr(p, ',', end - p);
+  if (!comma) return false;
+
+  p = comma + 1;
+  acqTime = parseDouble(p, end);
+
+  return true;
+
+}//end of ClusterLogParser::ParseHeader method.
+
+//
+// ClusterLogParser::parseDouble
+//
+Double_t ClusterLogParser::parseDouble(const char *& p, const char * end) {
+
+  while (p < end && (*p < '0' || *p > '9') && *p != '-' && *p != '.') ++p;
+
+  // Copied to the stack so that atof rounds exactly as before and
+  // never reads past the end of the line.
+  char number[kMaxNumberLength];
+  Int_t n = 0;
+  while (p < end && n < kMaxNumberLength - 1 &&
+         ((*p >= '0' && *p <= '9') || *p == '.' || *p == '-' || *p == '+' ||
+          *p == 'e' || *p == 'E')) {
+    number[n++] = *p++;
+  }
+  number[n] = 0;
+
+  return atof(number);
+
+}//end of ClusterLogParser::parseDouble method.
@@ -0,0 +1,333 @@
+/// @file ClusterProperties.cc
+/// @brief Implementation of the ClusterProperties class.
+
+// Standard include statements.
+#include <cmath>
+#include <iostream>
+
+// ROOT include statements.
+#include "TMath.h"
+#include "TTree.h"
+
+// Local include statements.
+#include "ClusterProperties.h"
+#include "ClusterFinder.h"
+#include "FrameBatch.h"
+#include "Frames.h"
+
+//
+// ClusterProperties constructor
+//
+ClusterProperties::ClusterProperties()
+:
+  m_frameOffsets(1, 0)
+{}
+
+//
+// ClusterProperties::Clear
+//
+void ClusterProperties::Clear() {
+
+  m_frameOffsets.resize(1);
+
+  m_size.clear();
+  m_totalToT.clear();
+  m_maxToT.clear();
+  m_xMin.clear();
+  m_xMax.clear();
+  m_yMin.clear();
+  m_yMax.clear();
+  m_xBarU.clear();
+  m_yBarU.clear();
+  m_xBarC.clear();
+  m_yBarC.clear();
+  m_rU.clear();
+  m_densityU.clear();
+  m_linearity.clear();
+
+}//end of ClusterProperties::Clear method.
+
+//
+// ClusterProperties::AddFrame
+//
+UInt_t ClusterProperties::AddFrame(Int_t const * X, Int_t const * C, Int_t width,
+                                   UInt_t const * offsets, UInt_t const * pixels,
+                                   UInt_t nclusters) {
+
+  if (width <= 0) {
+    cout << "ERROR: the clusters of a frame of width " << width
+         << " can't be added." << endl;
+    m_frameOffsets.push_back(m_size.size());
+    return 0;
+  }
+
+  UInt_t n = offsets[nclusters];
+
+  // Gather the pixels into x, y and ToT arrays, cluster by cluster.
+  m_x.resize(n);
+  m_y.resize(n);
+  m_c.resize(n);
+  for (UInt_t k = 0; k < n; ++k) {
+    UInt_t i = pixels[k];
+    m_x[k] = X[i] % width;
+    m_y[k] = X[i] / width;
+    m_c[k] = C[i];
+  }
+
+  Int_t const * xs = n > 0 ? &m_x[0] : 0;
+  Int_t const * ys = n > 0 ? &m_y[0] : 0;
+  Int_t const * cs = n > 0 ? &m_c[0] : 0;
+
+  for (UInt_t j = 0; j < nclusters; ++j) {
+
+    Int_t b = offsets[j], e = offsets[j+1];
+    Long64_t nc = e - b;
+
+    // The sums and extents (one pass).
+    Long64_t sx = 0, sy = 0, sc = 0, sxc = 0, syc = 0;
+    Long64_t sxx = 0, syy = 0, sxy = 0;
+    Int_t xmin = xs[b], xmax = xs[b], ymin = ys[b], ymax = ys[b], cmax = cs[b];
+    for (Int_t k = b; k < e; ++k) {
+      Long64_t x = xs[k], y = ys[k], c = cs[k];
+      sx  += x;
+      sy  += y;
+      sc  += c;
+      sxc += x*c;
+      syc += y*c;
+      sxx += x*x;
+      syy += y*y;
+      sxy += x*y;
+      xmin = xs[k] < xmin ? xs[k] : xmin;
+      xmax = xs[k] > xmax ? xs[k] : xmax;
+      ymin = ys[k] < ymin ? ys[k] : ymin;
+      ymax = ys[k] > ymax ? ys[k] : ymax;
+      cmax = cs[k] > cmax ? cs[k] : cmax;
+    }
+
+    // The radius needs the centroid, so takes a second pass. The
+    // distances are scaled by n (n*x - sum x) to stay in integers.
+    Long64_t d2max = 0;
+    for (Int_t k = b; k < e; ++k) {
+      Long64_t dx = nc*xs[k] - sx, dy = nc*ys[k] - sy;
+      Long64_t d2 = dx*dx + dy*dy;
+      d2max = d2 > d2max ? d2 : d2max;
+    }
+
+    Double_t xbar = (Double_t)sx/nc, ybar = (Double_t)sy/nc;
+    Double_t r    = sqrt((Double_t)d2max)/nc;
+
+    // The position covariance (times n^2) and its eigenvalues.
+    Double_t vxx = (Double_t)(nc*sxx - sx*sx);
+    Double_t vyy = (Double_t)(nc*syy - sy*sy);
+    Double_t vxy = (Double_t)(nc*sxy - sx*sy);
+    Double_t half = 0.5*(vxx + vyy);
+    Double_t root = sqrt(0.25*(vxx - vyy)*(vxx - vyy) + vxy*vxy);
+    Double_t l1 = half + root, l2 = half - root;
+
+    m_size.push_back(nc);
+    m_totalToT.push_back(sc);
+    m_maxToT.push_back(cmax);
+    m_xMin.push_back(xmin);
+    m_xMax.push_back(xmax);
+    m_yMin.push_back(ymin);
+    m_yMax.push_back(ymax);
+    m_xBarU.push_back(xbar);
+    m_yBarU.push_back(ybar);
+    m_xBarC.push_back(sc > 0 ? (Double_t)sxc/sc : xbar);
+    m_yBarC.push_back(sc > 0 ? (Double_t)syc/sc : ybar);
+    m_rU.push_back(r);
+    m_densityU.push_back(r > 0. ? nc/(TMath::Pi()*r*r) : 0.);
+    m_linearity.push_back(l1 > 0. ? 1. - (l2 > 0. ? l2 : 0.)/l1 : 0.);
+
+  }
+
+  m_frameOffsets.push_back(m_size.size());
+
+  return nclusters;
+
+}//end of ClusterProperties::AddFrame method.
+
+//
+// ClusterProperties::AddFrame (cluster IDs)
+//
+UInt_t ClusterProperties::AddFrame(Int_t const * X, Int_t const * C, Int_t const * ids,
+                                   UInt_t n, Int_t width, UInt_t * labels) {
+
+  // No labels for clusters that won't be added.
+  if (width <= 0) return AddFrame(X, C, width, 0, 0, 0);
+
+  UInt_t nclusters = groupByIds(ids, n);
+  UInt_t const * pixels = n > 0 ? &m_idPixels[0] : 0;
+
+  if (labels) {
+    for (UInt_t c = 0; c < nclusters; ++c) {
+      for (UInt_t k = m_idOffsets[c]; k < m_idOffsets[c+1]; ++k) labels[pixels[k]] = c;
+    }
+  }
+
+  return AddFrame(X, C, width, &m_idOffsets[0], pixels, nclusters);
+
+}//end of ClusterProperties::AddFrame (cluster IDs) method.
+
+//
+// ClusterProperties::AddFrame (FrameStruct)
+//
+UInt_t ClusterProperties::AddFrame(FrameStruct & frame, ClusterFinder & finder) {
+
+  map<int,int> const & xc = frame.GetPixelCounts();
+  UInt_t n = xc.size();
+
+  m_frameX.resize(n);
+  m_frameC.resize(n);
+  UInt_t i = 0;
+  map<int,int>::const_iterator it;
+  for (it = xc.begin(); it != xc.end(); ++it, ++i) {
+    m_frameX[i] = it->first;
+    m_frameC[i] = it->second;
+  }
+  Int_t const * X = n > 0 ? &m_frameX[0] : 0;
+  Int_t const * C = n > 0 ? &m_frameC[0] : 0;
+
+  // Use the clusters stored with the frame if there are any (the
+  // cluster ID map has the same pixels, so the same order).
+  UInt_t nclusters;
+  if (frame.HasClusterIds()) {
+    m_frameIds.resize(n);
+    i = 0;
+    map<int,int> const & ids = frame.GetClusterIds();
+    for (it = ids.begin(); it != ids.end(); ++it, ++i) m_frameIds[i] = it->second;
+    nclusters = AddFrame(X, C, n > 0 ? &m_frameIds[0] : 0, n, finder.GetWidth());
+  } else {
+    nclusters = finder.Find(X, n);
+    nclusters = AddFrame(X, C, finder.GetWidth(), &finder.GetOffsets()[0],
+                         n > 0 ? &finder.GetPixels()[0] : 0, nclusters);
+  }
+
+  return nclusters;
+
+}//end of ClusterProperties::AddFrame (FrameStruct) method.
+
+//
+// ClusterProperties::AddBatch
+//
+UInt_t ClusterProperties::AddBatch(FrameBatch const & batch) {
+
+  Int_t const * X = batch.GetPixelX();
+  Int_t const * C = batch.GetPixelC();
+  vector<Int_t> const & widths  = batch.GetWidths();
+  vector<Int_t> const & heights = batch.GetHeights();
+
+  // One finder for each run of frames of the same size.
+  ClusterFinder * finder = 0;
+  UInt_t nadded = 0;
+  for (UInt_t i = 0; i < batch.GetNFrames(); ++i) {
+
+    UInt_t b = batch.GetFrameBegin(i), n = batch.GetFrameEnd(i) - b;
+    Int_t width  = widths[i]  > 0 ? widths[i]  : 256;
+    Int_t height = heights[i] > 0 ? heights[i] : 256;
+
+    if (batch.HasClusterIds(i)) {
+      nadded += AddFrame(X + b, C + b, batch.GetClusterIds(i), n, width);
+      continue;
+    }
+
+    if (!finder || width != finder->GetWidth() || height != finder->GetHeight()) {
+      delete finder;
+      finder = new ClusterFinder(width, height);
+    }
+    UInt_t nclusters = finder->Find(X + b, n);
+    nadded += AddFrame(X + b, C + b, width, &finder->GetOffsets()[0],
+                       n > 0 ? &finder->GetPixels()[0] : 0, nclusters);
+
+  }//end of loop over the frames.
+
+  delete finder;
+
+  return nadded;
+
+}//end of ClusterProperties::AddBatch method.
+
+//
+// ClusterProperties::CopyFrame
+//
+void ClusterProperties::CopyFrame(ClusterProperties const & other, UInt_t i) {
+
+  Clear();
+
+  UInt_t b = other.GetFrameBegin(i), e = other.GetFrameEnd(i);
+
+  m_size.assign(     other.m_size.begin()      + b, other.m_size.begin()      + e);
+  m_totalToT.assign( other.m_totalToT.begin()  + b, other.m_totalToT.begin()  + e);
+  m_maxToT.assign(   other.m_maxToT.begin()    + b, other.m_maxToT.begin()    + e);
+  m_xMin.assign(     other.m_xMin.begin()      + b, other.m_xMin.begin()      + e);
+  m_xMax.assign(     other.m_xMax.begin()      + b, other.m_xMax.begin()      + e);
+  m_yMin.assign(     other.m_yMin.begin()      + b, other.m_yMin.begin()      + e);
+  m_yMax.assign(     other.m_yMax.begin()      + b, other.m_yMax.begin()      + e);
+  m_xBarU.assign(    other.m_xBarU.begin()     + b, other.m_xBarU.begin()     + e);
+  m_yBarU.assign(    other.m_yBarU.begin()     + b, other.m_yBarU.begin()     + e);
+  m_xBarC.assign(    other.m_xBarC.begin()     + b, other.m_xBarC.begin()     + e);
+  m_yBarC.assign(    other.m_yBarC.begin()     + b, other.m_yBarC.begin()     + e);
+  m_rU.assign(       other.m_rU.begin()        + b, other.m_rU.begin()        + e);
+  m_densityU.assign( other.m_densityU.begin()  + b, other.m_densityU.begin()  + e);
+  m_linearity.assign(other.m_linearity.begin() + b, other.m_linearity.begin() + e);
+
+  m_frameOffsets.push_back(m_size.size());
+
+}//end of ClusterProperties::CopyFrame method.
+
+//
+// ClusterProperties::Branch
+//
+void ClusterProperties::Branch(TTree * tree, TString prefix) {
+
+  tree->Branch(prefix + "Size",      &m_size);
+  tree->Branch(prefix + "TotalToT",  &m_totalToT);
+  tree->Branch(prefix + "MaxToT",    &m_maxToT);
+  tree->Branch(prefix + "XMin",      &m_xMin);
+  tree->Branch(prefix + "XMax",      &m_xMax);
+  tree->Branch(prefix + "YMin",      &m_yMin);
+  tree->Branch(prefix + "YMax",      &m_yMax);
+  tree->Branch(prefix + "XBarU",     &m_xBarU);
+  tree->Branch(prefix + "YBarU",     &m_yBarU);
+  tree->Branch(prefix + "XBarC",     &m_xBarC);
+  tree->Branch(prefix + "YBarC",     &m_yBarC);
+  tree->Branch(prefix + "RadiusU",   &m_rU);
+  tree->Branch(prefix + "DensityU",  &m_densityU);
+  tree->Branch(prefix + "Linearity", &m_linearity);
+
+}//end of ClusterProperties::Branch method.
+
+//
+// ClusterProperties::groupByIds
+//
+UInt_t ClusterProperties::groupByIds(Int_t const * ids, UInt_t n) {
+
+  // Number the clusters in the order of their first pixel (as the
+  // ClusterFinder does), whatever IDs they were stored with.
+  Int_t maxId = 0;
+  for (UInt_t i = 0; i < n; ++i) maxId = ids[i] > maxId ? ids[i] : maxId;
+
+  m_idLabels.assign(maxId + 1, 0);
+  m_idOffsets.assign(1, 0);
+  UInt_t nclusters = 0;
+  for (UInt_t i = 0; i < n; ++i) {
+    Int_t id = ids[i] > 0 ? ids[i] : 0;
+    if (m_idLabels[id] == 0) {
+      m_idLabels[id] = ++nclusters;
+      m_idOffsets.push_back(0);
+    }
+    ++m_idOffsets[m_idLabels[id]];
+  }
+  for (UInt_t c = 0; c < nclusters; ++c) m_idOffsets[c+1] += m_idOffsets[c];
+
+  // Sort the pixels into their clusters.
+  m_idNext.assign(m_idOffsets.begin(), m_idOffsets.end() - 1);
+  m_idPixels.resize(n);
+  for (UInt_t i = 0; i < n; ++i) {
+    Int_t id = ids[i] > 0 ? ids[i] : 0;
+    m_idPixels[m_idNext[m_idLabels[id] - 1]++] = i;
+  }
+
+  return nclusters;
+
+}//end of ClusterProperties::groupByIds method.
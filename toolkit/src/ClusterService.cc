@@ -0,0 +1,306 @@
+/// @file ClusterService.cc
+/// @brief Implementation of the ClusterService class.
+
+// Local include statements.
+#include "ClusterService.h"
+#include "ClusterFinder.h"
+#include "FrameBatch.h"
+
+//
+// ClusterService constructor
+//
+ClusterService::ClusterService(UInt_t nthreads, UInt_t nbuffers)
+:
+  m_nSubmitted(0),
+  m_nextOut(0),
+  m_nQueued(0),
+  m_nStolen(0),
+  m_closed(false)
+{
+
+  if (nthreads < 1) nthreads = thread::hardware_concurrency();
+  if (nthreads < 1) nthreads = 1;
+  if (nbuffers < 1) nbuffers = 1;
+
+  for (UInt_t i = 0; i < nbuffers; ++i) {
+    ClusterResult * result = new ClusterResult();
+    m_owned.push_back(result);
+    m_free.push_back(result);
+  }
+  m_done.assign(nbuffers, 0);
+
+  for (UInt_t t = 0; t < nthreads; ++t) m_queues.push_back(new WorkQueue());
+  for (UInt_t t = 0; t < nthreads; ++t) {
+    m_threads.push_back(thread(&ClusterService::run, this, t));
+  }
+
+}//end of ClusterService constructor.
+
+//
+// ClusterService destructor
+//
+ClusterService::~ClusterService() {
+
+  Close();
+  for (UInt_t t = 0; t < m_threads.size(); ++t) m_threads[t].join();
+
+  for (UInt_t t = 0; t < m_queues.size(); ++t) delete m_queues[t];
+  for (UInt_t i = 0; i < m_owned.size(); ++i) delete m_owned[i];
+
+}//end of ClusterService destructor.
+
+//
+// ClusterService::HasFree
+//
+Bool_t ClusterService::HasFree() {
+
+  lock_guard<mutex> lock(m_mutex);
+  return !m_free.empty();
+
+}//end of ClusterService::HasFree method.
+
+//
+// ClusterService::Submit (FrameStruct)
+//
+Long64_t ClusterService::Submit(FrameStruct & frame) {
+
+  ClusterResult * result = getFree();
+  if (!result) return -1;
+
+  // Frames without the size in their metadata are taken to be Timepix
+  // frames (256 x 256).
+  result->frameId = frame.GetFrameId();
+  result->width   = frame.GetFrameWidth()  > 0 ? frame.GetFrameWidth()  : 256;
+  result->height  = frame.GetFrameHeight() > 0 ? frame.GetFrameHeight() : 256;
+
+  // The pixel map is copied straight into the buffer.
+  map<int,int> const & xc = frame.GetPixelCounts();
+  result->pixelX.resize(xc.size());
+  result->pixelC.resize(xc.size());
+  UInt_t i = 0;
+  map<int,int>::const_iterator it;
+  for (it = xc.begin(); it != xc.end(); ++it, ++i) {
+    result->pixelX[i] = it->first;
+    result->pixelC[i] = it->second;
+  }
+
+  // The cluster ID map has the same pixels, so the same order.
+  result->clusterIds.clear();
+  if (frame.HasClusterIds()) {
+    map<int,int> const & ids = frame.GetClusterIds();
+    for (it = ids.begin(); it != ids.end(); ++it) result->clusterIds.push_back(it->second);
+  }
+
+  return queue(result);
+
+}//end of ClusterService::Submit (FrameStruct) method.
+
+//
+// ClusterService::Submit (FrameBatch)
+//
+Long64_t ClusterService::Submit(FrameBatch const & batch, UInt_t i) {
+
+  UInt_t b = batch.GetFrameBegin(i), n = batch.GetFrameEnd(i) - b;
+
+  return Submit(batch.GetFrameIds()[i], batch.GetWidths()[i], batch.GetHeights()[i],
+                batch.GetPixelX() + b, batch.GetPixelC() + b, n,
+                batch.GetClusterIds(i));
+
+}//end of ClusterService::Submit (FrameBatch) method.
+
+//
+// ClusterService::Submit
+//
+Long64_t ClusterService::Submit(Long64_t frameId, Int_t width, Int_t height,
+                                Int_t const * X, Int_t const * C, UInt_t n,
+                                Int_t const * ids) {
+
+  ClusterResult * result = getFree();
+  if (!result) return -1;
+
+  // Frames without the size in their metadata are taken to be Timepix
+  // frames (256 x 256).
+  result->frameId = frameId;
+  result->width   = width  > 0 ? width  : 256;
+  result->height  = height > 0 ? height : 256;
+  result->pixelX.assign(X, X + n);
+  result->pixelC.assign(C, C + n);
+  if (ids) result->clusterIds.assign(ids, ids + n);
+  else     result->clusterIds.clear();
+
+  return queue(result);
+
+}//end of ClusterService::Submit method.
+
+//
+// ClusterService::GetResult
+//
+ClusterResult const * ClusterService::GetResult(Bool_t wait) {
+
+  unique_lock<mutex> lock(m_mutex);
+
+  UInt_t slot = m_nextOut % m_done.size();
+  while (m_done[slot] == 0) {
+    if (!wait || (m_closed && m_nextOut == m_nSubmitted)) return 0;
+    m_doneCond.wait(lock);
+  }
+
+  ClusterResult * result = m_done[slot];
+  m_done[slot] = 0;
+  ++m_nextOut;
+  return result;
+
+}//end of ClusterService::GetResult method.
+
+//
+// ClusterService::Release
+//
+void ClusterService::Release(ClusterResult const * result) {
+
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_free.push_back(const_cast<ClusterResult*>(result));
+  }
+  m_freeCond.notify_one();
+
+}//end of ClusterService::Release method.
+
+//
+// ClusterService::Close
+//
+void ClusterService::Close() {
+
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_closed = true;
+  }
+  m_workCond.notify_all();
+  m_doneCond.notify_all();
+
+}//end of ClusterService::Close method.
+
+//
+// ClusterService::getFree
+//
+ClusterResult * ClusterService::getFree() {
+
+  unique_lock<mutex> lock(m_mutex);
+
+  if (m_closed) {
+    cout << "ERROR: frame submitted to a closed ClusterService." << endl;
+    return 0;
+  }
+
+  while (m_free.empty()) m_freeCond.wait(lock);
+
+  ClusterResult * result = m_free.front();
+  m_free.pop_front();
+  result->index = m_nSubmitted++;
+  return result;
+
+}//end of ClusterService::getFree method.
+
+//
+// ClusterService::queue
+//
+Long64_t ClusterService::queue(ClusterResult * result) {
+
+  Long64_t index = result->index;
+
+  // Deal the frame out to the next thread's queue.
+  WorkQueue * work = m_queues[index % m_queues.size()];
+  {
+    lock_guard<mutex> lock(work->m_mutex);
+    work->m_frames.push_back(result);
+  }
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_nQueued.fetch_add(1, memory_order_relaxed);
+  }
+  m_workCond.notify_one();
+
+  return index;
+
+}//end of ClusterService::queue method.
+
+//
+// ClusterService::take
+//
+ClusterResult * ClusterService::take(UInt_t t) {
+
+  UInt_t nqueues = m_queues.size();
+
+  // The thread's own queue first, then the others in turn.
+  for (UInt_t k = 0; k < nqueues; ++k) {
+    WorkQueue * work = m_queues[(t + k) % nqueues];
+    lock_guard<mutex> lock(work->m_mutex);
+    if (work->m_frames.empty()) continue;
+    ClusterResult * result = work->m_frames.front();
+    work->m_frames.pop_front();
+    m_nQueued.fetch_sub(1, memory_order_relaxed);
+    if (k > 0) m_nStolen.fetch_add(1, memory_order_relaxed);
+    return result;
+  }
+
+  return 0;
+
+}//end of ClusterService::take method.
+
+//
+// ClusterService::run
+//
+void ClusterService::run(UInt_t t) {
+
+  // One finder for each run of frames of the same size.
+  ClusterFinder * finder = 0;
+  Int_t width = -1, height = -1;
+
+  while (true) {
+
+    ClusterResult * result = take(t);
+
+    if (!result) {
+      unique_lock<mutex> lock(m_mutex);
+      while (m_nQueued.load(memory_order_relaxed) == 0 && !m_closed) {
+        m_workCond.wait(lock);
+      }
+      if (m_nQueued.load(memory_order_relaxed) == 0) break;
+      continue;
+    }
+
+    if (!finder || result->width != width || result->height != height) {
+      delete finder;
+      width  = result->width;
+      height = result->height;
+      finder = new ClusterFinder(width, height);
+    }
+
+    UInt_t n = result->pixelX.size();
+    Int_t const * X = n > 0 ? &result->pixelX[0] : 0;
+    Int_t const * C = n > 0 ? &result->pixelC[0] : 0;
+    result->properties.Clear();
+
+    // The clusters stored with the frame are used if it has any.
+    if (result->clusterIds.size() == n && n > 0) {
+      result->labels.resize(n);
+      result->nClusters = result->properties.AddFrame(X, C, &result->clusterIds[0],
+                                                      n, width, &result->labels[0]);
+    } else {
+      result->nClusters = finder->Find(X, n);
+      result->labels = finder->GetLabels();
+      result->nClusters = result->properties.AddFrame(X, C, width, &finder->GetOffsets()[0],
+                                                      n > 0 ? &finder->GetPixels()[0] : 0,
+                                                      result->nClusters);
+    }
+
+    {
+      lock_guard<mutex> lock(m_mutex);
+      m_done[result->index % m_done.size()] = result;
+    }
+    m_doneCond.notify_all();
+
+  }//end of loop over the frames.
+
+  delete finder;
+
+}//end of ClusterService::run method.
@@ -0,0 +1,130 @@
+/// @file ClusterTreeWriter.cc
+/// @brief Implementation of the ClusterTreeWriter class.
+
+// ROOT include statements.
+#include "TDirectory.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TNamed.h"
+
+// Local include statements.
+#include "ClusterTreeWriter.h"
+#include "ClusterClassifier.h"
+
+//
+// ClusterTreeWriter constructor
+//
+ClusterTreeWriter::ClusterTreeWriter(TString path, ConverterOptions const & options,
+                                     ClusterClassifier const * classifier)
+:
+  m_file(0),
+  m_tree(0),
+  m_classifier(classifier),
+  m_entry(0),
+  m_frameId(0),
+  m_nClusters(0)
+{
+
+  // The tree belongs to the new file, whatever the current directory.
+  TDirectory * old = gDirectory;
+
+  m_file = new TFile(path, "RECREATE");
+  if (!m_file || m_file->IsZombie()) {
+    cout << "ERROR: unable to create '" << path << "'" << endl;
+    delete m_file;
+    m_file = 0;
+    if (old) old->cd();
+    return;
+  }
+  Int_t compress = options.GetCompressionSettings();
+  if (compress >= 0) m_file->SetCompressionSettings(compress);
+
+  m_tree = new TTree("ClusterTree", "The clusters of each frame");
+  m_tree->Branch("entry",     &m_entry,     "entry/L");
+  m_tree->Branch("frameId",   &m_frameId,   "frameId/L");
+  m_tree->Branch("nClusters", &m_nClusters, "nClusters/I");
+  m_properties.Branch(m_tree, "cluster");
+
+  if (m_classifier) {
+    m_tree->Branch("clusterClass", &m_labels);
+    m_counts.assign(m_classifier->GetNCounts(), 0);
+    m_totals.assign(m_classifier->GetNCounts(), 0);
+    Int_t nclasses = m_classifier->GetNClasses();
+    for (Int_t i = 0; i < m_classifier->GetNCounts(); ++i) {
+      TString name = "n_" + (i < nclasses ? m_classifier->GetClassName(i)
+                                          : m_classifier->GetGroupName(i - nclasses));
+      m_tree->Branch(name, &m_counts[i], name + "/I");
+    }
+  }
+
+  options.ConfigureTree(m_tree);
+
+  if (old) old->cd();
+
+}//end of ClusterTreeWriter constructor.
+
+//
+// ClusterTreeWriter destructor
+//
+ClusterTreeWriter::~ClusterTreeWriter() {
+
+  Close();
+
+}//end of ClusterTreeWriter destructor.
+
+//
+// ClusterTreeWriter::Fill
+//
+void ClusterTreeWriter::Fill(Long64_t entry, Long64_t frameId,
+                             ClusterProperties const & properties, UInt_t frame) {
+
+  if (!m_tree) return;
+
+  m_entry     = entry;
+  m_frameId   = frameId;
+  m_nClusters = properties.GetFrameEnd(frame) - properties.GetFrameBegin(frame);
+  m_properties.CopyFrame(properties, frame);
+
+  if (m_classifier) {
+    m_labels.resize(m_nClusters);
+    m_classifier->Classify(properties, frame, m_nClusters > 0 ? &m_labels[0] : 0,
+                           m_counts.empty() ? 0 : &m_counts[0]);
+    for (UInt_t i = 0; i < m_counts.size(); ++i) m_totals[i] += m_counts[i];
+  }
+
+  m_tree->Fill();
+
+}//end of ClusterTreeWriter::Fill method.
+
+//
+// ClusterTreeWriter::Close
+//
+void ClusterTreeWriter::Close() {
+
+  if (!m_file) return;
+
+  TDirectory * old = gDirectory;
+  if (old == m_file) old = 0;
+  m_file->cd();
+
+  m_tree->Write();
+
+  // The class names, so that the class numbers can be read back.
+  if (m_classifier) {
+    TString names = "";
+    for (Int_t c = 0; c < m_classifier->GetNClasses(); ++c) {
+      if (c > 0) names += " ";
+      names += m_classifier->GetClassName(c);
+    }
+    TNamed classes("ClusterClasses", names.Data());
+    classes.Write();
+  }
+
+  m_file->Close();
+  delete m_file;
+  m_file = 0;
+  m_tree = 0;
+
+  if (old) old->cd();
+
+}//end of ClusterTreeWriter::Close method.
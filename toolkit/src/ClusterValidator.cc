@@ -0,0 +1,82 @@
+/// @file ClusterValidator.cc
+/// @brief Implementation of the ClusterValidator class.
+
+// Local include statements.
+#include "ClusterValidator.h"
+
+//
+// ClusterValidator constructor
+//
+ClusterValidator::ClusterValidator(Int_t width, Int_t height)
+:
+  m_width(width),
+  m_height(height),
+  m_grid(width > 0 && height > 0 ? width*height : 0, 0),
+  m_finder(width, height),
+  m_nClusters(0),
+  m_nOutside(0),
+  m_nDuplicates(0),
+  m_lastClusters(0),
+  m_lastPixels(0),
+  m_lastGroups(0),
+  m_lastOutside(0),
+  m_lastDuplicates(0),
+  m_lastSplit(0),
+  m_lastTouching(0)
+{}
+
+//
+// ClusterValidator::EndFrame
+//
+Bool_t ClusterValidator::EndFrame() {
+
+  Int_t n = m_X.size();
+
+  // Group the touching pixels.
+  Int_t groups = m_finder.Find(n > 0 ? &m_X[0] : 0, n);
+  vector<UInt_t> const & labels = m_finder.GetLabels();
+
+  // Each cluster should be one group, and each group one cluster.
+  // A cluster is "split" if its pixels are in more than one group, and
+  // "touching" if it shares a group with an earlier cluster.
+  m_root.assign(m_nClusters + 1, -1);
+  m_owner.assign(groups, 0);
+  m_flags.assign(m_nClusters + 1, 0);
+  for (Int_t i = 0; i < n; ++i) {
+    Int_t c = m_cluster[i];
+    Int_t r = labels[i];
+    if (m_root[c] < 0) {
+      m_root[c] = r;
+    } else if (m_root[c] != r) {
+      m_flags[c] |= kSplit;
+    }
+    if (m_owner[r] == 0) m_owner[r] = c;
+    else if (m_owner[r] != c) m_flags[c] |= kTouching;
+  }
+
+  Int_t split = 0, touching = 0;
+  for (Int_t c = 1; c <= m_nClusters; ++c) {
+    if (m_flags[c] & kSplit)    ++split;
+    if (m_flags[c] & kTouching) ++touching;
+  }
+
+  m_lastClusters   = m_nClusters;
+  m_lastPixels     = n;
+  m_lastGroups     = groups;
+  m_lastOutside    = m_nOutside;
+  m_lastDuplicates = m_nDuplicates;
+  m_lastSplit      = split;
+  m_lastTouching   = touching;
+
+  // Clear the grid (only where the frame had pixels).
+  for (Int_t i = 0; i < n; ++i) m_grid[m_X[i]] = 0;
+  m_X.clear();
+  m_cluster.clear();
+  m_nClusters   = 0;
+  m_nOutside    = 0;
+  m_nDuplicates = 0;
+
+  return m_lastOutside == 0 && m_lastDuplicates == 0 &&
+         m_lastSplit == 0 && m_lastTouching == 0;
+
+}//end of ClusterValidator::EndFrame method.
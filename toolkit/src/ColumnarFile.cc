@@ -0,0 +1,201 @@
+/// @file ColumnarFile.cc
+/// @brief Implementation of the ColumnarWriter class.
+
+// Standard include statements.
+#include <string.h>
+
+#include "ColumnarFile.h"
+
+//
+// ColumnarWriter constructor
+//
+ColumnarWriter::ColumnarWriter(TString path, TString dataset)
+:
+  m_path(path),
+  m_dataset(dataset),
+  m_file(0),
+  m_cfile(0),
+  m_nPixels(0)
+{
+
+  m_file = fopen(m_path.Data(), "wb+");
+  if (!m_file) {
+    cout << "ERROR: could not create the columnar file '" << m_path << "'" << endl;
+    return;
+  }
+
+  m_cfile = tmpfile();
+  if (!m_cfile) {
+    cout << "ERROR: could not create a temporary file for '" << m_path << "'" << endl;
+    fclose(m_file);
+    m_file = 0;
+    return;
+  }
+
+  // The header is written properly on closing; the X column follows it.
+  ColumnarHeader header;
+  memset(&header, 0, sizeof(header));
+  fwrite(&header, sizeof(header), 1, m_file);
+
+  m_pixelOffset.push_back(0);
+
+}//end of ColumnarWriter constructor.
+
+//
+// ColumnarWriter destructor
+//
+ColumnarWriter::~ColumnarWriter() {
+
+  if (m_file) Close();
+
+}//end of ColumnarWriter destructor.
+
+//
+// ColumnarWriter::fillFrame
+//
+void ColumnarWriter::fillFrame(FrameStruct & frame) {
+
+  if (!m_file) return;
+
+  frame.UpdateFrameStats();
+
+  map<int,int> const & pixels = frame.GetPixelCounts();
+  m_X.resize(pixels.size());
+  m_C.resize(pixels.size());
+  UInt_t n = 0;
+  map<int,int>::const_iterator it;
+  for (it = pixels.begin(); it != pixels.end(); ++it, ++n) {
+    m_X[n] = it->first;
+    m_C[n] = it->second;
+  }
+
+  if (n > 0) {
+    fwrite(&m_X[0], sizeof(Int_t), n, m_file);
+    fwrite(&m_C[0], sizeof(Int_t), n, m_cfile);
+  }
+  m_nPixels += n;
+
+  m_pixelOffset.push_back(m_nPixels);
+  m_frameId.push_back(frame.GetFrameId());
+  m_startTime.push_back(frame.GetStartTime());
+  m_acqTime.push_back(frame.GetAcqTime());
+  m_width.push_back(frame.GetFrameWidth());
+  m_height.push_back(frame.GetFrameHeight());
+  m_latitude.push_back(frame.GetLatitude());
+  m_longitude.push_back(frame.GetLongitude());
+  m_altitude.push_back(frame.GetAltitude());
+  m_totalToT.push_back(frame.GetTotalToT());
+  m_maxToT.push_back(frame.GetMaxToT());
+  m_nClusters.push_back(frame.GetNClusters());
+
+}//end of ColumnarWriter::fillFrame method.
+
+//
+// ColumnarWriter::Close
+//
+Bool_t ColumnarWriter::Close() {
+
+  if (!m_file) return false;
+
+  // The X column was written straight after the header.
+  ColumnarEntry x;
+  memset(&x, 0, sizeof(x));
+  strncpy(x.name, "pixel.X", sizeof(x.name) - 1);
+  x.type     = 'i';
+  x.elemSize = sizeof(Int_t);
+  x.offset   = sizeof(ColumnarHeader);
+  x.count    = m_nPixels;
+  m_dir.push_back(x);
+
+  // Copy the C column over from the temporary file.
+  align();
+  ColumnarEntry c = x;
+  strncpy(c.name, "pixel.C", sizeof(c.name) - 1);
+  c.offset = ftello(m_file);
+  rewind(m_cfile);
+  vector<char> chunk(1 << 20);
+  size_t nread;
+  while ((nread = fread(&chunk[0], 1, chunk.size(), m_cfile)) > 0) {
+    fwrite(&chunk[0], 1, nread, m_file);
+  }
+  fclose(m_cfile);
+  m_cfile = 0;
+  m_dir.push_back(c);
+
+  ULong64_t nFrames = m_frameId.size();
+
+  writeColumn("frame.pixelOffset", 'l', sizeof(ULong64_t), &m_pixelOffset[0], nFrames + 1);
+  if (nFrames > 0) {
+    writeColumn("frame.id",        'i', sizeof(Int_t),    &m_frameId[0],   nFrames);
+    writeColumn("frame.startTime", 'd', sizeof(Double_t), &m_startTime[0], nFrames);
+    writeColumn("frame.acqTime",   'd', sizeof(Double_t), &m_acqTime[0],   nFrames);
+    writeColumn("frame.width",     'i', sizeof(Int_t),    &m_width[0],     nFrames);
+    writeColumn("frame.height",    'i', sizeof(Int_t),    &m_height[0],    nFrames);
+    writeColumn("frame.latitude",  'd', sizeof(Double_t), &m_latitude[0],  nFrames);
+    writeColumn("frame.longitude", 'd', sizeof(Double_t), &m_longitude[0], nFrames);
+    writeColumn("frame.altitude",  'd', sizeof(Double_t), &m_altitude[0],  nFrames);
+    writeColumn("frame.totalToT",  'i', sizeof(Int_t),    &m_totalToT[0],  nFrames);
+    writeColumn("frame.maxToT",    'i', sizeof(Int_t),    &m_maxToT[0],    nFrames);
+    writeColumn("frame.nClusters", 'i', sizeof(Int_t),    &m_nClusters[0], nFrames);
+  }
+  writeColumn("meta.dataset", 'c', 1, m_dataset.Data(), m_dataset.Length());
+
+  // The directory, then the header that points to it.
+  align();
+  ColumnarHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kColumnarMagic, sizeof(header.magic));
+  header.version   = kColumnarVersion;
+  header.byteOrder = 0x01020304;
+  header.nFrames   = nFrames;
+  header.nPixels   = m_nPixels;
+  header.dirOffset = ftello(m_file);
+  header.nColumns  = m_dir.size();
+
+  fwrite(&m_dir[0], sizeof(ColumnarEntry), m_dir.size(), m_file);
+
+  fseek(m_file, 0, SEEK_SET);
+  fwrite(&header, sizeof(header), 1, m_file);
+
+  Bool_t ok = (ferror(m_file) == 0);
+  if (fclose(m_file) != 0) ok = false;
+  m_file = 0;
+
+  if (!ok) cout << "ERROR: could not write the columnar file '" << m_path << "'" << endl;
+
+  return ok;
+
+}//end of ColumnarWriter::Close method.
+
+//
+// ColumnarWriter::writeColumn
+//
+void ColumnarWriter::writeColumn(const char * name, Char_t type, UInt_t elemSize,
+                                 void const * data, ULong64_t count) {
+
+  align();
+
+  ColumnarEntry e;
+  memset(&e, 0, sizeof(e));
+  strncpy(e.name, name, sizeof(e.name) - 1);
+  e.type     = type;
+  e.elemSize = elemSize;
+  e.offset   = ftello(m_file);
+  e.count    = count;
+
+  if (count > 0) fwrite(data, elemSize, count, m_file);
+
+  m_dir.push_back(e);
+
+}//end of ColumnarWriter::writeColumn method.
+
+//
+// ColumnarWriter::align
+//
+void ColumnarWriter::align() {
+
+  static const char zeros[64] = { 0 };
+  off_t pos = ftello(m_file);
+  if (pos % 64) fwrite(zeros, 1, 64 - pos % 64, m_file);
+
+}//end of ColumnarWriter::align method.
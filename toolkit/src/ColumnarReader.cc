@@ -0,0 +1,205 @@
+/// @file ColumnarReader.cc
+/// @brief Implementation of the ColumnarReader class (no ROOT needed).
+
+// Standard include statements.
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <iostream>
+
+#include "ColumnarReader.h"
+
+using namespace std;
+
+//
+// ColumnarReader constructor
+//
+ColumnarReader::ColumnarReader(string const & path)
+:
+  m_size(0),
+  m_header(0),
+  m_pixelOffset(0),
+  m_pixelX(0),
+  m_pixelC(0),
+  m_frameId(0),
+  m_startTime(0),
+  m_acqTime(0),
+  m_width(0),
+  m_height(0),
+  m_totalToT(0),
+  m_nClusters(0)
+{
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    cout << "ERROR: could not open the columnar file '" << path << "'" << endl;
+    return;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ColumnarHeader)) {
+    cout << "ERROR: '" << path << "' is too short to be a columnar file." << endl;
+    close(fd);
+    return;
+  }
+
+  m_size = st.st_size;
+  void * p = mmap(0, m_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    cout << "ERROR: could not map the columnar file '" << path << "'" << endl;
+    return;
+  }
+
+  ColumnarHeader const * h = (ColumnarHeader const *)p;
+  bool ok =
+    memcmp(h->magic, kColumnarMagic, sizeof(h->magic)) == 0 &&
+    h->version == kColumnarVersion &&
+    h->byteOrder == 0x01020304 &&
+    h->dirOffset <= m_size &&
+    h->nColumns <= (m_size - h->dirOffset)/sizeof(ColumnarEntry);
+
+  if (!ok) {
+    cout << "ERROR: '" << path << "' is not a columnar MAFalda file (version "
+         << kColumnarVersion << ")." << endl;
+    munmap(p, m_size);
+    return;
+  }
+
+  m_header = h;
+
+  // Index the directory, checking each column has the element size of
+  // its type (the accessors cast to it) and lies inside the file.
+  ColumnarEntry const * dir = (ColumnarEntry const *)((char const *)p + h->dirOffset);
+  for (uint32_t i = 0; i < h->nColumns; ++i) {
+    if (dir[i].elemSize == 0 || dir[i].elemSize != elementSize(dir[i].type) ||
+        dir[i].offset > m_size ||
+        dir[i].count > (m_size - dir[i].offset)/dir[i].elemSize) continue;
+    m_columns[string(dir[i].name, strnlen(dir[i].name, sizeof(dir[i].name)))] = &dir[i];
+  }
+
+  m_pixelOffset = (uint64_t const *)frameColumn("frame.pixelOffset", 'l', 1);
+  m_frameId     = (int32_t const *) frameColumn("frame.id",          'i');
+  m_startTime   = (double const *)  frameColumn("frame.startTime",   'd');
+  m_acqTime     = (double const *)  frameColumn("frame.acqTime",     'd');
+  m_width       = (int32_t const *) frameColumn("frame.width",       'i');
+  m_height      = (int32_t const *) frameColumn("frame.height",      'i');
+  m_totalToT    = (int32_t const *) frameColumn("frame.totalToT",    'i');
+  m_nClusters   = (int32_t const *) frameColumn("frame.nClusters",   'i');
+
+  int64_t nx = 0, nc = 0;
+  m_pixelX = (int32_t const *)GetColumn("pixel.X", 'i', nx);
+  m_pixelC = (int32_t const *)GetColumn("pixel.C", 'i', nc);
+
+  if (!m_pixelOffset || (GetNFrames() > 0 && (!m_frameId || !m_startTime ||
+      !m_acqTime || !m_width || !m_height || !m_totalToT || !m_nClusters)) ||
+      nx != GetNPixels() || nc != GetNPixels() ||
+      m_pixelOffset[GetNFrames()] != h->nPixels) {
+    cout << "ERROR: the columnar file '" << path << "' is incomplete." << endl;
+    unmap();
+    return;
+  }
+
+  // The pixel offsets mustn't run backwards (or past the pixels).
+  for (int64_t i = 0; i < GetNFrames(); ++i) {
+    if (m_pixelOffset[i] > m_pixelOffset[i+1]) {
+      cout << "ERROR: the columnar file '" << path << "' has bad pixel offsets." << endl;
+      unmap();
+      return;
+    }
+  }
+
+  // Bulk readers usually go through the file in order.
+  madvise(p, m_size, MADV_SEQUENTIAL);
+
+}//end of ColumnarReader constructor.
+
+//
+// ColumnarReader destructor
+//
+ColumnarReader::~ColumnarReader() {
+
+  unmap();
+
+}//end of ColumnarReader destructor.
+
+//
+// ColumnarReader::GetDataSet
+//
+string ColumnarReader::GetDataSet() const {
+
+  int64_t n = 0;
+  char const * s = (char const *)GetColumn("meta.dataset", 'c', n);
+  return s ? string(s, n) : string("");
+
+}//end of ColumnarReader::GetDataSet method.
+
+//
+// ColumnarReader::GetPixels
+//
+PixelSpan ColumnarReader::GetPixels(int64_t i) const {
+
+  PixelSpan span;
+  span.X = m_pixelX + m_pixelOffset[i];
+  span.C = m_pixelC + m_pixelOffset[i];
+  span.n = m_pixelOffset[i+1] - m_pixelOffset[i];
+  return span;
+
+}//end of ColumnarReader::GetPixels method.
+
+//
+// ColumnarReader::GetColumn
+//
+void const * ColumnarReader::GetColumn(string const & name, char type, int64_t & count) const {
+
+  count = 0;
+  if (!m_header) return 0;
+
+  map<string, ColumnarEntry const *>::const_iterator it = m_columns.find(name);
+  if (it == m_columns.end() || it->second->type != type) return 0;
+
+  count = it->second->count;
+  return (char const *)m_header + it->second->offset;
+
+}//end of ColumnarReader::GetColumn method.
+
+//
+// ColumnarReader::elementSize
+//
+uint32_t ColumnarReader::elementSize(char type) {
+
+  switch (type) {
+    case 'i': return sizeof(int32_t);
+    case 'l': return sizeof(uint64_t);
+    case 'd': return sizeof(double);
+    case 'c': return sizeof(char);
+  }
+
+  return 0;
+
+}//end of ColumnarReader::elementSize method.
+
+//
+// ColumnarReader::frameColumn
+//
+void const * ColumnarReader::frameColumn(const char * name, char type, int64_t extra) {
+
+  int64_t count = 0;
+  void const * p = GetColumn(name, type, count);
+  return (count == GetNFrames() + extra) ? p : 0;
+
+}//end of ColumnarReader::frameColumn method.
+
+//
+// ColumnarReader::unmap
+//
+void ColumnarReader::unmap() {
+
+  if (m_header) munmap((void *)m_header, m_size);
+
+  m_header = 0;
+  m_columns.clear();
+
+}//end of ColumnarReader::unmap method.
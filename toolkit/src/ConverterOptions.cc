@@ -0,0 +1,357 @@
+/// @file ConverterOptions.cc
+/// @brief Implementation of the ConverterOptions class.
+
+#include <stdlib.h>
+
+#include "RVersion.h"
+#include "TTree.h"
+
+#include "ConverterOptions.h"
+#include "ZoneMap.h"
+
+namespace {
+
+  /// @brief Read a --zone-cut value, QUANTITY:MIN:MAX ("*" for no limit).
+  ///
+  /// @param [in] value The option value.
+  /// @param [out] cut The cut.
+  /// @return Was the value understood?
+  Bool_t readZoneCut(TString const & value, ConverterOptions::ZoneCut & cut) {
+    Ssiz_t a = value.Index(":");
+    Ssiz_t b = (a == kNPOS) ? kNPOS : value.Index(":", a + 1);
+    if (b == kNPOS) return false;
+    TString q  = value(0, a);
+    TString lo = value(a + 1, b - a - 1);
+    TString hi = value(b + 1, value.Length() - b - 1);
+    cut.q  = ZoneMap::FindQuantity(q);
+    cut.lo = (lo == "*") ? -1e300 : atof(lo.Data());
+    cut.hi = (hi == "*") ?  1e300 : atof(hi.Data());
+    return cut.q >= 0 && lo != "" && hi != "" && (lo == "*" || lo.IsFloat()) &&
+           (hi == "*" || hi.IsFloat());
+  }
+
+}
+
+//
+// ConverterOptions constructor
+//
+ConverterOptions::ConverterOptions()
+:
+  shmRing(""),
+  shmRingSlots(64),
+  shmRingMaxPixels(65536),
+  readThreads(0),
+  readWindowMB(256),
+  blobFinderEvery(0),
+  clusterThreads(0),
+  clusterBuffers(64),
+  classify(false),
+  cutTable(""),
+  asyncWrite(false),
+  writeBuffers(2),
+  writeThreads(0),
+  compression(""),
+  compressionLevel(-1),
+  basketSize(128000),
+  autoFlush(-30000000),
+  autoSave(-300000000),
+  fileSizeMB(0),
+  shardWriters(0),
+  outputFormat("root")
+{}
+
+//
+// ConverterOptions::Parse
+//
+Bool_t ConverterOptions::Parse(int & argc, char ** argv) {
+
+  Bool_t ok = true;
+  Bool_t autoSaveGiven = false;
+
+  int npositional = 1;
+
+  for (int i = 1; i < argc; ++i) {
+
+    TString arg = argv[i];
+
+    // Positional arguments are kept, in order.
+    if (!arg.BeginsWith("--")) {
+      argv[npositional++] = argv[i];
+      continue;
+    }
+
+    Ssiz_t eq = arg.Index("=");
+    TString name  = (eq == kNPOS) ? arg(2, arg.Length()-2) : arg(2, eq-2);
+    TString value = (eq == kNPOS) ? TString("")            : arg(eq+1, arg.Length()-eq-1);
+
+    if (name == "shm-ring") {
+      shmRing = value;
+    } else if (name == "shm-ring-slots") {
+      shmRingSlots = atoi(value.Data());
+    } else if (name == "shm-ring-max-pixels") {
+      shmRingMaxPixels = atoi(value.Data());
+    } else if (name == "read-threads") {
+      readThreads = atoi(value.Data());
+    } else if (name == "read-window") {
+      readWindowMB = atoi(value.Data());
+    } else if (name == "blobfinder-every") {
+      blobFinderEvery = atoi(value.Data());
+    } else if (name == "cluster-threads") {
+      clusterThreads = atoi(value.Data());
+    } else if (name == "cluster-buffers") {
+      clusterBuffers = atoi(value.Data());
+    } else if (name == "classify") {
+      classify = (value == "" || value == "1" || value == "true");
+    } else if (name == "cut-table") {
+      cutTable = value;
+      if (cutTable != "") classify = true;
+    } else if (name == "zone-cut") {
+      ZoneCut cut;
+      if (readZoneCut(value, cut)) {
+        zoneCuts.push_back(cut);
+      } else {
+        cout << "ERROR: --zone-cut needs QUANTITY:MIN:MAX, not '" << value << "'" << endl;
+        ok = false;
+      }
+    } else if (name == "async-write") {
+      asyncWrite = (value == "" || value == "1" || value == "true");
+    } else if (name == "write-buffers") {
+      writeBuffers = atoi(value.Data());
+    } else if (name == "write-threads") {
+      writeThreads = atoi(value.Data());
+    } else if (name == "compression") {
+      compression = value;
+      compression.ToLower();
+    } else if (name == "compression-level") {
+      // Anything but a plain number (e.g. -1) is out of range, not unset.
+      compressionLevel = value.IsDigit() ? atoi(value.Data()) : 0;
+    } else if (name == "basket-size") {
+      basketSize = atoi(value.Data());
+    } else if (name == "auto-flush") {
+      autoFlush = atoll(value.Data());
+    } else if (name == "auto-save") {
+      autoSave = atoll(value.Data());
+      autoSaveGiven = true;
+    } else if (name == "file-size") {
+      fileSizeMB = atoi(value.Data());
+    } else if (name == "shard-writers") {
+      shardWriters = atoi(value.Data());
+    } else if (name == "format") {
+      outputFormat = value;
+      outputFormat.ToLower();
+    } else {
+      cout << "ERROR: unknown option '" << arg << "'" << endl;
+      ok = false;
+    }
+
+  }//end of loop over the arguments.
+
+  argc = npositional;
+  argv[argc] = 0;
+
+  if (shmRingSlots < 1 || shmRingMaxPixels < 1) {
+    cout << "ERROR: the shared-memory ring needs at least one slot and pixel." << endl;
+    ok = false;
+  }
+
+  if (readThreads < 0) {
+    cout << "ERROR: the number of reader threads can't be negative." << endl;
+    ok = false;
+  }
+
+  if (readWindowMB < 1) {
+    cout << "ERROR: the read window must be at least 1 MB." << endl;
+    ok = false;
+  }
+
+  if (blobFinderEvery < 0) {
+    cout << "ERROR: the BlobFinder check interval can't be negative." << endl;
+    ok = false;
+  }
+
+  if (clusterThreads < 0) {
+    cout << "ERROR: the number of clustering threads can't be negative." << endl;
+    ok = false;
+  }
+
+  if (clusterBuffers < 1) {
+    cout << "ERROR: the clustering threads need at least one buffer." << endl;
+    ok = false;
+  }
+
+  if (writeBuffers < 1) {
+    cout << "ERROR: the asynchronous writer needs at least one buffer." << endl;
+    ok = false;
+  }
+
+  if (writeThreads < 0) {
+    cout << "ERROR: the number of writer threads can't be negative." << endl;
+    ok = false;
+  }
+
+  if (compression != "" && compression != "none" && compression != "zlib" &&
+      compression != "lzma" && compression != "lz4" && compression != "zstd") {
+    cout << "ERROR: unknown compression codec '" << compression << "'" << endl;
+    ok = false;
+  }
+#if ROOT_VERSION_CODE < ROOT_VERSION(6,12,0)
+  if (compression == "lz4") {
+    cout << "ERROR: LZ4 compression needs ROOT 6.12 or later." << endl;
+    ok = false;
+  }
+#endif
+#if ROOT_VERSION_CODE < ROOT_VERSION(6,20,0)
+  if (compression == "zstd") {
+    cout << "ERROR: ZSTD compression needs ROOT 6.20 or later." << endl;
+    ok = false;
+  }
+#endif
+
+  if (compressionLevel != -1 && (compressionLevel < 1 || compressionLevel > 9)) {
+    cout << "ERROR: the compression level must be between 1 and 9." << endl;
+    ok = false;
+  }
+
+  // ROOT's default codec varies between versions, so a level needs
+  // the codec it applies to.
+  if (compressionLevel >= 0 && (compression == "" || compression == "none")) {
+    cout << "ERROR: --compression-level needs a codec (--compression=CODEC)." << endl;
+    ok = false;
+  }
+
+  // The parallel writer's threads each fill a tree in memory that is
+  // written whole with every block, so there is no tree to auto-save.
+  if (writeThreads > 0 && autoSaveGiven) {
+    cout << "ERROR: --auto-save can't be used with --write-threads." << endl;
+    ok = false;
+  }
+
+  if (basketSize < 1) {
+    cout << "ERROR: the basket size must be positive." << endl;
+    ok = false;
+  }
+
+  if (fileSizeMB < 0) {
+    cout << "ERROR: the output file size can't be negative." << endl;
+    ok = false;
+  }
+
+  if (shardWriters < 0) {
+    cout << "ERROR: the number of shard writers can't be negative." << endl;
+    ok = false;
+  }
+
+  // A file's frames must be known before it is handed to its writer,
+  // but the compressed size is only known once they are written.
+  if (shardWriters > 0 && fileSizeMB > 0) {
+    cout << "ERROR: --shard-writers can't be used with --file-size." << endl;
+    ok = false;
+  }
+
+  if (outputFormat != "root" && outputFormat != "columnar" && outputFormat != "both" &&
+      outputFormat != "rntuple") {
+    cout << "ERROR: unknown output format '" << outputFormat << "'" << endl;
+    ok = false;
+  }
+#if ROOT_VERSION_CODE < ROOT_VERSION(6,34,0)
+  if (outputFormat == "rntuple") {
+    cout << "ERROR: RNTuple output needs ROOT 6.34 or later." << endl;
+    ok = false;
+  }
+#endif
+
+  return ok;
+
+}//end of ConverterOptions::Parse method.
+
+//
+// ConverterOptions::PrintUsage
+//
+void ConverterOptions::PrintUsage() {
+
+  cout
+    << "Options:" << endl
+    << "  --shm-ring=NAME             Publish each frame to the shared-memory"   << endl
+    << "                              ring NAME (e.g. /cernatschool)."          << endl
+    << "  --shm-ring-slots=N          Frames held in the ring (default 64)."    << endl
+    << "  --shm-ring-max-pixels=N     Pixels stored per frame (default 65536)." << endl
+    << "  --read-threads=N            Parse the input on N threads (cluster"     << endl
+    << "                              logs only; default: line by line)."        << endl
+    << "  --read-window=MB            Input mapped at once by the parsing"       << endl
+    << "                              threads (default 256 MB)."                 << endl
+    << "  --blobfinder-every=N        Re-cluster every Nth frame to check the"   << endl
+    << "                              file's clusters (default: never)."         << endl
+    << "  --cluster-threads=N         Cluster the frames on N threads"           << endl
+    << "                              (Mf-cluster; default: one per core)."      << endl
+    << "  --cluster-buffers=N         Frames held by the clustering threads"     << endl
+    << "                              (default 64)."                             << endl
+    << "  --classify                  Classify each frame's clusters, written"  << endl
+    << "                              to DATASET_N.clusters.root (converters)."  << endl
+    << "  --cut-table=PATH            The cluster classes' cuts (implies"        << endl
+    << "                              --classify; default: rate-plotter.py's)."  << endl
+    << "  --zone-cut=Q:MIN:MAX        Only read the frames with MIN <= Q <= MAX"  << endl
+    << "                              (* for no limit; Q: startTime, occupancy," << endl
+    << "                              totalToT, latitude, longitude, altitude"   << endl
+    << "                              or HV). May be repeated (Mf-cluster)."     << endl
+    << "  --async-write               Fill and write the ntuple on a separate"  << endl
+    << "                              thread while the next frames are read."   << endl
+    << "  --write-buffers=N           Frames queued for the writer (default 2)." << endl
+    << "  --write-threads=N           Fill and compress the ntuple on N threads" << endl
+    << "                              merged into the one output file."          << endl
+    << "  --compression=CODEC         none, zlib, lzma, lz4 or zstd"             << endl
+    << "                              (default: ROOT's default)."                << endl
+    << "  --compression-level=N       Compression level, 1-9 (with"              << endl
+    << "                              --compression)."                           << endl
+    << "  --basket-size=N             Branch basket size (default 128000 bytes)." << endl
+    << "  --auto-flush=N              Flush baskets every N entries (N > 0) or"  << endl
+    << "                              -N bytes (default -30000000). With"        << endl
+    << "                              --write-threads, N > 0 is the frames per"  << endl
+    << "                              thread block, at most 4096 (-N bytes"      << endl
+    << "                              isn't used)."                              << endl
+    << "  --auto-save=N               Save the tree header every N entries or"   << endl
+    << "                              -N bytes (default -300000000; not with"    << endl
+    << "                              --write-threads)."                         << endl
+    << "  --file-size=MB              Start a new output file after MB of"       << endl
+    << "                              compressed data (default: no limit)."      << endl
+    << "  --shard-writers=N           Write up to N output files at once, each" << endl
+    << "                              on its own thread (not with --file-size)." << endl
+    << "  --format=FORMAT             root, columnar (mmap-able .mpxc files),"   << endl
+    << "                              both, or rntuple (default root)."          << endl
+    << endl;
+
+}//end of ConverterOptions::PrintUsage method.
+
+//
+// ConverterOptions::GetCompressionSettings
+//
+Int_t ConverterOptions::GetCompressionSettings() const {
+
+  if (compression == "")     return -1;
+  if (compression == "none") return 0;
+
+  // The algorithm numbers (ROOT::ECompressionAlgorithm) and the
+  // default level of each codec (ROOT::RCompressionSetting).
+  Int_t algorithm = 1, level = 1;
+  if      (compression == "zlib") { algorithm = 1; level = 1; }
+  else if (compression == "lzma") { algorithm = 2; level = 7; }
+  else if (compression == "lz4")  { algorithm = 4; level = 4; }
+  else if (compression == "zstd") { algorithm = 5; level = 5; }
+
+  if (compressionLevel >= 0) level = compressionLevel;
+
+  // Level 0 means no compression whatever the algorithm.
+  if (level == 0) return 0;
+
+  return 100*algorithm + level;
+
+}//end of ConverterOptions::GetCompressionSettings method.
+
+//
+// ConverterOptions::ConfigureTree
+//
+void ConverterOptions::ConfigureTree(TTree * tree) const {
+
+  tree->SetAutoFlush(autoFlush);
+  tree->SetAutoSave(autoSave);
+
+}//end of ConverterOptions::ConfigureTree method.
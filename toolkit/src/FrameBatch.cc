@@ -0,0 +1,145 @@
+/// @file FrameBatch.cc
+/// @brief Implementation of the FrameBatch class.
+
+#include "FrameBatch.h"
+
+//
+// FrameBatch constructor
+//
+FrameBatch::FrameBatch(UInt_t capacity)
+:
+  m_capacity(capacity > 0 ? capacity : 1),
+  m_nFrames(0)
+{
+
+  m_offsets.reserve(m_capacity + 1);
+  m_lvl1Offsets.reserve(m_capacity + 1);
+  m_idOffsets.reserve(m_capacity + 1);
+  m_entry.reserve(m_capacity);
+  m_frameId.reserve(m_capacity);
+  m_startTime.reserve(m_capacity);
+  m_acqTime.reserve(m_capacity);
+  m_width.reserve(m_capacity);
+  m_height.reserve(m_capacity);
+  m_totalToT.reserve(m_capacity);
+  m_maxToT.reserve(m_capacity);
+  m_nClusters.reserve(m_capacity);
+
+  // The metadata slots are reused from batch to batch.
+  m_meta.resize(m_capacity);
+
+  Clear();
+
+}//end of FrameBatch constructor.
+
+//
+// FrameBatch::Clear
+//
+void FrameBatch::Clear() {
+
+  m_nFrames = 0;
+
+  m_offsets.assign(1, 0);
+  m_lvl1Offsets.assign(1, 0);
+  m_idOffsets.assign(1, 0);
+  m_pixelX.clear();
+  m_pixelC.clear();
+  m_lvl1X.clear();
+  m_lvl1V.clear();
+  m_clusterIds.clear();
+
+  m_entry.clear();
+  m_frameId.clear();
+  m_startTime.clear();
+  m_acqTime.clear();
+  m_width.clear();
+  m_height.clear();
+  m_totalToT.clear();
+  m_maxToT.clear();
+  m_nClusters.clear();
+
+}//end of FrameBatch::Clear method.
+
+//
+// FrameBatch::AddFrame
+//
+Bool_t FrameBatch::AddFrame(FrameStruct & frame, Long64_t entry) {
+
+  if (IsFull()) return false;
+
+  // Append the payload to the pixel arrays.
+  map<int,int> const & pixels = frame.GetPixelCounts();
+  map<int,int>::const_iterator it;
+  for (it = pixels.begin(); it != pixels.end(); ++it) {
+    m_pixelX.push_back(it->first);
+    m_pixelC.push_back(it->second);
+  }
+  m_offsets.push_back(m_pixelX.size());
+
+  map<int,int> const & lvl1 = frame.GetLVL1();
+  for (it = lvl1.begin(); it != lvl1.end(); ++it) {
+    m_lvl1X.push_back(it->first);
+    m_lvl1V.push_back(it->second);
+  }
+  m_lvl1Offsets.push_back(m_lvl1X.size());
+
+  // The cluster IDs, if every pixel has one (in the same order).
+  if (frame.HasClusterIds()) {
+    map<int,int> const & ids = frame.GetClusterIds();
+    for (it = ids.begin(); it != ids.end(); ++it) m_clusterIds.push_back(it->second);
+  }
+  m_idOffsets.push_back(m_clusterIds.size());
+
+  // The per-frame columns.
+  m_entry.push_back(entry);
+  m_frameId.push_back(frame.GetFrameId());
+  m_startTime.push_back(frame.GetStartTime());
+  m_acqTime.push_back(frame.GetAcqTime());
+  m_width.push_back(frame.GetFrameWidth());
+  m_height.push_back(frame.GetFrameHeight());
+  m_totalToT.push_back(frame.GetTotalToT());
+  m_maxToT.push_back(frame.GetMaxToT());
+  m_nClusters.push_back(frame.GetNClusters());
+
+  // Keep the rest of the metadata. The pixel maps are swapped out
+  // while copying so that only the metadata is copied.
+  FrameContainer payload;
+  frame.SwapPayload(payload);
+  m_meta[m_nFrames] = frame;
+  frame.SwapPayload(payload);
+
+  m_nFrames++;
+
+  return true;
+
+}//end of FrameBatch::AddFrame method.
+
+//
+// FrameBatch::GetFrame
+//
+void FrameBatch::GetFrame(UInt_t i, FrameStruct & frame) const {
+
+  if (i >= m_nFrames) {
+    cout << "ERROR: frame " << i << " requested from a batch of "
+         << m_nFrames << " frames." << endl;
+    return;
+  }
+
+  // The metadata (with empty pixel maps)...
+  frame = m_meta[i];
+
+  // ...then the payload from the arrays.
+  UInt_t b = m_offsets[i], n = m_offsets[i+1] - b;
+  frame.SetPixelCounts(n > 0 ? &m_pixelX[b] : 0, n > 0 ? &m_pixelC[b] : 0, n);
+
+  b = m_lvl1Offsets[i]; n = m_lvl1Offsets[i+1] - b;
+  frame.SetLVL1Map(n > 0 ? &m_lvl1X[b] : 0, n > 0 ? &m_lvl1V[b] : 0, n);
+
+  if (HasClusterIds(i)) {
+    b = m_offsets[i]; n = m_offsets[i+1] - b;
+    frame.SetClusterIds(&m_pixelX[b], GetClusterIds(i), n);
+  }
+
+  frame.SetNClusters(m_nClusters[i]);
+
+}//end of FrameBatch::GetFrame method.
@@ -0,0 +1,319 @@
+/// @file FrameIndex.cc
+/// @brief Implementation of the FrameIndex class.
+
+// Standard include statements.
+#include <algorithm>
+#include <string.h>
+
+// ROOT include statements.
+#include "TDirectory.h"
+#include "TTree.h"
+
+// Local include statements.
+#include "FrameIndex.h"
+#include "Frames.h"
+
+namespace {
+
+  /// @brief The longest dataset ID stored in the ID index.
+  const Int_t kMaxDataSetLength = 256;
+
+}
+
+//
+// FrameIndex constructor
+//
+FrameIndex::FrameIndex() {}
+
+//
+// FrameIndex destructor
+//
+FrameIndex::~FrameIndex() {}
+
+//
+// FrameIndex::Add
+//
+void FrameIndex::Add(FrameStruct & frame) {
+
+  TString dataset = frame.GetDataSet();
+
+  // Frames nearly always come from the dataset seen last.
+  Int_t d = m_datasets.empty() ? -1 : (Int_t)m_datasets.size() - 1;
+  if (d < 0 || m_datasets[d] != dataset) {
+    d = findDataset(dataset);
+    if (d < 0) {
+      m_datasets.push_back(dataset);
+      d = (Int_t)m_datasets.size() - 1;
+    }
+  }
+
+  Long64_t entry = (Long64_t)m_time.size();
+
+  TimeKey tk = { frame.GetStartTime(), entry };
+  IdKey   ik = { d, frame.GetFrameId(), entry };
+
+  // The frames usually arrive in order, so the keys usually go on the
+  // end. (After any equal keys, so that they stay in entry order.)
+  m_time.insert(upper_bound(m_time.begin(), m_time.end(), tk, timeLess), tk);
+  m_id.insert(upper_bound(m_id.begin(), m_id.end(), ik, idLess), ik);
+
+}//end of FrameIndex::Add method.
+
+//
+// FrameIndex::Write
+//
+Bool_t FrameIndex::Write(TDirectory * dir) {
+
+  if (!dir) return false;
+
+  sort();
+
+  TDirectory * old = gDirectory;
+  dir->cd();
+
+  Double_t t;
+  Long64_t entry;
+  TTree * ttime = new TTree("MPXTimeIndex", "MPXTree entries by frame start time");
+  ttime->Branch("startTime", &t,     "startTime/D");
+  ttime->Branch("entry",     &entry, "entry/L");
+  for (UInt_t i = 0; i < m_time.size(); ++i) {
+    t     = m_time[i].t;
+    entry = m_time[i].entry;
+    ttime->Fill();
+  }
+
+  Char_t dataset[kMaxDataSetLength];
+  Int_t id;
+  TTree * tid = new TTree("MPXIdIndex", "MPXTree entries by dataset and frame ID");
+  tid->Branch("dataset", dataset, "dataset/C");
+  tid->Branch("frameId", &id,     "frameId/I");
+  tid->Branch("entry",   &entry,  "entry/L");
+  for (UInt_t i = 0; i < m_id.size(); ++i) {
+    strncpy(dataset, m_datasets[m_id[i].dataset].Data(), kMaxDataSetLength - 1);
+    dataset[kMaxDataSetLength - 1] = 0;
+    id    = m_id[i].id;
+    entry = m_id[i].entry;
+    tid->Fill();
+  }
+
+  Bool_t ok = ttime->Write("", TObject::kOverwrite) > 0 &&
+              tid->Write("", TObject::kOverwrite) > 0;
+
+  // The trees belong to the directory, so they go when it is closed.
+  if (old) old->cd();
+
+  return ok;
+
+}//end of FrameIndex::Write method.
+
+//
+// FrameIndex::Read
+//
+Bool_t FrameIndex::Read(TDirectory * dir) {
+
+  Clear();
+
+  if (!dir) return false;
+
+  TTree * ttime = (TTree*)dir->Get("MPXTimeIndex");
+  TTree * tid   = (TTree*)dir->Get("MPXIdIndex");
+  if (!ttime || !tid || ttime->GetEntries() != tid->GetEntries()) {
+    cout << "ERROR: no frame index in '" << dir->GetName() << "'" << endl;
+    return false;
+  }
+
+  Long64_t n = ttime->GetEntries();
+  m_time.resize(n);
+  m_id.resize(n);
+
+  Double_t t;
+  Long64_t entry;
+  ttime->SetBranchAddress("startTime", &t);
+  ttime->SetBranchAddress("entry",     &entry);
+  for (Long64_t i = 0; i < n; ++i) {
+    ttime->GetEntry(i);
+    m_time[i].t     = t;
+    m_time[i].entry = entry;
+  }
+
+  // The ID index is sorted by dataset, so each new ID starts a group.
+  Char_t dataset[kMaxDataSetLength];
+  Int_t id;
+  tid->SetBranchAddress("dataset", dataset);
+  tid->SetBranchAddress("frameId", &id);
+  tid->SetBranchAddress("entry",   &entry);
+  for (Long64_t i = 0; i < n; ++i) {
+    tid->GetEntry(i);
+    if (m_datasets.empty() || m_datasets.back() != dataset) {
+      m_datasets.push_back(dataset);
+    }
+    m_id[i].dataset = (Int_t)m_datasets.size() - 1;
+    m_id[i].id      = id;
+    m_id[i].entry   = entry;
+  }
+
+  ttime->ResetBranchAddresses();
+  tid->ResetBranchAddresses();
+
+  // The index is written sorted, but an index from elsewhere may not be.
+  sort();
+
+  return true;
+
+}//end of FrameIndex::Read method.
+
+//
+// FrameIndex::Append
+//
+void FrameIndex::Append(FrameIndex const & other) {
+
+  if (other.m_time.empty()) return;
+
+  Long64_t offset = GetNEntries();
+
+  for (UInt_t i = 0; i < other.m_time.size(); ++i) {
+    TimeKey tk = { other.m_time[i].t, other.m_time[i].entry + offset };
+    m_time.push_back(tk);
+  }
+
+  // The dataset positions differ between the two indices.
+  vector<Int_t> datasets(other.m_datasets.size());
+  for (UInt_t d = 0; d < other.m_datasets.size(); ++d) {
+    datasets[d] = findDataset(other.m_datasets[d]);
+    if (datasets[d] < 0) {
+      m_datasets.push_back(other.m_datasets[d]);
+      datasets[d] = (Int_t)m_datasets.size() - 1;
+    }
+  }
+
+  for (UInt_t i = 0; i < other.m_id.size(); ++i) {
+    IdKey ik = { datasets[other.m_id[i].dataset], other.m_id[i].id, other.m_id[i].entry + offset };
+    m_id.push_back(ik);
+  }
+
+  sort();
+
+}//end of FrameIndex::Append method.
+
+//
+// FrameIndex::Clear
+//
+void FrameIndex::Clear() {
+
+  m_time.clear();
+  m_id.clear();
+  m_datasets.clear();
+
+}//end of FrameIndex::Clear method.
+
+//
+// FrameIndex::FindTime
+//
+Long64_t FrameIndex::FindTime(Double_t t) const {
+
+  // The first frame started after t...
+  vector<TimeKey>::const_iterator it = upper_bound(
+    m_time.begin(), m_time.end(), t,
+    [](Double_t v, TimeKey const & k) { return v < k.t; });
+
+  // ...follows the one running at t.
+  if (it == m_time.begin()) return -1;
+  return (it - 1)->entry;
+
+}//end of FrameIndex::FindTime method.
+
+//
+// FrameIndex::GetTimeWindow
+//
+void FrameIndex::GetTimeWindow(Double_t t0, Double_t t1, vector<Long64_t> & entries) const {
+
+  entries.clear();
+
+  vector<TimeKey>::const_iterator first = lower_bound(
+    m_time.begin(), m_time.end(), t0,
+    [](TimeKey const & k, Double_t v) { return k.t < v; });
+  vector<TimeKey>::const_iterator last = lower_bound(
+    first, m_time.cend(), t1,
+    [](TimeKey const & k, Double_t v) { return k.t < v; });
+
+  for (vector<TimeKey>::const_iterator it = first; it < last; ++it) {
+    entries.push_back(it->entry);
+  }
+
+  // Reading the tree in entry order avoids going back over baskets.
+  std::sort(entries.begin(), entries.end());
+
+}//end of FrameIndex::GetTimeWindow method.
+
+//
+// FrameIndex::FindFrame
+//
+Long64_t FrameIndex::FindFrame(Int_t frameId, TString dataset) const {
+
+  Int_t dfirst = 0, dlast = (Int_t)m_datasets.size() - 1;
+  if (dataset != "") {
+    dfirst = dlast = findDataset(dataset);
+    if (dfirst < 0) return -1;
+  }
+
+  for (Int_t d = dfirst; d <= dlast; ++d) {
+    IdKey key = { d, frameId, -1 };
+    vector<IdKey>::const_iterator it = lower_bound(m_id.begin(), m_id.end(), key, idLess);
+    if (it != m_id.end() && it->dataset == d && it->id == frameId) return it->entry;
+  }
+
+  return -1;
+
+}//end of FrameIndex::FindFrame method.
+
+//
+// FrameIndex::GetTimeOrder
+//
+void FrameIndex::GetTimeOrder(vector<Long64_t> & entries) const {
+
+  entries.resize(m_time.size());
+  for (UInt_t i = 0; i < m_time.size(); ++i) entries[i] = m_time[i].entry;
+
+}//end of FrameIndex::GetTimeOrder method.
+
+//
+// FrameIndex::GetTimeRange
+//
+Bool_t FrameIndex::GetTimeRange(Double_t & tmin, Double_t & tmax) const {
+
+  if (m_time.empty()) return false;
+
+  tmin = m_time.front().t;
+  tmax = m_time.back().t;
+
+  return true;
+
+}//end of FrameIndex::GetTimeRange method.
+
+//
+// FrameIndex::sort
+//
+void FrameIndex::sort() {
+
+  // Stable, so that frames with the same key stay in entry order.
+  if (!is_sorted(m_time.begin(), m_time.end(), timeLess)) {
+    stable_sort(m_time.begin(), m_time.end(), timeLess);
+  }
+  if (!is_sorted(m_id.begin(), m_id.end(), idLess)) {
+    stable_sort(m_id.begin(), m_id.end(), idLess);
+  }
+
+}//end of FrameIndex::sort method.
+
+//
+// FrameIndex::findDataset
+//
+Int_t FrameIndex::findDataset(TString const & dataset) const {
+
+  for (UInt_t i = 0; i < m_datasets.size(); ++i) {
+    if (m_datasets[i] == dataset) return (Int_t)i;
+  }
+
+  return -1;
+
+}//end of FrameIndex::findDataset method.
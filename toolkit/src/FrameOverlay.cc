@@ -0,0 +1,345 @@
+/// @file FrameOverlay.cc
+/// @brief Implementation of the FrameOverlay class.
+
+// Standard include statements.
+#include <map>
+#include <string.h>
+
+// ROOT include statements.
+#include "TDirectory.h"
+#include "TTree.h"
+
+// Local include statements.
+#include "FrameOverlay.h"
+#include "Frames.h"
+
+namespace {
+
+  /// @brief Copy a TString into a fixed-size buffer.
+  void copyString(Char_t * dest, TString const & s) {
+    strncpy(dest, s.Data(), 255);
+    dest[255] = 0;
+  }
+
+}
+
+//
+// FrameOverlay constructor
+//
+FrameOverlay::FrameOverlay()
+:
+  m_fields(0),
+  m_in(0),
+  m_out(0),
+  m_dir(0),
+  m_mcData(false),
+  m_frameId(0),
+  m_maskWidth(-1)
+{
+
+  m_dataSet[0] = m_customName[0] = m_appFilters[0] = m_sourceId[0] = 0;
+  for (Int_t i = 0; i < 3; ++i) {
+    m_position[i] = m_attitude[i] = m_omega[i] = m_detPosition[i] = m_euler[i] = 0.;
+  }
+
+}//end of FrameOverlay constructor.
+
+//
+// FrameOverlay destructor
+//
+FrameOverlay::~FrameOverlay() {
+
+  // The trees belong to their files.
+
+}//end of FrameOverlay destructor.
+
+//
+// FrameOverlay::Read
+//
+Bool_t FrameOverlay::Read(TDirectory * dir, Long64_t nentries) {
+
+  m_fields = 0;
+  m_in = 0;
+  m_maskXs.clear();
+  m_maskYs.clear();
+  m_maskVs.clear();
+  m_maskWidth = -1;
+
+  if (!dir) return false;
+
+  m_in = (TTree*)dir->Get("MPXOverlay");
+  if (!m_in) return false;
+
+  if (m_in->GetEntries() != nentries) {
+    cout << "ERROR: the overlay in '" << dir->GetName() << "' has " << m_in->GetEntries()
+         << " entries for " << nentries << " frames; it is ignored." << endl;
+    m_in = 0;
+    return false;
+  }
+
+  // The fields are the branches present.
+  if (m_in->GetBranch("dataSet"))     m_fields |= kDataSet;
+  if (m_in->GetBranch("mcData"))      m_fields |= kMCData;
+  if (m_in->GetBranch("frameId"))     m_fields |= kFrameId;
+  if (m_in->GetBranch("position"))    m_fields |= kPosition;
+  if (m_in->GetBranch("attitude"))    m_fields |= kAttitude;
+  if (m_in->GetBranch("omega"))       m_fields |= kOmega;
+  if (m_in->GetBranch("detPosition")) m_fields |= kDetPosition;
+  if (m_in->GetBranch("euler"))       m_fields |= kEuler;
+  if (m_in->GetBranch("customName"))  m_fields |= kCustomName;
+  if (m_in->GetBranch("appFilters"))  m_fields |= kAppFilters;
+  if (m_in->GetBranch("sourceId"))    m_fields |= kSourceId;
+
+  connect(m_in, false);
+
+  TTree * mask = (TTree*)dir->Get("MPXOverlayMask");
+  if (mask) {
+    Int_t x, y, v;
+    mask->SetBranchAddress("x", &x);
+    mask->SetBranchAddress("y", &y);
+    mask->SetBranchAddress("v", &v);
+    for (Long64_t i = 0; i < mask->GetEntries(); ++i) {
+      mask->GetEntry(i);
+      m_maskXs.push_back(x);
+      m_maskYs.push_back(y);
+      m_maskVs.push_back(v);
+    }
+    mask->ResetBranchAddresses();
+    m_fields |= kLVL1Mask;
+  }
+
+  return true;
+
+}//end of FrameOverlay::Read method.
+
+//
+// FrameOverlay::LoadEntry
+//
+void FrameOverlay::LoadEntry(Long64_t entry) {
+
+  if (m_in) m_in->GetEntry(entry);
+
+}//end of FrameOverlay::LoadEntry method.
+
+//
+// FrameOverlay::Apply
+//
+void FrameOverlay::Apply(FrameStruct & frame) {
+
+  if (m_fields & kDataSet) frame.SetDataSet(m_dataSet);
+  if (m_fields & kMCData) {
+    if (m_mcData) frame.SetFrameAsMCData(); else frame.SetFrameAsData();
+  }
+  if (m_fields & kFrameId) frame.SetId(m_frameId);
+  if (m_fields & kPosition) {
+    frame.SetLatitude(m_position[0]);
+    frame.SetLongitude(m_position[1]);
+    frame.SetAltitude(m_position[2]);
+  }
+  if (m_fields & kAttitude) {
+    frame.SetRoll(m_attitude[0]);
+    frame.SetPitch(m_attitude[1]);
+    frame.SetYaw(m_attitude[2]);
+  }
+  if (m_fields & kOmega) {
+    frame.SetOmega_x(m_omega[0]);
+    frame.SetOmega_y(m_omega[1]);
+    frame.SetOmega_z(m_omega[2]);
+  }
+  if (m_fields & kDetPosition) {
+    frame.SetDet_x(m_detPosition[0]);
+    frame.SetDet_y(m_detPosition[1]);
+    frame.SetDet_z(m_detPosition[2]);
+  }
+  if (m_fields & kEuler) {
+    frame.SetEulerA(m_euler[0]);
+    frame.SetEulerB(m_euler[1]);
+    frame.SetEulerC(m_euler[2]);
+  }
+  if (m_fields & kCustomName) frame.SetCustomName(m_customName);
+  if (m_fields & kAppFilters) frame.SetAppFilters(m_appFilters);
+  if (m_fields & kSourceId)   frame.SetSourceId(m_sourceId);
+
+  if (m_fields & kLVL1Mask) {
+
+    // The mask in X for the frame width, summed and sorted in X as in
+    // FrameContainer::SetLVL1. Recomputed only when the width changes.
+    if (frame.GetFrameWidth() != m_maskWidth) {
+      m_maskWidth = frame.GetFrameWidth();
+      map<int,int> mask;
+      for (UInt_t k = 0; k < m_maskXs.size(); ++k) {
+        mask[m_maskYs[k]*m_maskWidth + m_maskXs[k]] += m_maskVs[k];
+      }
+      m_maskX.clear();
+      m_maskV.clear();
+      map<int,int>::const_iterator it;
+      for (it = mask.begin(); it != mask.end(); ++it) {
+        m_maskX.push_back(it->first);
+        m_maskV.push_back(it->second);
+      }
+    }
+
+    frame.SetLVL1Map(m_maskX.empty() ? 0 : &m_maskX[0],
+                     m_maskV.empty() ? 0 : &m_maskV[0], m_maskX.size());
+  }
+
+}//end of FrameOverlay::Apply method.
+
+//
+// FrameOverlay::BeginWrite
+//
+void FrameOverlay::BeginWrite(TDirectory * dir, UInt_t fields) {
+
+  m_dir = dir;
+  m_fields |= fields;
+
+  TDirectory * old = gDirectory;
+  dir->cd();
+
+  m_out = new TTree("MPXOverlay", "MPXTree metadata overlay");
+  connect(m_out, true);
+
+  if (old) old->cd();
+
+}//end of FrameOverlay::BeginWrite method.
+
+//
+// FrameOverlay::Take
+//
+void FrameOverlay::Take(FrameStruct & frame, UInt_t fields) {
+
+  if (fields & kDataSet) copyString(m_dataSet, frame.GetDataSet());
+  if (fields & kMCData)  m_mcData  = frame.IsMCData();
+  if (fields & kFrameId) m_frameId = frame.GetFrameId();
+  if (fields & kPosition) {
+    m_position[0] = frame.GetLatitude();
+    m_position[1] = frame.GetLongitude();
+    m_position[2] = frame.GetAltitude();
+  }
+  if (fields & kAttitude) {
+    m_attitude[0] = frame.GetRoll();
+    m_attitude[1] = frame.GetPitch();
+    m_attitude[2] = frame.GetYaw();
+  }
+  if (fields & kOmega) {
+    m_omega[0] = frame.GetOmega_x();
+    m_omega[1] = frame.GetOmega_y();
+    m_omega[2] = frame.GetOmega_z();
+  }
+  if (fields & kDetPosition) {
+    m_detPosition[0] = frame.GetDet_x();
+    m_detPosition[1] = frame.GetDet_y();
+    m_detPosition[2] = frame.GetDet_z();
+  }
+  if (fields & kEuler) {
+    m_euler[0] = frame.GetEulerA();
+    m_euler[1] = frame.GetEulerB();
+    m_euler[2] = frame.GetEulerC();
+  }
+  if (fields & kCustomName) copyString(m_customName, frame.GetCustomName());
+  if (fields & kAppFilters) copyString(m_appFilters, frame.GetAppFilters());
+  if (fields & kSourceId)   copyString(m_sourceId,   frame.GetSourceId());
+
+}//end of FrameOverlay::Take method.
+
+//
+// FrameOverlay::SetLVL1Mask
+//
+void FrameOverlay::SetLVL1Mask(vector<Int_t> const & xs,
+                               vector<Int_t> const & ys,
+                               vector<Int_t> const & values) {
+
+  if (ys.size() != xs.size() || values.size() != xs.size()) {
+    cout << "ERROR: mismatched pixel mask arrays." << endl;
+    return;
+  }
+
+  m_maskXs = xs;
+  m_maskYs = ys;
+  m_maskVs = values;
+  m_maskWidth = -1;
+
+  m_fields |= kLVL1Mask;
+
+}//end of FrameOverlay::SetLVL1Mask method.
+
+//
+// FrameOverlay::Fill
+//
+void FrameOverlay::Fill() {
+
+  if (m_out) m_out->Fill();
+
+}//end of FrameOverlay::Fill method.
+
+//
+// FrameOverlay::EndWrite
+//
+Bool_t FrameOverlay::EndWrite() {
+
+  if (!m_out) return false;
+
+  TDirectory * old = gDirectory;
+  m_dir->cd();
+
+  // Replace the old overlay (all of its cycles).
+  Bool_t ok = m_out->Write("", TObject::kOverwrite) > 0;
+
+  if (m_fields & kLVL1Mask) {
+    Int_t x, y, v;
+    TTree * mask = new TTree("MPXOverlayMask", "MPXTree pixel mask overlay");
+    mask->Branch("x", &x, "x/I");
+    mask->Branch("y", &y, "y/I");
+    mask->Branch("v", &v, "v/I");
+    for (UInt_t k = 0; k < m_maskXs.size(); ++k) {
+      x = m_maskXs[k];
+      y = m_maskYs[k];
+      v = m_maskVs[k];
+      mask->Fill();
+    }
+    ok = (mask->Write("", TObject::kOverwrite) > 0) && ok;
+  }
+
+  if (old) old->cd();
+
+  // The new overlay is now the one to read.
+  m_in  = m_out;
+  m_out = 0;
+
+  return ok;
+
+}//end of FrameOverlay::EndWrite method.
+
+//
+// FrameOverlay::connect
+//
+void FrameOverlay::connect(TTree * tree, Bool_t create) {
+
+  if (create) {
+    if (m_fields & kDataSet)     tree->Branch("dataSet",     m_dataSet,     "dataSet/C");
+    if (m_fields & kMCData)      tree->Branch("mcData",      &m_mcData,     "mcData/O");
+    if (m_fields & kFrameId)     tree->Branch("frameId",     &m_frameId,    "frameId/I");
+    if (m_fields & kPosition)    tree->Branch("position",    m_position,    "position[3]/D");
+    if (m_fields & kAttitude)    tree->Branch("attitude",    m_attitude,    "attitude[3]/D");
+    if (m_fields & kOmega)       tree->Branch("omega",       m_omega,       "omega[3]/D");
+    if (m_fields & kDetPosition) tree->Branch("detPosition", m_detPosition, "detPosition[3]/D");
+    if (m_fields & kEuler)       tree->Branch("euler",       m_euler,       "euler[3]/D");
+    if (m_fields & kCustomName)  tree->Branch("customName",  m_customName,  "customName/C");
+    if (m_fields & kAppFilters)  tree->Branch("appFilters",  m_appFilters,  "appFilters/C");
+    if (m_fields & kSourceId)    tree->Branch("sourceId",    m_sourceId,    "sourceId/C");
+    return;
+  }
+
+  if (m_fields & kDataSet)     tree->SetBranchAddress("dataSet",     m_dataSet);
+  if (m_fields & kMCData)      tree->SetBranchAddress("mcData",      &m_mcData);
+  if (m_fields & kFrameId)     tree->SetBranchAddress("frameId",     &m_frameId);
+  if (m_fields & kPosition)    tree->SetBranchAddress("position",    m_position);
+  if (m_fields & kAttitude)    tree->SetBranchAddress("attitude",    m_attitude);
+  if (m_fields & kOmega)       tree->SetBranchAddress("omega",       m_omega);
+  if (m_fields & kDetPosition) tree->SetBranchAddress("detPosition", m_detPosition);
+  if (m_fields & kEuler)       tree->SetBranchAddress("euler",       m_euler);
+  if (m_fields & kCustomName)  tree->SetBranchAddress("customName",  m_customName);
+  if (m_fields & kAppFilters)  tree->SetBranchAddress("appFilters",  m_appFilters);
+  if (m_fields & kSourceId)    tree->SetBranchAddress("sourceId",    m_sourceId);
+
+}//end of FrameOverlay::connect method.
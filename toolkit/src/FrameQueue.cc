@@ -0,0 +1,101 @@
+/// @file FrameQueue.cc
+/// @brief Implementation of the FrameQueue class.
+
+#include "FrameQueue.h"
+
+//
+// FrameQueue constructor
+//
+FrameQueue::FrameQueue(UInt_t nbuffers, TString datasetid)
+:
+  m_closed(false)
+{
+
+  if (nbuffers < 1) nbuffers = 1;
+
+  for (UInt_t i = 0; i < nbuffers; ++i) {
+    FrameStruct * frame = new FrameStruct(datasetid);
+    m_owned.insert(frame);
+    m_free.push_back(frame);
+  }
+
+}//end of FrameQueue constructor.
+
+//
+// FrameQueue destructor
+//
+FrameQueue::~FrameQueue() {
+
+  set<FrameStruct*>::iterator it;
+  for (it = m_owned.begin(); it != m_owned.end(); ++it) delete *it;
+
+}//end of FrameQueue destructor.
+
+//
+// FrameQueue::GetFree
+//
+FrameStruct * FrameQueue::GetFree() {
+
+  unique_lock<mutex> lock(m_mutex);
+  while (m_free.empty()) m_freeCond.wait(lock);
+
+  FrameStruct * frame = m_free.front();
+  m_free.pop_front();
+  return frame;
+
+}//end of FrameQueue::GetFree method.
+
+//
+// FrameQueue::PutFree
+//
+void FrameQueue::PutFree(FrameStruct * frame) {
+
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_free.push_back(frame);
+  }
+  m_freeCond.notify_one();
+
+}//end of FrameQueue::PutFree method.
+
+//
+// FrameQueue::PutFull
+//
+void FrameQueue::PutFull(FrameStruct * frame) {
+
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_full.push_back(frame);
+  }
+  m_fullCond.notify_one();
+
+}//end of FrameQueue::PutFull method.
+
+//
+// FrameQueue::GetFull
+//
+FrameStruct * FrameQueue::GetFull() {
+
+  unique_lock<mutex> lock(m_mutex);
+  while (m_full.empty() && !m_closed) m_fullCond.wait(lock);
+
+  if (m_full.empty()) return 0;
+
+  FrameStruct * frame = m_full.front();
+  m_full.pop_front();
+  return frame;
+
+}//end of FrameQueue::GetFull method.
+
+//
+// FrameQueue::Close
+//
+void FrameQueue::Close() {
+
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_closed = true;
+  }
+  m_fullCond.notify_all();
+
+}//end of FrameQueue::Close method.
@@ -0,0 +1,309 @@
+/// @file FrameRing.cc
+/// @brief Implementation of the shared-memory frame ring classes.
+
+// Standard include statements.
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "FrameRing.h"
+
+namespace {
+
+  /// @brief The size of the fixed part of a slot, rounded up to 64 bytes.
+  inline size_t slotHeaderSize() {
+    return (sizeof(FrameRingSlot) + 63) & ~(size_t)63;
+  }
+
+  /// @brief The offset of the first slot, rounded up to 64 bytes.
+  inline size_t ringHeaderSize() {
+    return (sizeof(FrameRingHeader) + 63) & ~(size_t)63;
+  }
+
+  /// @brief Get slot i of the ring.
+  inline FrameRingSlot * slotAt(FrameRingHeader const * h, ULong64_t i) {
+    return (FrameRingSlot *)((char *)h + ringHeaderSize() + i*h->slotSize);
+  }
+
+  /// @brief Get the pixel X array of a slot.
+  inline Int_t * slotX(FrameRingSlot * s) {
+    return (Int_t *)((char *)s + slotHeaderSize());
+  }
+
+  /// @brief Get the pixel C array of a slot.
+  inline Int_t * slotC(FrameRingSlot * s, UInt_t maxPixels) {
+    return slotX(s) + maxPixels;
+  }
+
+}
+
+//
+// FrameRingWriter constructor
+//
+FrameRingWriter::FrameRingWriter(TString name, UInt_t nSlots, UInt_t maxPixels)
+:
+  m_name(name),
+  m_size(0),
+  m_header(0)
+{
+
+  if (nSlots == 0 || maxPixels == 0) {
+    cout << "ERROR: the frame ring needs at least one slot and pixel." << endl;
+    return;
+  }
+
+  size_t slotSize = slotHeaderSize() + 2*sizeof(Int_t)*(size_t)maxPixels;
+  slotSize = (slotSize + 63) & ~(size_t)63;
+  m_size = ringHeaderSize() + nSlots*slotSize;
+
+  // Replace any ring left behind by an earlier run.
+  shm_unlink(m_name.Data());
+
+  int fd = shm_open(m_name.Data(), O_CREAT | O_RDWR, 0644);
+  if (fd < 0) {
+    cout << "ERROR: could not create the shared-memory ring '" << m_name << "'" << endl;
+    return;
+  }
+
+  if (ftruncate(fd, m_size) != 0) {
+    cout << "ERROR: could not size the shared-memory ring '" << m_name << "'" << endl;
+    close(fd);
+    shm_unlink(m_name.Data());
+    return;
+  }
+
+  void * p = mmap(0, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    cout << "ERROR: could not map the shared-memory ring '" << m_name << "'" << endl;
+    shm_unlink(m_name.Data());
+    return;
+  }
+
+  // The new object is zero filled, so every slot starts at seq = 0.
+  m_header = (FrameRingHeader *)p;
+  m_header->version   = kVersion;
+  m_header->nSlots    = nSlots;
+  m_header->maxPixels = maxPixels;
+  m_header->slotSize  = slotSize;
+  m_header->writeSeq  = 0;
+
+  // Readers check the magic number last.
+  __atomic_store_n(&m_header->magic, kMagic, __ATOMIC_RELEASE);
+
+  cout << "INFO: publishing frames to the shared-memory ring '" << m_name
+       << "' (" << nSlots << " slots)." << endl;
+
+}//end of FrameRingWriter constructor.
+
+//
+// FrameRingWriter destructor
+//
+FrameRingWriter::~FrameRingWriter() {
+
+  if (m_header) {
+    munmap(m_header, m_size);
+    // Readers that are attached keep their mapping.
+    shm_unlink(m_name.Data());
+  }
+
+}//end of FrameRingWriter destructor.
+
+//
+// FrameRingWriter::Publish
+//
+void FrameRingWriter::Publish(FrameStruct & frame) {
+
+  if (!m_header) return;
+
+  ULong64_t n = m_header->writeSeq;
+  FrameRingSlot * s = slotAt(m_header, n % m_header->nSlots);
+
+  // Mark the slot as being written before touching its contents.
+  __atomic_store_n(&s->seq, 2*n + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  s->frameId   = frame.GetFrameId();
+  s->startTime = frame.GetStartTime();
+  s->acqTime   = frame.GetAcqTime();
+  s->latitude  = frame.GetLatitude();
+  s->longitude = frame.GetLongitude();
+  s->altitude  = frame.GetAltitude();
+  s->width     = frame.GetFrameWidth();
+  s->height    = frame.GetFrameHeight();
+  s->totalToT  = frame.GetTotalToT();
+  s->nClusters = frame.GetNClusters();
+  strncpy(s->dataset, frame.GetDataSet().Data(), sizeof(s->dataset) - 1);
+  s->dataset[sizeof(s->dataset) - 1] = '\0';
+
+  map<int,int> const & pixels = frame.GetPixelCounts();
+  Int_t * X = slotX(s);
+  Int_t * C = slotC(s, m_header->maxPixels);
+  UInt_t i = 0;
+  map<int,int>::const_iterator it = pixels.begin();
+  for ( ; it != pixels.end() && i < m_header->maxPixels; ++it, ++i) {
+    X[i] = it->first;
+    C[i] = it->second;
+  }
+  s->nPixels   = i;
+  s->occupancy = pixels.size();
+
+  // Mark the slot as complete, then announce it.
+  __atomic_store_n(&s->seq, 2*n + 2, __ATOMIC_RELEASE);
+  __atomic_store_n(&m_header->writeSeq, n + 1, __ATOMIC_RELEASE);
+
+}//end of FrameRingWriter::Publish method.
+
+//
+// FrameRingReader constructor
+//
+FrameRingReader::FrameRingReader(TString name, Bool_t fromStart)
+:
+  m_size(0),
+  m_header(0),
+  m_cursor(0),
+  m_nDropped(0)
+{
+
+  int fd = shm_open(name.Data(), O_RDONLY, 0);
+  if (fd < 0) {
+    cout << "ERROR: no shared-memory ring called '" << name << "'" << endl;
+    return;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(FrameRingHeader)) {
+    cout << "ERROR: the shared-memory ring '" << name << "' is not ready." << endl;
+    close(fd);
+    return;
+  }
+
+  m_size = st.st_size;
+  void * p = mmap(0, m_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    cout << "ERROR: could not map the shared-memory ring '" << name << "'" << endl;
+    return;
+  }
+
+  FrameRingHeader const * h = (FrameRingHeader const *)p;
+  if (__atomic_load_n(&h->magic, __ATOMIC_ACQUIRE) != FrameRingWriter::kMagic ||
+      h->version != FrameRingWriter::kVersion) {
+    cout << "ERROR: '" << name << "' is not a frame ring (version "
+         << FrameRingWriter::kVersion << ")." << endl;
+    munmap(p, m_size);
+    return;
+  }
+
+  // The slots must fit the pixels and the mapping must hold them all
+  // (a truncated ring would fault in Next()).
+  if (m_size < ringHeaderSize() || h->nSlots == 0 ||
+      h->slotSize < slotHeaderSize() + 2*sizeof(Int_t)*(size_t)h->maxPixels ||
+      h->nSlots > (m_size - ringHeaderSize())/h->slotSize) {
+    cout << "ERROR: the shared-memory ring '" << name << "' is smaller than its "
+         << h->nSlots << " slots of " << h->slotSize << " bytes." << endl;
+    munmap(p, m_size);
+    return;
+  }
+
+  m_header = h;
+
+  ULong64_t head = __atomic_load_n(&m_header->writeSeq, __ATOMIC_ACQUIRE);
+  if (!fromStart) {
+    m_cursor = head;
+  } else if (head > m_header->nSlots) {
+    m_cursor = head - m_header->nSlots;
+  }
+
+}//end of FrameRingReader constructor.
+
+//
+// FrameRingReader destructor
+//
+FrameRingReader::~FrameRingReader() {
+  if (m_header) munmap((void *)m_header, m_size);
+}//end of FrameRingReader destructor.
+
+//
+// FrameRingReader::Next
+//
+Bool_t FrameRingReader::Next(FrameRingFrame & frame, Int_t timeout_ms) {
+
+  if (!m_header) return false;
+
+  Int_t waited_us = 0;
+
+  while (true) {
+
+    ULong64_t head = __atomic_load_n(&m_header->writeSeq, __ATOMIC_ACQUIRE);
+
+    if (m_cursor >= head) {
+      // Nothing new: poll until the timeout.
+      if (waited_us >= 1000*timeout_ms) return false;
+      usleep(200);
+      waited_us += 200;
+      continue;
+    }
+
+    // Skip the frames that have already been overwritten.
+    if (head - m_cursor > m_header->nSlots) {
+      m_nDropped += head - m_header->nSlots - m_cursor;
+      m_cursor = head - m_header->nSlots;
+    }
+
+    FrameRingSlot * s = slotAt(m_header, m_cursor % m_header->nSlots);
+
+    ULong64_t s1 = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+    if (s1 != 2*m_cursor + 2) {
+      // The slot has moved on to a later frame.
+      m_nDropped++;
+      m_cursor++;
+      continue;
+    }
+
+    frame.seq       = m_cursor;
+    frame.frameId   = s->frameId;
+    frame.startTime = s->startTime;
+    frame.acqTime   = s->acqTime;
+    frame.latitude  = s->latitude;
+    frame.longitude = s->longitude;
+    frame.altitude  = s->altitude;
+    frame.width     = s->width;
+    frame.height    = s->height;
+    frame.occupancy = s->occupancy;
+    frame.totalToT  = s->totalToT;
+    frame.nClusters = s->nClusters;
+
+    Char_t dataset[sizeof(s->dataset)];
+    memcpy(dataset, s->dataset, sizeof(dataset));
+    dataset[sizeof(dataset) - 1] = '\0';
+
+    Int_t n = s->nPixels;
+    if (n < 0 || (UInt_t)n > m_header->maxPixels) n = 0;
+    frame.pixelX.resize(n);
+    frame.pixelC.resize(n);
+    if (n > 0) {
+      memcpy(&frame.pixelX[0], slotX(s), n*sizeof(Int_t));
+      memcpy(&frame.pixelC[0], slotC(s, m_header->maxPixels), n*sizeof(Int_t));
+    }
+
+    // Check the writer didn't start on the slot while it was copied.
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    ULong64_t s2 = __atomic_load_n(&s->seq, __ATOMIC_RELAXED);
+
+    m_cursor++;
+
+    if (s2 != s1) {
+      m_nDropped++;
+      continue;
+    }
+
+    frame.dataset = dataset;
+
+    return true;
+
+  }//end of the wait for a frame.
+
+}//end of FrameRingReader::Next method.
@@ -2,6 +2,8 @@
 /// @brief Implementation of the frame container classes.
 
 #include "Frames.h"
+#include "PayloadCodec.h"
+#include "OutputManager.h"
 
 using namespace std;
 
@@ -126,6 +128,107 @@ void FrameContainer::SetLVL1(
 
 }//end of SetLVL1 method.
 
+//
+// FrameContainer::SetClusterId
+//
+void FrameContainer::SetClusterId(Int_t x, Int_t y, Int_t w, Int_t id) {
+
+  // Keep the first cluster given for the pixel.
+  m_clusterIds.insert(make_pair(y*w + x, id));
+
+}//end of SetClusterId method.
+
+//
+// FrameContainer::GetClusters
+//
+UInt_t FrameContainer::GetClusters(vector<Int_t> & offsets, vector<Int_t> & X) {
+
+  offsets.clear();
+  X.clear();
+
+  if (!HasClusterIds()) return 0;
+
+  // Count the pixels in each cluster (a counting sort by cluster ID).
+  Int_t maxId = 0;
+  map<int,int>::const_iterator it;
+  for (it = m_clusterIds.begin(); it != m_clusterIds.end(); ++it) {
+    if (it->second > maxId) maxId = it->second;
+  }
+
+  vector<Int_t> start(maxId + 2, 0);
+  for (it = m_clusterIds.begin(); it != m_clusterIds.end(); ++it) {
+    if (it->second >= 0) ++start[it->second + 1];
+  }
+
+  // Skip any unused IDs.
+  for (Int_t id = 0; id <= maxId; ++id) {
+    if (start[id + 1] > 0) offsets.push_back(start[id]);
+    start[id + 1] += start[id];
+  }
+  offsets.push_back(start[maxId + 1]);
+
+  X.resize(start[maxId + 1]);
+  for (it = m_clusterIds.begin(); it != m_clusterIds.end(); ++it) {
+    if (it->second >= 0) X[start[it->second]++] = it->first;
+  }
+
+  return offsets.size() - 1;
+
+}//end of GetClusters method.
+
+//
+// FrameContainer::SetPixelCounts
+//
+void FrameContainer::SetPixelCounts(Int_t const * X, Int_t const * C, UInt_t n) {
+
+  m_frameXC.clear();
+
+  // The X values are sorted, so each pixel goes on the end of the map.
+  for (UInt_t i = 0; i < n; ++i) {
+    m_frameXC.insert(m_frameXC.end(), make_pair(X[i], C[i]));
+  }
+
+}//end of SetPixelCounts method.
+
+//
+// FrameContainer::SetLVL1Map
+//
+void FrameContainer::SetLVL1Map(Int_t const * X, Int_t const * lvl1, UInt_t n) {
+
+  m_lvl1.clear();
+
+  for (UInt_t i = 0; i < n; ++i) {
+    m_lvl1.insert(m_lvl1.end(), make_pair(X[i], lvl1[i]));
+  }
+
+}//end of SetLVL1Map method.
+
+//
+// FrameContainer::SetPixelEnergies
+//
+void FrameContainer::SetPixelEnergies(Int_t const * X, Double_t const * E, UInt_t n) {
+
+  m_frameXC_E.clear();
+
+  for (UInt_t i = 0; i < n; ++i) {
+    m_frameXC_E.insert(m_frameXC_E.end(), make_pair(X[i], E[i]));
+  }
+
+}//end of SetPixelEnergies method.
+
+//
+// FrameContainer::SetClusterIds
+//
+void FrameContainer::SetClusterIds(Int_t const * X, Int_t const * ids, UInt_t n) {
+
+  m_clusterIds.clear();
+
+  for (UInt_t i = 0; i < n; ++i) {
+    m_clusterIds.insert(m_clusterIds.end(), make_pair(X[i], ids[i]));
+  }
+
+}//end of SetClusterIds method.
+
 //
 // FrameContainer::CleanUpMatrix
 //
@@ -136,6 +239,7 @@ void FrameContainer::CleanUpMatrix() {
   m_lvl1.clear();
   m_frameXC_TruthE.clear();
   m_frameXC_E.clear();
+  m_clusterIds.clear();
 
 }//end of CleanUpMatrix method.
 
@@ -154,6 +258,59 @@ void FrameContainer::ResetCountersPad() {
 
 }//end of ResetCountersPad method.
 
+//
+// FrameContainer::Streamer
+//
+void FrameContainer::Streamer(TBuffer & R__b) {
+
+  if (R__b.IsReading()) {
+
+    UInt_t R__s, R__c;
+    Version_t R__v = R__b.ReadVersion(&R__s, &R__c);
+
+    // Up to version 3 the pixel maps were written member-wise with
+    // the standard ROOT streamer.
+    if (R__v < 4) {
+      R__b.ReadClassBuffer(FrameContainer::Class(), this, R__v, R__s, R__c);
+      m_clusterIds.clear();
+      return;
+    }
+
+    PayloadCodec::ReadPixelMap(R__b, m_frameXC, m_codecBuffer);
+    PayloadCodec::ReadPixelMap(R__b, m_lvl1,    m_codecBuffer);
+    R__b >> m_nEntriesPad;
+    R__b >> m_nHitsInPad;
+    R__b >> m_nChargeInPad;
+    R__b >> m_isMCData;
+    PayloadCodec::ReadEnergyMap(R__b, m_frameXC_TruthE);
+    PayloadCodec::ReadEnergyMap(R__b, m_frameXC_E);
+
+    // The cluster IDs were added in version 5.
+    if (R__v >= 5) PayloadCodec::ReadClusterIds(R__b, m_frameXC, m_clusterIds, m_codecBuffer);
+    else           m_clusterIds.clear();
+
+    R__b.CheckByteCount(R__s, R__c, FrameContainer::IsA());
+
+  } else {
+
+    UInt_t R__c = R__b.WriteVersion(FrameContainer::IsA(), kTRUE);
+
+    PayloadCodec::WritePixelMap(R__b, m_frameXC, m_codecBuffer);
+    PayloadCodec::WritePixelMap(R__b, m_lvl1,    m_codecBuffer);
+    R__b << m_nEntriesPad;
+    R__b << m_nHitsInPad;
+    R__b << m_nChargeInPad;
+    R__b << m_isMCData;
+    PayloadCodec::WriteEnergyMap(R__b, m_frameXC_TruthE);
+    PayloadCodec::WriteEnergyMap(R__b, m_frameXC_E);
+    PayloadCodec::WriteClusterIds(R__b, m_frameXC, m_clusterIds, m_codecBuffer);
+
+    R__b.SetByteCount(R__c, kTRUE);
+
+  }
+
+}//end of FrameContainer::Streamer method.
+
 //
 // FrameStruct constructor.
 //
@@ -193,6 +350,13 @@ void FrameStruct::RewindMetaDataValues() {
   // Pixel-dependent payload information.
   m_occupancy = 0;
   m_occupancyPc = 0.0;
+  m_totalToT  =  0;
+  m_maxToT    =  0;
+  m_xMin      = -1;
+  m_xMax      = -1;
+  m_yMin      = -1;
+  m_yMax      = -1;
+  m_nClusters = -1;
   m_DoseRate           = -1.0;
   m_DoseEquivalentRate = -1.0;
 
@@ -298,6 +462,51 @@ void FrameStruct::UpdateOccupancy() {
  
 }//end of UpdateOccupancy method.
 
+//
+// FrameStruct::UpdateFrameStats
+//
+void FrameStruct::UpdateFrameStats() {
+
+  map<int,int> const & pixels = this->GetPixelCounts();
+
+  Int_t totalToT = 0;
+  Int_t maxToT   = 0;
+  Int_t xMin = -1, xMax = -1;
+
+  // The pixel map is ordered by X = y*width + x, so the y range
+  // comes straight from the first and last entries.
+  Int_t yMin = -1, yMax = -1;
+  if (!pixels.empty() && fWidth > 0) {
+    yMin = pixels.begin()->first  / fWidth;
+    yMax = pixels.rbegin()->first / fWidth;
+    xMin = fWidth;
+  }
+
+  // One pass over the hit pixels for the x range and the ToT counts.
+  map<int,int>::const_iterator it;
+  for (it = pixels.begin(); it != pixels.end(); ++it) {
+    Int_t C = it->second;
+    totalToT += C;
+    if (C > maxToT) maxToT = C;
+    if (fWidth > 0) {
+      Int_t x = it->first % fWidth;
+      if (x < xMin) xMin = x;
+      if (x > xMax) xMax = x;
+    }
+  }//end of loop over the hit pixels.
+
+  m_totalToT = totalToT;
+  m_maxToT   = maxToT;
+  m_xMin     = xMin;
+  m_xMax     = xMax;
+  m_yMin     = yMin;
+  m_yMax     = yMax;
+
+  // The occupancy comes from the same pixel map.
+  this->UpdateOccupancy();
+
+}//end of UpdateFrameStats method.
+
 void FrameStruct::CalculateDoseRates() {
 
   if (GetPixelEnergies().size()==0) {
@@ -1583,7 +1792,7 @@ Bool_t FramesHandler::ProcessMultiframe(
   TString datafile,
   TString dscfile,
   TString idxfile,
-  WriteToNtuple * wte,
+  OutputManager * wte,
   int ftype
   )
 {
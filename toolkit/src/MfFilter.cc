@@ -32,59 +32,41 @@ MfFilter::MfFilter(
 
   map<int,int>::iterator fit = filtermap.begin();
 
-  // Create the first ROOT ntuple file.
-  m_pNt = new TFile(datasetpath, "UPDATE");
-
-  // TODO Handle non-existence of the file...
-
-  // Get the old TTree from the ROOT file.
-  m_pTr = (TTree*)m_pNt->Get("MPXTree");
-
-  // Create the ROOT TTree for the updated version.
-  m_pTrNew = new TTree("MPXTree","Medi/TimePix data");
-
-  // Hang on, shouldn't this be retrieved from the ROOT file?
-  // And then checked against the value supplied in the metadata?
-
-  // Create the frame container.
-  //m_pFrame = new FrameStruct(m_pAddMetadata->GetMPXDataSetNumber());
-  m_pFrame = new FrameStruct();
+  // Open the ntuple file with any existing overlay.
+  m_pReader = new MfReader(datasetpath, "UPDATE");
+  if (!m_pReader->IsOpen()) return;
+
+  // The pixel mask as coordinate arrays.
+  vector<Int_t> maskxs, maskys, maskvs;
+  for (fit=filtermap.begin(); fit!=filtermap.end(); ++fit) {
+    maskxs.push_back(fit->first % 256);
+    maskys.push_back(fit->first / 256);
+    maskvs.push_back(fit->second);
+  }
 
-  // Get the branch for the frame information and set the address.
-  m_pBr = m_pTr->GetBranch("FramesData");
-  m_pBr->SetAddress(&m_pFrame);
+  // The filter name, as held by every frame.
+  FrameStruct filtered;
+  filtered.SetAppFilters(filtername);
 
-  // Create the branch for the new, updated TTree.
-  m_pTrNew->Branch("FramesData", "FrameStruct", &m_pFrame, 128000, 2);
+  FrameOverlay & overlay = m_pReader->GetOverlay();
+  overlay.BeginWrite(m_pReader->GetFile(), FrameOverlay::kAppFilters);
+  overlay.SetLVL1Mask(maskxs, maskys, maskvs);
 
   // Get the number of frames in the file.
-  Int_t nframes = m_pTr->GetEntries();
-
-  // Loop over the frames.
-  for (Int_t i=0; i<nframes; i++) {
-    //cout << "FRAME " << i << endl;
-    m_pTr->LoadTree(i);
-    m_pTr->GetEvent(i);
+  Long64_t nframes = m_pReader->GetEntries();
 
-    m_pFrame->SetAppFilters(filtername);
-
-    // Clear the pixel mask.
-    m_pFrame->ClearLVL1();
-
-    // Loop over the pixels in the mask.
-    for (fit=filtermap.begin(); fit!=filtermap.end(); ++fit) {
-      Int_t x = fit->first % 256;
-      Int_t y = fit->first / 256;
-      //cout << "DEBUG: (x, y) = (" << x << ", " << y << ") => X = " << X << endl;
-      m_pFrame->SetLVL1(x, y, m_pFrame->GetFrameWidth(), fit->second);
-    }
-
-    //break;
-
-    // Fill the branch on the new tree with the new information.
-    m_pTrNew->Fill();
+  // Write an overlay entry per frame, keeping any earlier overlay values.
+  for (Long64_t i = 0; i < nframes; ++i) {
+    overlay.LoadEntry(i);
+    overlay.Take(filtered, FrameOverlay::kAppFilters);
+    overlay.Fill();
   }//end of loop over the frames.
 
+  if (dbg) {
+    cout << "DEBUG: pixel mask of " << maskxs.size() << " pixels set for "
+         << nframes << " frames." << endl;
+  }
+
 }//end of MfFilter constructor.
 
 //
@@ -92,7 +74,8 @@ MfFilter::MfFilter(
 //
 MfFilter::~MfFilter() {
 
-  // Tidy up.
+  // Tidy up (this also closes the file).
+  delete m_pReader;
 
 }//end of the MfFilter destructor.
 
@@ -101,12 +84,12 @@ MfFilter::~MfFilter() {
 //
 void MfFilter::closeNtuple() {
 
-  // Write the TTree contents.
-  m_pTr->Delete("all");
+  if (!m_pReader->IsOpen()) return;
 
-  m_pTrNew->Write();
+  // Write the overlay; MPXTree is left as it is.
+  m_pReader->GetOverlay().EndWrite();
 
   // Close the ntuple file.
-  m_pNt->Close();
+  m_pReader->GetFile()->Close();
 
 }//end of closeNtuple method.
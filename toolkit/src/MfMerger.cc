@@ -0,0 +1,444 @@
+/// @file MfMerger.cc
+/// @brief Implementation of the MfMerger class.
+
+// Standard include statements.
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+
+// ROOT include statements.
+#include "TLeaf.h"
+#include "TBranch.h"
+#include "TObjArray.h"
+#include "TSystem.h"
+
+// Local include statements.
+#include "MfMerger.h"
+#include "MfReader.h"
+#include "FrameIndex.h"
+#include "ZoneMap.h"
+
+namespace {
+
+  /// @brief The memory assumed for reading an RNTuple file [bytes]
+  /// (its page buffers can't be seen from here).
+  const Long64_t kRNTupleReadBytes = 64 << 20;
+
+}
+
+//
+// MfMerger constructor
+//
+MfMerger::MfMerger(TString outputFile, ConverterOptions const & options)
+:
+  m_output(outputFile),
+  m_options(options),
+  m_timeOrder(false),
+  m_memoryMB(512),
+  m_frame(0),
+  m_ownFrame(new FrameStruct()),
+  m_nFrames(0),
+  m_nCopied(0)
+{
+  m_frame = m_ownFrame;
+}
+
+//
+// MfMerger destructor
+//
+MfMerger::~MfMerger() {
+
+  delete m_ownFrame;
+
+}//end of MfMerger destructor.
+
+//
+// MfMerger::Merge
+//
+Bool_t MfMerger::Merge() {
+
+  if (m_inputs.empty()) {
+    cout << "ERROR: no input files to merge." << endl;
+    return false;
+  }
+
+  vector<Input> inputs(m_inputs.size());
+  for (UInt_t i = 0; i < m_inputs.size(); ++i) {
+    inputs[i].path = m_inputs[i];
+    if (!scan(inputs[i])) return false;
+  }
+
+  if (!m_timeOrder) return concatenate(inputs, m_output);
+
+  // Order the inputs by their first frame.
+  stable_sort(inputs.begin(), inputs.end(),
+    [](Input const & a, Input const & b) { return a.tmin < b.tmin; });
+
+  Bool_t inOrder = true;
+  for (UInt_t i = 0; i < inputs.size(); ++i) {
+    if (!inputs[i].sorted || (i > 0 && inputs[i].tmin < inputs[i-1].tmax)) inOrder = false;
+  }
+  if (inOrder) {
+    cout << "INFO: the inputs are already in time order, so they are copied." << endl;
+    return concatenate(inputs, m_output);
+  }
+
+  Long64_t budget = (Long64_t)m_memoryMB << 20;
+
+  vector<TString> temps;
+  Bool_t ok = true;
+
+  for (Int_t pass = 1; ok; ++pass) {
+
+    // Group neighbouring inputs within the budget, at least two at a time.
+    vector< vector<Input> > groups;
+    Long64_t used = 0;
+    for (UInt_t i = 0; i < inputs.size(); ++i) {
+      if (groups.empty() || (used + inputs[i].bytes > budget && groups.back().size() >= 2)) {
+        groups.push_back(vector<Input>());
+        used = 0;
+      }
+      groups.back().push_back(inputs[i]);
+      used += inputs[i].bytes;
+    }
+
+    if (groups.size() == 1) {
+      ok = mergeSorted(groups[0], m_output);
+      break;
+    }
+
+    cout << "INFO: merge pass " << pass << ": " << inputs.size() << " inputs in "
+         << groups.size() << " groups." << endl;
+
+    vector<Input> merged;
+    for (UInt_t g = 0; g < groups.size() && ok; ++g) {
+
+      if (groups[g].size() == 1 && groups[g][0].sorted) {
+        merged.push_back(groups[g][0]);
+        continue;
+      }
+
+      Input run;
+      run.path = TString::Format("%s.pass%d_%d.tmp", m_output.Data(), pass, g);
+      temps.push_back(run.path);
+
+      ok = mergeSorted(groups[g], run.path) && scan(run);
+      merged.push_back(run);
+
+    }
+
+    inputs.swap(merged);
+
+  }//end of loop over the passes.
+
+  for (UInt_t i = 0; i < temps.size(); ++i) gSystem->Unlink(temps[i]);
+
+  return ok;
+
+}//end of MfMerger::Merge method.
+
+//
+// MfMerger::scan
+//
+Bool_t MfMerger::scan(Input & input) {
+
+  MfReader reader(input.path);
+  if (!reader.IsOpen()) return false;
+
+  input.nentries = reader.GetEntries();
+  input.copyable = !reader.IsRNTuple() && reader.GetOverlay().GetFields() == 0;
+  input.sorted   = false;
+  input.tmin     = 0;
+  input.tmax     = 0;
+
+  // The time order kept while merging, one frame, and the buffers of
+  // each branch read.
+  input.bytes = 8 * input.nentries;
+  TTree * tree = reader.GetTree();
+  if (tree && input.nentries > 0) {
+    input.bytes += 2 * tree->GetTotBytes() / input.nentries;
+    TObjArray * leaves = tree->GetListOfLeaves();
+    for (Int_t i = 0; i < leaves->GetEntries(); ++i) {
+      input.bytes += ((TLeaf*)leaves->At(i))->GetBranch()->GetBasketSize();
+    }
+  } else {
+    input.bytes += kRNTupleReadBytes;
+  }
+
+  if (!m_timeOrder) return true;
+
+  FrameIndex index;
+  vector<Long64_t> order;
+  getTimeOrder(reader, index, order);
+
+  input.sorted = true;
+  for (Long64_t i = 0; i < (Long64_t)order.size(); ++i) {
+    if (order[i] != i) {
+      input.sorted = false;
+      break;
+    }
+  }
+
+  index.GetTimeRange(input.tmin, input.tmax);
+
+  return true;
+
+}//end of MfMerger::scan method.
+
+//
+// MfMerger::getTimeOrder
+//
+void MfMerger::getTimeOrder(MfReader & reader, FrameIndex & index, vector<Long64_t> & order) {
+
+  TFile * file = reader.GetFile();
+
+  Bool_t found = file->GetKey("MPXTimeIndex") && file->GetKey("MPXIdIndex") &&
+                 index.Read(file) && index.GetNEntries() == reader.GetEntries();
+
+  if (!found) {
+
+    // Older files have no index: read the start times.
+    index.Clear();
+    reader.SetMetadataOnly(true);
+    for (Long64_t i = 0; i < reader.GetEntries(); ++i) {
+      FrameStruct * frame = reader.GetFrame(i);
+      if (frame) index.Add(*frame);
+    }
+    reader.SetMetadataOnly(false);
+
+  }
+
+  index.GetTimeOrder(order);
+
+}//end of MfMerger::getTimeOrder method.
+
+//
+// MfMerger::concatenate
+//
+Bool_t MfMerger::concatenate(vector<Input> const & inputs, TString path) {
+
+  m_nFrames = 0;
+  m_nCopied = 0;
+
+  TTree * tree = 0;
+  TFile * file = createOutput(path, tree);
+  if (!file) return false;
+
+  FrameIndex index;
+  ZoneMap zones;
+
+  Bool_t ok = true;
+
+  for (UInt_t i = 0; i < inputs.size() && ok; ++i) {
+
+    MfReader reader(inputs[i].path);
+    if (!reader.IsOpen()) {
+      ok = false;
+      break;
+    }
+
+    Long64_t n = reader.GetEntries();
+    TFile * src = reader.GetFile();
+
+    // Copying the baskets doesn't read the frames, so the index and
+    // zone map come from the input file if it has them...
+    FrameIndex srcIndex;
+    ZoneMap srcZones;
+    Bool_t sidecars = inputs[i].copyable &&
+                      src->GetKey("MPXTimeIndex") && src->GetKey("MPXIdIndex") &&
+                      src->GetKey("MPXZoneMap") &&
+                      srcIndex.Read(src) && srcZones.Read(src) &&
+                      srcIndex.GetNEntries() == n;
+
+    if (inputs[i].copyable) {
+
+      file->cd();
+      Long64_t before = tree->GetEntries();
+      tree->CopyEntries(reader.GetTree(), -1, "fast");
+      if (tree->GetEntries() - before != n) {
+        cout << "ERROR: unable to copy the frames of '" << inputs[i].path << "'" << endl;
+        ok = false;
+        break;
+      }
+      m_nCopied += n;
+
+      if (sidecars) {
+        index.Append(srcIndex);
+        zones.Append(srcZones, n);
+      } else {
+        // ...or, for older files, from the frames themselves.
+        for (Long64_t e = 0; e < n; ++e) {
+          FrameStruct * frame = reader.GetFrame(e);
+          if (!frame) {
+            cout << "ERROR: unable to read frame " << e << " of '" << inputs[i].path << "'" << endl;
+            ok = false;
+            break;
+          }
+          index.Add(*frame);
+          zones.Add(*frame);
+        }
+      }
+
+    } else {
+
+      // A slow copy can reset the branch address.
+      tree->SetBranchAddress("FramesData", &m_frame);
+
+      for (Long64_t e = 0; e < n; ++e) {
+        m_frame = reader.GetFrame(e);
+        if (!m_frame) {
+          cout << "ERROR: unable to read frame " << e << " of '" << inputs[i].path << "'" << endl;
+          ok = false;
+          break;
+        }
+        file->cd();
+        tree->Fill();
+        index.Add(*m_frame);
+        zones.Add(*m_frame);
+      }
+
+      // The reader's frame goes with it.
+      m_frame = m_ownFrame;
+
+    }
+
+    m_nFrames += n;
+
+  }//end of loop over the inputs.
+
+  return closeOutput(file, tree, index, zones) && ok;
+
+}//end of MfMerger::concatenate method.
+
+//
+// MfMerger::mergeSorted
+//
+Bool_t MfMerger::mergeSorted(vector<Input> const & inputs, TString path) {
+
+  m_nFrames = 0;
+  m_nCopied = 0;
+
+  UInt_t k = inputs.size();
+
+  vector<MfReader*>        readers(k, (MfReader*)0);
+  vector<FrameStruct*>     current(k, (FrameStruct*)0);
+  vector< vector<Long64_t> > orders(k);
+  vector<Long64_t>         next(k, 0);
+
+  Bool_t ok = true;
+
+  for (UInt_t i = 0; i < k && ok; ++i) {
+    readers[i] = new MfReader(inputs[i].path);
+    if (!readers[i]->IsOpen()) {
+      ok = false;
+      break;
+    }
+    FrameIndex index;
+    getTimeOrder(*readers[i], index, orders[i]);
+  }
+
+  TTree * tree = 0;
+  TFile * file = ok ? createOutput(path, tree) : 0;
+
+  if (file) {
+
+    FrameIndex index;
+    ZoneMap zones;
+
+    // The next frame of each input, earliest first; ties go to the
+    // first input, so the merge is stable.
+    typedef pair<Double_t, UInt_t> Head;
+    priority_queue< Head, vector<Head>, greater<Head> > heads;
+
+    auto advance = [&](UInt_t i) {
+      while (next[i] < (Long64_t)orders[i].size()) {
+        Long64_t entry = orders[i][next[i]++];
+        current[i] = readers[i]->GetFrame(entry);
+        if (current[i]) {
+          heads.push(Head(current[i]->GetStartTime(), i));
+          return;
+        }
+        cout << "ERROR: unable to read frame " << entry << " of '" << inputs[i].path << "'" << endl;
+        ok = false;
+      }
+      // The input is finished.
+      vector<Long64_t>().swap(orders[i]);
+      delete readers[i];
+      readers[i] = 0;
+    };
+
+    for (UInt_t i = 0; i < k; ++i) advance(i);
+
+    while (!heads.empty()) {
+
+      UInt_t i = heads.top().second;
+      heads.pop();
+
+      m_frame = current[i];
+      file->cd();
+      tree->Fill();
+      index.Add(*m_frame);
+      zones.Add(*m_frame);
+      ++m_nFrames;
+
+      advance(i);
+
+    }
+
+    m_frame = m_ownFrame;
+
+    ok = closeOutput(file, tree, index, zones) && ok;
+
+  }
+
+  for (UInt_t i = 0; i < k; ++i) delete readers[i];
+
+  return file != 0 && ok;
+
+}//end of MfMerger::mergeSorted method.
+
+//
+// MfMerger::createOutput
+//
+TFile * MfMerger::createOutput(TString path, TTree *& tree) {
+
+  TFile * file = new TFile(path, "RECREATE");
+  if (file->IsZombie()) {
+    cout << "ERROR: unable to create '" << path << "'" << endl;
+    delete file;
+    return 0;
+  }
+  if (m_options.GetCompressionSettings() >= 0) {
+    file->SetCompressionSettings(m_options.GetCompressionSettings());
+  }
+
+  m_frame = m_ownFrame;
+
+  tree = new TTree("MPXTree","Medi/TimePix data");
+  m_options.ConfigureTree(tree);
+
+  tree->Branch("FramesData", "FrameStruct", &m_frame, m_options.basketSize, 2);
+
+  return file;
+
+}//end of MfMerger::createOutput method.
+
+//
+// MfMerger::closeOutput
+//
+Bool_t MfMerger::closeOutput(TFile * file, TTree * tree, FrameIndex & index, ZoneMap & zones) {
+
+  file->cd();
+  tree->Write();
+
+  Bool_t ok = index.Write(file);
+  ok = zones.Write(file, tree) && ok;
+
+  // Closing the file deletes the tree.
+  file->Close();
+  delete file;
+
+  return ok;
+
+}//end of MfMerger::closeOutput method.
@@ -0,0 +1,182 @@
+/// @file MfReader.cc
+/// @brief Implementation of the MfReader class.
+
+// Standard include statements.
+#include <algorithm>
+
+#include "MfReader.h"
+#include "RNTupleIO.h"
+#include "FrameBatch.h"
+
+//
+// MfReader constructor
+//
+MfReader::MfReader(TString path, Option_t * mode)
+:
+  m_file(0),
+  m_tree(0),
+  m_rntuple(0),
+  m_frame(new FrameStruct()),
+  m_hasZones(false),
+  m_nZoneSkipped(0)
+{
+
+  m_file = TFile::Open(path, mode);
+  if (!m_file || m_file->IsZombie()) {
+    cout << "ERROR: unable to open '" << path << "'" << endl;
+    return;
+  }
+
+  m_tree = (TTree*)m_file->Get("MPXTree");
+  if (m_tree) {
+    m_tree->SetBranchAddress("FramesData", &m_frame);
+  } else if (m_file->GetKey("MPXNTuple")) {
+    m_rntuple = new RNTupleFrameReader(path);
+    if (!m_rntuple->IsOpen()) {
+      delete m_rntuple;
+      m_rntuple = 0;
+      return;
+    }
+  } else {
+    cout << "ERROR: no MPXTree in '" << path << "'" << endl;
+    return;
+  }
+
+  m_overlay.Read(m_file, GetEntries());
+
+}//end of MfReader constructor.
+
+//
+// MfReader destructor
+//
+MfReader::~MfReader() {
+
+  if (m_file) {
+    m_file->Close();
+    delete m_file;
+  }
+
+  delete m_rntuple;
+  delete m_frame;
+
+}//end of MfReader destructor.
+
+//
+// MfReader::GetEntries
+//
+Long64_t MfReader::GetEntries() const {
+
+  if (m_rntuple) return m_rntuple->GetEntries();
+  if (m_tree)    return m_tree->GetEntries();
+
+  return 0;
+
+}//end of MfReader::GetEntries method.
+
+//
+// MfReader::GetFrame
+//
+FrameStruct * MfReader::GetFrame(Long64_t entry) {
+
+  FrameStruct * frame = 0;
+  if (m_rntuple) {
+    frame = m_rntuple->GetFrame(entry);
+  } else if (m_tree && m_tree->GetEntry(entry) > 0) {
+    frame = m_frame;
+  }
+  if (!frame) return 0;
+
+  if (m_overlay.GetFields()) {
+    m_overlay.LoadEntry(entry);
+    m_overlay.Apply(*frame);
+  }
+
+  return frame;
+
+}//end of MfReader::GetFrame method.
+
+//
+// MfReader::ReadBatch
+//
+UInt_t MfReader::ReadBatch(Long64_t & entry, FrameBatch & batch) {
+
+  batch.Clear();
+
+  Long64_t nentries = GetEntries();
+  while (!batch.IsFull()) {
+    Long64_t next = NextEntry(entry);
+    m_nZoneSkipped += next - entry;
+    entry = next;
+    if (entry >= nentries) break;
+    FrameStruct * frame = GetFrame(entry);
+    if (!frame) {
+      // Stop at an unreadable frame (the next call returns nothing).
+      cout << "ERROR: unable to read frame " << entry << endl;
+      entry = nentries;
+      break;
+    }
+    if (!m_zones.HasCuts() || m_zones.Passes(*frame)) batch.AddFrame(*frame, entry);
+    ++entry;
+  }
+
+  return batch.GetNFrames();
+
+}//end of MfReader::ReadBatch method.
+
+//
+// MfReader::AddZoneCut
+//
+void MfReader::AddZoneCut(Int_t q, Double_t lo, Double_t hi) {
+
+  // The zone map is only read once it is needed.
+  if (!m_zones.HasCuts() && m_file) {
+    m_hasZones = m_file->GetKey("MPXZoneMap") && m_zones.Read(m_file);
+    if (!m_hasZones) {
+      cout << "WARNING: no zone map in '" << m_file->GetName()
+           << "'; every frame is read to apply the cuts." << endl;
+    }
+  }
+
+  m_zones.AddCut(q, lo, hi);
+
+  if (m_hasZones) m_zones.GetEntryRanges(m_ranges);
+
+}//end of MfReader::AddZoneCut method.
+
+//
+// MfReader::NextEntry
+//
+Long64_t MfReader::NextEntry(Long64_t entry) const {
+
+  if (!m_hasZones || !m_zones.HasCuts()) return entry;
+
+  // The first range ending after the entry.
+  vector< pair<Long64_t,Long64_t> >::const_iterator it = upper_bound(
+    m_ranges.begin(), m_ranges.end(), entry,
+    [](Long64_t e, pair<Long64_t,Long64_t> const & r) { return e < r.second; });
+
+  if (it == m_ranges.end()) return GetEntries();
+
+  return it->first > entry ? it->first : entry;
+
+}//end of MfReader::NextEntry method.
+
+//
+// MfReader::SetMetadataOnly
+//
+void MfReader::SetMetadataOnly(Bool_t on) {
+
+  // Not supported for RNTuple files: every field is read.
+  if (!m_tree) return;
+
+  // The pixel data are all in the (custom streamed) FrameContainer
+  // base class, which has its own branch when FramesData is split.
+  TBranch * payload = m_tree->FindBranch("FrameContainer");
+  if (!payload) {
+    cout << "ERROR: the pixel data can't be skipped in this file." << endl;
+    return;
+  }
+
+  m_tree->SetBranchStatus(payload->GetName(), !on);
+
+}//end of MfReader::SetMetadataOnly method.
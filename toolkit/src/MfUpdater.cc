@@ -2,6 +2,7 @@
 /// @brief Implementation of the Mafalda-format metadata updater class.
 
 #include "MfUpdater.h"
+#include "ZoneMap.h"
 
 //
 // MfUpdater constructor
@@ -25,33 +26,28 @@ MfUpdater::MfUpdater(
     m_pAddMetadata->PrintContents();
   }//end of dbg check.
 
-  // Create the first ROOT ntuple file.
-  m_pNt = new TFile(datasetpath, "UPDATE");
-
-  // TODO Handle non-existence of the file...
-
-  // Get the old TTree from the ROOT file.
-  m_pTr = (TTree*)m_pNt->Get("MPXTree");
-
-  // Create the ROOT TTree for the updated version.
-  m_pTrNew = new TTree("MPXTree","Medi/TimePix data");
+  // Open the ntuple file with any existing overlay.
+  m_pReader = new MfReader(datasetpath, "UPDATE");
+  if (!m_pReader->IsOpen()) return;
 
   // Hang on, shouldn't this be retrieved from the ROOT file?
   // And then checked against the value supplied in the metadata?
 
-  // Create the frame container.
-  //m_pFrame = new FrameStruct(m_pAddMetadata->GetMPXDataSetNumber());
-  m_pFrame = new FrameStruct();
+  // Only the frame metadata (the start time) are needed.
+  m_pReader->SetMetadataOnly(true);
 
-  // Get the branch for the frame information and set the address.
-  m_pBr = m_pTr->GetBranch("FramesData");
-  m_pBr->SetAddress(&m_pFrame);
+  // The fields written to the overlay.
+  const UInt_t fields =
+    FrameOverlay::kDataSet     | FrameOverlay::kMCData     | FrameOverlay::kFrameId  |
+    FrameOverlay::kPosition    | FrameOverlay::kAttitude   | FrameOverlay::kOmega    |
+    FrameOverlay::kDetPosition | FrameOverlay::kEuler      | FrameOverlay::kCustomName |
+    FrameOverlay::kAppFilters  | FrameOverlay::kSourceId;
 
-  // Create the branch for the new, updated TTree.
-  m_pTrNew->Branch("FramesData", "FrameStruct", &m_pFrame, 128000, 2);
+  FrameOverlay & overlay = m_pReader->GetOverlay();
+  overlay.BeginWrite(m_pReader->GetFile(), fields);
 
   // Get the number of frames in the file.
-  Int_t nframes = m_pTr->GetEntries();
+  Int_t nframes = m_pReader->GetEntries();
 
   // If the data is from the ISS, we need to retrieve historical geospatial
   // information from the timestamp. We use curlpp to retrieve the data from
@@ -64,14 +60,24 @@ MfUpdater::MfUpdater(
   Document jsondoc;          //!< For parsing the retrived geospatial data.
   
 
+  // Stands in for any frame that can't be read.
+  FrameStruct unreadable;
+
   // Loop over the frames.
   for (Int_t i=0; i<nframes; i++) {
 
-    // Load the TTree.
-    m_pTr->LoadTree(i);
-
-    // Load the event.
-    m_pTr->GetEvent(i);
+    // Load the frame (and its current overlay values).
+    m_pFrame = m_pReader->GetFrame(i);
+
+    // Every frame needs an overlay entry, so an unreadable frame keeps
+    // its current overlay values and gets the new ones from the XML.
+    Bool_t readable = (m_pFrame != 0);
+    if (!readable) {
+      cout << "ERROR: unable to read frame " << i << endl;
+      overlay.LoadEntry(i);
+      overlay.Apply(unreadable);
+      m_pFrame = &unreadable;
+    }
 
     // Payload
 
@@ -85,15 +91,16 @@ MfUpdater::MfUpdater(
     //cout << "* New dataset ID = " << m_pFrame->GetDataSet() << endl;
     m_pFrame->SetId(i);
 
-    // Occupancy
-    m_pFrame->UpdateOccupancy();
-
     // Geospatial information
     //------------------------
 
     // If the data is from the ISS, retrieve the latitude, longitude, and
     // and altitude for the frame from the ISS API.
-    if (m_pAddMetadata->GetSourceId()=="ISS") {
+    if (m_pAddMetadata->GetSourceId()=="ISS" && !readable) {
+
+      // Without its start time an unreadable frame's position is left.
+
+    } else if (m_pAddMetadata->GetSourceId()=="ISS") {
 
       // Get the start time of the frame (minus the fractional part).
       Int_t starttime = m_pFrame->GetStartTime();
@@ -158,8 +165,15 @@ MfUpdater::MfUpdater(
 
     //break;
 
-    // Fill the branch on the new tree with the new information.
-    m_pTrNew->Fill();
+    // Fill the overlay with the new information.
+    overlay.Take(*m_pFrame, fields);
+    overlay.Fill();
+
+    // The frame index and the zone map are rebuilt from these values.
+    m_index.Add(*m_pFrame);
+    m_latitudes.push_back(m_pFrame->GetLatitude());
+    m_longitudes.push_back(m_pFrame->GetLongitude());
+    m_altitudes.push_back(m_pFrame->GetAltitude());
   }//end of loop over the frames.
 
 }//end of MfUpdater constructor.
@@ -174,6 +188,9 @@ MfUpdater::~MfUpdater() {
   // Delete the pointer to the metadata wrapper.
   if (m_pAddMetadata) delete m_pAddMetadata;
 
+  // Delete the reader (this also closes the file).
+  delete m_pReader;
+
 }//end of the MfUpdater destructor.
 
 //
@@ -181,12 +198,34 @@ MfUpdater::~MfUpdater() {
 //
 void MfUpdater::closeNtuple() {
 
-  // Write the TTree contents.
-  m_pTr->Delete("all");
+  if (!m_pReader->IsOpen()) return;
+
+  TFile * file = m_pReader->GetFile();
 
-  m_pTrNew->Write();
+  // Write the overlay; MPXTree is left as it is.
+  m_pReader->GetOverlay().EndWrite();
+
+  // The frame IDs, dataset IDs and positions have changed, so the
+  // file's frame index and zone map are rewritten to match.
+  if (file->GetKey("MPXIdIndex") || file->GetKey("MPXTimeIndex")) {
+    if (!m_index.Write(file)) {
+      cout << "ERROR: unable to rewrite the frame index." << endl;
+    }
+  }
+
+  if (file->GetKey("MPXZoneMap")) {
+    ZoneMap zones;
+    Bool_t ok = zones.Read(file);
+    if (ok) {
+      zones.SetValues(ZoneMap::kLatitude,  m_latitudes);
+      zones.SetValues(ZoneMap::kLongitude, m_longitudes);
+      zones.SetValues(ZoneMap::kAltitude,  m_altitudes);
+      ok = zones.WriteZones(file);
+    }
+    if (!ok) cout << "ERROR: unable to rewrite the zone map." << endl;
+  }
 
   // Close the ntuple file.
-  m_pNt->Close();
+  file->Close();
 
 }//end of closeNtuple method.
@@ -12,11 +12,13 @@ Mo2MfConverter::Mo2MfConverter(
     TString outputdir,
     Int_t frames_per_root_file,
     Int_t num_frames_to_read,
-    Bool_t dbg
+    Bool_t dbg,
+    ConverterOptions const & options
 )
 
  :
   m_outputDir(outputdir),
+  m_options(options),
   //m_MPXDataSetNumber(dataSet),
   //m_ntupleFileBaseName(outputdir + "/"),
   m_currentNtupleFileNum(1),
@@ -112,17 +114,21 @@ Mo2MfConverter::Mo2MfConverter(
 
 */
 
-  // Create the first ROOT ntuple file.
-  m_pNt = new TFile(m_outputPath, "RECREATE");
-
-  // Create the ROOT TTree.
-  m_pTr = new TTree("MPXTree","Medi/TimePix data");
-
   // Create the frame container.
   m_pFrame = new FrameStruct(m_pMoEDALMetadata->GetMPXDataSetNumber());
 
-  // Create the branch for the frame information.
-  m_pTr->Branch("FramesData", "FrameStruct", &m_pFrame, 128000, 2);
+  // Publish the frames to a shared-memory ring for live monitors?
+  m_pRing = 0;
+  if (options.shmRing.Length() > 0) {
+    m_pRing = new FrameRingWriter(options.shmRing,
+                                  options.shmRingSlots,
+                                  options.shmRingMaxPixels);
+  }
+
+  // Create the first ROOT ntuple file. The output manager starts a
+  // new file every frames_per_root_file frames (or --file-size MB),
+  // the first file included.
+  openNtuple(frames_per_root_file);
 
   Bool_t more_frames = true;
 
@@ -141,58 +147,6 @@ Mo2MfConverter::Mo2MfConverter(
       //}//end of dbg check.
     }//end of end of frames check.
 
-    // Check if the frames/ROOT file limit has been reached.
-    // If the limit has been reached, close the ROOT file
-    // and create a new one.
-    if ((m_currentFrameNumber % frames_per_root_file == 0) && (more_frames) ) {
-
-      if (dbg) {
-        cout
-          << "* DEBUG:" << endl
-          << "* DEBUG: Reached the frames_per_root_file limit."               << endl
-          << "* DEBUG: Current ROOT file number = " << m_currentNtupleFileNum << endl
-          << "* DEBUG: m_currentFrameNumber = " << m_currentFrameNumber       << endl
-          << "* DEBUG:" << endl;
-      }
-
-      // Close the current old ntuple file.
-      closeNtuple();
-
-      // Increment the ROOT file number.
-      m_currentNtupleFileNum++;
-
-      // Add the data set label to the ROOT file name.
-      m_currentNtupleFileName.str("");
-      m_currentNtupleFileName
-        //<< "MPXNtuple_"
-        << m_pMoEDALMetadata->GetMPXDataSetNumber() << "_"
-        << setw(10) << setfill('0') << m_currentNtupleFileNum
-        << ".root";
-      m_outputPath = m_outputDir + "/" + m_currentNtupleFileName.str();
-      
-      // Create a new ntuple file.
-      m_pNt = new TFile(m_outputPath, "RECREATE");
-
-      // Create the ROOT TTree.
-      m_pTr = new TTree("MPXTree","Medi/TimePix data");
-
-      // Create the branch for the frame information.
-      m_pTr->Branch("FramesData", "FrameStruct", &m_pFrame, 128000, 2);
-
-      // Update the user (debug mode).
-      if (dbg) {
-        cout
-          << "DEBUG:" << endl
-          << "DEBUG: Current ROOT file number = " << m_currentNtupleFileNum   << endl
-          << "DEBUG: New ROOT file path = '" << m_currentNtupleFileName.str() << endl
-          << "DEBUG:" << endl;
-      }
-      cout 
-        << "INFO: ROOT file '" << m_currentNtupleFileName.str() 
-        << "', frame "         << m_currentFrameNumber << endl;
-
-    }//end of check of the frames/ROOT file limit.
-
     if (dbg && !more_frames) {
       cout
         << "* DEBUG: Exiting the loop over the frames." << endl
@@ -233,6 +187,9 @@ Mo2MfConverter::~Mo2MfConverter() {
   // Delete the pointer to the input ROOT file.
   if (m_pMof) delete m_pMof;
 
+  // Remove the shared-memory ring.
+  if (m_pRing) delete m_pRing;
+
 }//end of the Mo2MfConverter destructor.
 
 
@@ -290,7 +247,6 @@ Bool_t Mo2MfConverter::processNextFrame(Bool_t dbg) {
     m_pFrame->SetPayloadFormat(m_pMoEDALMetadata->GetPayloadFormat());
     m_pFrame->SetId(m_currentFrameNumber);
     m_pFrame->SetDataSet(m_pMoEDALMetadata->GetMPXDataSetNumber());
-    m_pFrame->UpdateOccupancy();
     m_pFrame->CalculateDoseRates();
 
 
@@ -373,9 +329,9 @@ Bool_t Mo2MfConverter::processNextFrame(Bool_t dbg) {
     m_pFrame->SetSourceId(m_pMoEDALMetadata->GetSourceId());
     // [No primary vertex information required - real data.]
 
-    // Fill the tree with the frame information.
-    m_pNt->cd();
-    m_pTr->Fill();
+    // Fill the tree with the frame information
+    // (and publish it to any live monitors).
+    m_pOutput->fillFrame(*m_pFrame);
 
     // Flush out the frame information.
     m_pFrame->ResetCountersPad();
@@ -421,15 +377,34 @@ Bool_t Mo2MfConverter::processNextFrame(Bool_t dbg) {
 }//end of Mo2MfConverter::processNextFrame method.
 
 
+//
+// openNtuple
+//
+void Mo2MfConverter::openNtuple(Int_t frames_per_root_file) {
+
+  // The files are named from the data set and file number.
+  m_pOutput = new OutputManager(m_pMoEDALMetadata->GetMPXDataSetNumber(),
+                                m_outputDir,
+                                m_options,
+                                m_currentNtupleFileNum,
+                                frames_per_root_file);
+  m_pOutput->SetFrameRing(m_pRing);
+
+}//end of openNtuple method.
+
 //
 // closeNtuple
 //
 void Mo2MfConverter::closeNtuple() {
 
-  // Write the TTree contents.
-  m_pTr->Write();
+  // Write the TTree contents and close the ntuple files.
+  m_pOutput->Close();
+
+  // Keep the name of the last file.
+  m_currentNtupleFileName.str("");
+  m_currentNtupleFileName << m_pOutput->GetCurrentFileName();
 
-  // Close the ntuple file.
-  m_pNt->Close();
+  delete m_pOutput;
+  m_pOutput = 0;
 
 }//end of closeNtuple method.
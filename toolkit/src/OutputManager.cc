@@ -0,0 +1,436 @@
+/// @file OutputManager.cc
+/// @brief Implementation of the OutputManager class.
+
+// ROOT include statements.
+#include "RVersion.h"
+#if ROOT_VERSION_CODE < ROOT_VERSION(6,0,0)
+#include "TThread.h"
+#endif
+
+#include "OutputManager.h"
+#include "WriteToNtuple.h"
+#include "ColumnarFile.h"
+#include "RNTupleIO.h"
+#include "FrameRing.h"
+#include "ClusterFinder.h"
+#include "ClusterProperties.h"
+#include "ClusterClassifier.h"
+#include "ClusterTreeWriter.h"
+#include "FrameBatch.h"
+#include "FrameQueue.h"
+
+namespace {
+
+  /// @brief Finish a file and delete its writer.
+  void finishFile(WriteToNtuple * writer) {
+    writer->closeNtuple();
+    delete writer;
+  }
+
+  /// @brief The most frames queued for a shard's writer.
+  const Long64_t kMaxFramesPerShard = 4096;
+
+}
+
+/// @brief A file written on its own thread (with shardWriters).
+///
+/// The file is written by an OutputManager of its own, without a
+/// frame limit, which takes the frames from the queue.
+class OutputManager::Shard {
+
+ public:
+
+  /// @brief Constructor (starts the file and its writer thread).
+  Shard(TString dataSet, TString outputDir, ConverterOptions const & options,
+        Int_t fileNum, UInt_t nbuffers)
+  : output(dataSet, outputDir, options, fileNum),
+    queue(nbuffers, dataSet)
+  {
+    writer = thread(&Shard::writeLoop, this);
+  }
+
+  /// @brief The writer thread's loop.
+  void writeLoop() {
+    FrameStruct * frame = 0;
+    while ((frame = queue.GetFull())) {
+      output.fillFrame(*frame);
+      queue.PutFree(frame);
+    }
+    output.Close();
+  }
+
+  /// @brief The file's writers.
+  OutputManager output;
+
+  /// @brief The frames waiting to be written, and the empty buffers.
+  FrameQueue queue;
+
+  /// @brief The writer thread.
+  thread writer;
+
+};//end of OutputManager::Shard class definition.
+
+//
+// OutputManager constructor
+//
+OutputManager::OutputManager(
+  TString dataSet,
+  TString outputDir,
+  ConverterOptions const & options,
+  Int_t firstFileNum,
+  Long64_t framesPerFile)
+:
+  m_dataSet(dataSet),
+  m_outputDir(outputDir),
+  m_options(options),
+  m_framesPerFile(framesPerFile),
+  m_bytesPerFile((Long64_t)options.fileSizeMB*1000000),
+  m_closeInBackground(options.asyncWrite || options.writeThreads > 0),
+  m_sharded(options.shardWriters > 0),
+  m_fileNum(firstFileNum),
+  m_framesInFile(0),
+  m_framesWritten(0),
+  m_open(false),
+  m_writer(0),
+  m_columnar(0),
+  m_rntuple(0),
+  m_ring(0),
+  m_classifier(0),
+  m_finder(0),
+  m_properties(0),
+  m_clusters(0)
+{
+
+  // The files' frames are only known by count.
+  if (m_sharded && m_bytesPerFile > 0) {
+    cout << "WARNING: the output files are written one at a time "
+         << "(the shard writers can't be used with a file size)." << endl;
+    m_sharded = false;
+  }
+
+  // The shards' writers fill and close their files on their own threads.
+  if (m_sharded) {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,0,0)
+    ROOT::EnableThreadSafety();
+#else
+    TThread::Initialize();
+#endif
+  }
+
+  // Each shard classifies its own frames.
+  if (options.classify && !m_sharded) {
+    m_classifier = new ClusterClassifier();
+    if (options.cutTable != "" && !m_classifier->ReadCutTable(options.cutTable)) {
+      cout << "ERROR: the clusters will not be classified." << endl;
+      delete m_classifier;
+      m_classifier = 0;
+    } else {
+      m_properties = new ClusterProperties();
+    }
+  }
+
+  openFile();
+
+}//end of OutputManager constructor.
+
+//
+// OutputManager destructor
+//
+OutputManager::~OutputManager() {
+
+  Close();
+
+  delete m_classifier;
+  delete m_finder;
+  delete m_properties;
+
+}//end of OutputManager destructor.
+
+//
+// OutputManager::fillFrame
+//
+void OutputManager::fillFrame(FrameStruct & frame) {
+
+  rollOver();
+
+  // The clusters go first: the threaded ntuple writers move the
+  // pixels out of the frame.
+  if (m_clusters) classifyFrame(frame);
+
+  writeFrame(frame);
+
+}//end of OutputManager::fillFrame method.
+
+//
+// OutputManager::fillBatch
+//
+void OutputManager::fillBatch(FrameBatch const & batch) {
+
+  // The clusters of the whole batch, from its pixel arrays.
+  if (m_properties) {
+    m_properties->Clear();
+    m_properties->AddBatch(batch);
+  }
+
+  for (UInt_t i = 0; i < batch.GetNFrames(); ++i) {
+    rollOver();
+    if (m_clusters) {
+      m_clusters->Fill(m_framesInFile, batch.GetFrameIds()[i], *m_properties, i);
+    }
+    batch.GetFrame(i, m_batchFrame);
+    writeFrame(m_batchFrame);
+  }
+
+}//end of OutputManager::fillBatch method.
+
+//
+// OutputManager::fillVars
+//
+void OutputManager::fillVars(FramesHandler * frameHandlerObj, bool rewind_metadata) {
+
+  // Write the frame data from the frame container.
+  fillFrame(*frameHandlerObj->getFrameStructObject());
+
+  // Clean up the frame container.
+  frameHandlerObj->RewindAll(rewind_metadata);
+
+}//end of OutputManager::fillVars method.
+
+//
+// OutputManager::Close
+//
+void OutputManager::Close() {
+
+  if (m_open) closeFile();
+
+  for (UInt_t i = 0; i < m_closers.size(); ++i) m_closers[i].join();
+  m_closers.clear();
+
+  while (!m_shards.empty()) {
+    m_shards.front()->writer.join();
+    delete m_shards.front();
+    m_shards.pop_front();
+  }
+
+}//end of OutputManager::Close method.
+
+//
+// OutputManager::SetFrameRing
+//
+void OutputManager::SetFrameRing(FrameRingWriter * ring) {
+
+  m_ring = ring;
+  if (m_writer) m_writer->SetFrameRing(ring);
+
+}//end of OutputManager::SetFrameRing method.
+
+//
+// OutputManager::GetCurrentFileName
+//
+TString OutputManager::GetCurrentFileName() const {
+
+  return m_fileNames.empty() ? TString("") : m_fileNames.back();
+
+}//end of OutputManager::GetCurrentFileName method.
+
+//
+// OutputManager::rollOver
+//
+void OutputManager::rollOver() {
+
+  if (m_framesInFile == 0) return;
+
+  Bool_t full = false;
+  if (m_framesPerFile > 0 && m_framesInFile >= m_framesPerFile) full = true;
+  if (m_bytesPerFile  > 0) {
+    Long64_t bytes = m_writer  ? m_writer->GetBytesWritten()  :
+                     m_rntuple ? m_rntuple->GetBytesWritten() :
+                                 m_columnar->GetBytesWritten();
+    if (bytes >= m_bytesPerFile) full = true;
+  }
+
+  if (!full) return;
+
+  closeFile();
+  m_fileNum++;
+  openFile();
+  cout
+    << "INFO: output file '" << GetCurrentFileName()
+    << "', frame "         << m_framesWritten + 1 << endl;
+
+}//end of OutputManager::rollOver method.
+
+//
+// OutputManager::writeFrame
+//
+void OutputManager::writeFrame(FrameStruct & frame) {
+
+  if (m_sharded) {
+
+    if (m_ring) m_ring->Publish(frame);
+
+    // Take an empty frame; this waits if the file's writer has fallen
+    // behind.
+    FrameQueue & queue = m_shards.back()->queue;
+    FrameStruct * queued = queue.GetFree();
+
+    // Copy the metadata and move the pixel data into the queued frame.
+    FrameContainer payload;
+    frame.SwapPayload(payload);
+    *queued = frame;
+    queued->SwapPayload(payload);
+
+    queue.PutFull(queued);
+
+    m_framesInFile++;
+    m_framesWritten++;
+    return;
+  }
+
+  // The columnar copy goes first: the threaded ntuple writers move
+  // the pixels out of the frame.
+  if (m_columnar) m_columnar->fillFrame(frame);
+
+  if (m_rntuple) m_rntuple->fillFrame(frame);
+
+  if (m_writer) {
+    m_writer->fillFrame(frame);
+  } else if (m_ring) {
+    m_ring->Publish(frame);
+  }
+
+  m_framesInFile++;
+  m_framesWritten++;
+
+}//end of OutputManager::writeFrame method.
+
+//
+// OutputManager::openFile
+//
+void OutputManager::openFile() {
+
+  if (m_sharded) {
+
+    // Wait for the oldest file if the most files are being written.
+    if ((Int_t)m_shards.size() >= m_options.shardWriters) {
+      m_shards.front()->writer.join();
+      delete m_shards.front();
+      m_shards.pop_front();
+    }
+
+    // The file's frames are queued (up to a limit) while it is written.
+    Long64_t nbuffers = m_framesPerFile;
+    if (nbuffers <= 0 || nbuffers > kMaxFramesPerShard) nbuffers = kMaxFramesPerShard;
+
+    ConverterOptions options = m_options;
+    options.shardWriters = 0;
+    m_shards.push_back(new Shard(m_dataSet, m_outputDir, options, m_fileNum, nbuffers));
+    m_fileNames.push_back(m_shards.back()->output.GetCurrentFileName());
+
+    m_open = true;
+    m_framesInFile = 0;
+    return;
+  }
+
+  if (m_options.WritesColumnar()) {
+    TString path = TString::Format("%s_%010d.mpxc", m_dataSet.Data(), m_fileNum);
+    if (m_outputDir != "") path = m_outputDir + "/" + path;
+    m_columnar = new ColumnarWriter(path, m_dataSet);
+    if (!m_columnar->IsOpen()) {
+      cout << "ERROR: unable to create the columnar file '" << path << "'" << endl;
+    }
+  }
+
+  if (m_options.WritesRoot()) {
+    m_writer = new WriteToNtuple(m_dataSet, m_outputDir, m_options, m_fileNum);
+    m_writer->SetFrameRing(m_ring);
+    m_fileNames.push_back(m_writer->GetNtupleFileName());
+  } else if (m_options.WritesRNTuple()) {
+    TString path = TString::Format("%s_%010d.root", m_dataSet.Data(), m_fileNum);
+    if (m_outputDir != "") path = m_outputDir + "/" + path;
+    m_rntuple = new RNTupleFrameWriter(path, m_options);
+    m_fileNames.push_back(path);
+  } else {
+    m_fileNames.push_back(m_columnar->GetFileName());
+  }
+
+  if (m_classifier) {
+    TString path = TString::Format("%s_%010d.clusters.root", m_dataSet.Data(), m_fileNum);
+    if (m_outputDir != "") path = m_outputDir + "/" + path;
+    m_clusters = new ClusterTreeWriter(path, m_options, m_classifier);
+  }
+
+  m_open = true;
+  m_framesInFile = 0;
+
+}//end of OutputManager::openFile method.
+
+//
+// OutputManager::closeFile
+//
+void OutputManager::closeFile() {
+
+  // The file's writer finishes it once it has written the frames queued.
+  if (m_sharded) {
+    m_shards.back()->queue.Close();
+    m_open = false;
+    return;
+  }
+
+  if (m_clusters) {
+    m_clusters->Close();
+    delete m_clusters;
+    m_clusters = 0;
+  }
+
+  if (m_columnar) {
+    m_columnar->Close();
+    delete m_columnar;
+    m_columnar = 0;
+  }
+
+  if (m_rntuple) {
+    m_rntuple->Close();
+    delete m_rntuple;
+    m_rntuple = 0;
+  }
+
+  m_open = false;
+
+  if (!m_writer) return;
+
+  // The writer's threads already make ROOT thread-safe, so the
+  // file can be finished while the next one is filled.
+  if (m_closeInBackground) {
+    m_closers.push_back(thread(finishFile, m_writer));
+  } else {
+    finishFile(m_writer);
+  }
+
+  m_writer = 0;
+
+}//end of OutputManager::closeFile method.
+
+//
+// OutputManager::classifyFrame
+//
+void OutputManager::classifyFrame(FrameStruct & frame) {
+
+  // Frames without the size in their metadata are taken to be Timepix
+  // frames (256 x 256).
+  Int_t width  = frame.GetFrameWidth()  > 0 ? frame.GetFrameWidth()  : 256;
+  Int_t height = frame.GetFrameHeight() > 0 ? frame.GetFrameHeight() : 256;
+
+  // One finder for each run of frames of the same size.
+  if (!m_finder || width != m_finder->GetWidth() || height != m_finder->GetHeight()) {
+    delete m_finder;
+    m_finder = new ClusterFinder(width, height);
+  }
+
+  // The clusters stored with the frame are used if it has any.
+  m_properties->Clear();
+  m_properties->AddFrame(frame, *m_finder);
+
+  m_clusters->Fill(m_framesInFile, frame.GetFrameId(), *m_properties);
+
+}//end of OutputManager::classifyFrame method.
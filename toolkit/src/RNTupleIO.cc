@@ -0,0 +1,568 @@
+/// @file RNTupleIO.cc
+/// @brief Implementation of the RNTuple frame writer and reader classes.
+
+// Standard include statements.
+#include <sys/stat.h>
+
+// ROOT include statements.
+#include "RVersion.h"
+
+// The RNTuple API is stable from ROOT 6.34 (out of Experimental in 6.36).
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,34,0)
+#define RNTUPLEIO_HAS_RNTUPLE 1
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ROOT/RNTupleModel.hxx"
+#include "ROOT/RNTupleReader.hxx"
+#include "ROOT/RNTupleWriter.hxx"
+#include "ROOT/RNTupleWriteOptions.hxx"
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,36,0)
+namespace RNT = ROOT;
+#else
+namespace RNT = ROOT::Experimental;
+#endif
+#endif
+
+// Local include statements.
+#include "RNTupleIO.h"
+
+#ifdef RNTUPLEIO_HAS_RNTUPLE
+namespace {
+
+  /// @brief The name of the RNTuple in the file.
+  const char * kNTupleName = "MPXNTuple";
+
+  /// @brief A frame as RNTuple field values.
+  struct FrameRecord {
+
+    // Payload information
+    std::string  dataSet;
+    std::int64_t frameId;
+    std::int32_t width, height, format;
+    std::int32_t occupancy;
+    double       occupancyPc;
+    std::int32_t totalToT, maxToT, xMin, xMax, yMin, yMax, nClusters;
+    bool         mcData;
+
+    // The pixel maps
+    std::vector<std::int32_t> pixelX, pixelC;
+    std::vector<std::int32_t> pixelCluster;
+    std::vector<std::int32_t> lvl1X, lvl1V;
+    std::vector<std::int32_t> energyX;
+    std::vector<double>       energyE;
+
+    // Acquisition information
+    std::int32_t acqMode;
+    std::vector<std::int32_t> counters;
+    std::int32_t hwTimer;
+    double       autoEraseInterval;
+    std::int32_t autoEraseIntervalCounter;
+    double       triggerTime;
+    std::uint8_t coincidenceMode, coincidenceDelay;
+    double       coincidenceLiveTime;
+    std::string  pixelmanVersion;
+
+    // Geospatial information
+    double latitude, longitude, altitude;
+    double omegaX, omegaY, omegaZ;
+    double roll, pitch, yaw;
+
+    // Temporal information
+    double      startTime;
+    std::string startTimeS;
+    double      acqTime;
+
+    // Detector settings
+    std::int32_t polarity;
+    double       hv;
+    std::vector<std::int32_t> dacs;
+    double       mpxClock, tpxClock;
+    bool         bsActive;
+
+    // Detector information
+    std::string  chipboardId, customName, firmware, interfaceName, appFilters;
+    std::int32_t mpxType;
+    double       detX, detY, detZ;
+    double       eulerA, eulerB, eulerC;
+
+    // Source information
+    std::string sourceId;
+    std::vector<double> pvX, pvY, pvZ;
+
+  };
+
+  /// @brief Call f(name, value) for each field of a record.
+  template <class F> void visitFields(FrameRecord & r, F && f) {
+    f("dataSet", r.dataSet);
+    f("frameId", r.frameId);
+    f("width", r.width);
+    f("height", r.height);
+    f("format", r.format);
+    f("occupancy", r.occupancy);
+    f("occupancyPc", r.occupancyPc);
+    f("totalToT", r.totalToT);
+    f("maxToT", r.maxToT);
+    f("xMin", r.xMin);
+    f("xMax", r.xMax);
+    f("yMin", r.yMin);
+    f("yMax", r.yMax);
+    f("nClusters", r.nClusters);
+    f("mcData", r.mcData);
+    f("pixelX", r.pixelX);
+    f("pixelC", r.pixelC);
+    f("pixelCluster", r.pixelCluster);
+    f("lvl1X", r.lvl1X);
+    f("lvl1V", r.lvl1V);
+    f("energyX", r.energyX);
+    f("energyE", r.energyE);
+    f("acqMode", r.acqMode);
+    f("counters", r.counters);
+    f("hwTimer", r.hwTimer);
+    f("autoEraseInterval", r.autoEraseInterval);
+    f("autoEraseIntervalCounter", r.autoEraseIntervalCounter);
+    f("triggerTime", r.triggerTime);
+    f("coincidenceMode", r.coincidenceMode);
+    f("coincidenceDelay", r.coincidenceDelay);
+    f("coincidenceLiveTime", r.coincidenceLiveTime);
+    f("pixelmanVersion", r.pixelmanVersion);
+    f("latitude", r.latitude);
+    f("longitude", r.longitude);
+    f("altitude", r.altitude);
+    f("omegaX", r.omegaX);
+    f("omegaY", r.omegaY);
+    f("omegaZ", r.omegaZ);
+    f("roll", r.roll);
+    f("pitch", r.pitch);
+    f("yaw", r.yaw);
+    f("startTime", r.startTime);
+    f("startTimeS", r.startTimeS);
+    f("acqTime", r.acqTime);
+    f("polarity", r.polarity);
+    f("HV", r.hv);
+    f("DACs", r.dacs);
+    f("mpxClock", r.mpxClock);
+    f("tpxClock", r.tpxClock);
+    f("bsActive", r.bsActive);
+    f("chipboardID", r.chipboardId);
+    f("customName", r.customName);
+    f("firmware", r.firmware);
+    f("interface", r.interfaceName);
+    f("appFilters", r.appFilters);
+    f("mpxType", r.mpxType);
+    f("detX", r.detX);
+    f("detY", r.detY);
+    f("detZ", r.detZ);
+    f("eulerA", r.eulerA);
+    f("eulerB", r.eulerB);
+    f("eulerC", r.eulerC);
+    f("sourceId", r.sourceId);
+    f("primaryVertexX", r.pvX);
+    f("primaryVertexY", r.pvY);
+    f("primaryVertexZ", r.pvZ);
+  }
+
+  /// @brief Copy a frame into a record.
+  void toRecord(FrameStruct & f, FrameRecord & r) {
+
+    r.dataSet     = f.GetDataSet().Data();
+    r.frameId     = f.GetFrameId();
+    r.width       = f.GetFrameWidth();
+    r.height      = f.GetFrameHeight();
+    r.format      = f.GetPayloadFormat();
+    r.occupancy   = f.GetOccupancy();
+    r.occupancyPc = f.GetOccupancyPc();
+    r.totalToT    = f.GetTotalToT();
+    r.maxToT      = f.GetMaxToT();
+    r.xMin        = f.GetXMin();
+    r.xMax        = f.GetXMax();
+    r.yMin        = f.GetYMin();
+    r.yMax        = f.GetYMax();
+    r.nClusters   = f.GetNClusters();
+    r.mcData      = f.IsMCData();
+
+    r.pixelX.clear(); r.pixelC.clear();
+    map<int,int>::const_iterator it;
+    for (it = f.GetPixelCounts().begin(); it != f.GetPixelCounts().end(); ++it) {
+      r.pixelX.push_back(it->first);
+      r.pixelC.push_back(it->second);
+    }
+    // The cluster of each pixel (empty if not known).
+    r.pixelCluster.clear();
+    if (f.HasClusterIds()) {
+      for (it = f.GetClusterIds().begin(); it != f.GetClusterIds().end(); ++it) {
+        r.pixelCluster.push_back(it->second);
+      }
+    }
+    r.lvl1X.clear(); r.lvl1V.clear();
+    for (it = f.GetLVL1().begin(); it != f.GetLVL1().end(); ++it) {
+      r.lvl1X.push_back(it->first);
+      r.lvl1V.push_back(it->second);
+    }
+    r.energyX.clear(); r.energyE.clear();
+    map<int,double>::const_iterator eit;
+    for (eit = f.GetPixelEnergies().begin(); eit != f.GetPixelEnergies().end(); ++eit) {
+      r.energyX.push_back(eit->first);
+      r.energyE.push_back(eit->second);
+    }
+
+    r.acqMode                  = f.GetAcqMode();
+    vector<Int_t> counters     = f.GetCounters();
+    r.counters.assign(counters.begin(), counters.end());
+    r.hwTimer                  = f.GetHwTimerMode();
+    r.autoEraseInterval        = f.GetAutoEraseInterval();
+    r.autoEraseIntervalCounter = f.GetAutoEraseIntervalCounter();
+    r.triggerTime              = f.GetLastTriggerTime();
+    r.coincidenceMode          = f.GetCoincidenceMode();
+    r.coincidenceDelay         = f.GetCoincidenceDelayTime();
+    r.coincidenceLiveTime      = f.GetCoincidenceLiveTime();
+    r.pixelmanVersion          = f.GetPixelmanVersion().Data();
+
+    r.latitude  = f.GetLatitude();
+    r.longitude = f.GetLongitude();
+    r.altitude  = f.GetAltitude();
+    r.omegaX    = f.GetOmega_x();
+    r.omegaY    = f.GetOmega_y();
+    r.omegaZ    = f.GetOmega_z();
+    r.roll      = f.GetRoll();
+    r.pitch     = f.GetPitch();
+    r.yaw       = f.GetYaw();
+
+    r.startTime  = f.GetStartTime();
+    r.startTimeS = f.GetStartTimeS().Data();
+    r.acqTime    = f.GetAcqTime();
+
+    r.polarity = f.GetPolarity();
+    r.hv       = f.GetHV();
+    vector<Int_t> dacs = f.GetDACs();
+    r.dacs.assign(dacs.begin(), dacs.end());
+    r.mpxClock = f.GetMpxClock();
+    r.tpxClock = f.GetTpxClock();
+    r.bsActive = f.GetBsActive();
+
+    r.chipboardId   = f.GetChipboardID().Data();
+    r.customName    = f.GetCustomName().Data();
+    r.firmware      = f.GetFirmware().Data();
+    r.interfaceName = f.GetInterface().Data();
+    r.appFilters    = f.GetAppFilters().Data();
+    r.mpxType       = f.GetMpxType();
+    r.detX          = f.GetDet_x();
+    r.detY          = f.GetDet_y();
+    r.detZ          = f.GetDet_z();
+    r.eulerA        = f.GetEulerA();
+    r.eulerB        = f.GetEulerB();
+    r.eulerC        = f.GetEulerC();
+
+    r.sourceId = f.GetSourceId().Data();
+    r.pvX = f.GetPVxs();
+    r.pvY = f.GetPVys();
+    r.pvZ = f.GetPVzs();
+
+  }
+
+  /// @brief Copy a record into a frame.
+  void fromRecord(FrameRecord const & r, FrameStruct & f) {
+
+    f.RewindMetaDataValues();
+
+    f.SetDataSet(r.dataSet.c_str());
+    f.SetId(r.frameId);
+    f.SetnX(r.width);
+    f.SetnY(r.height);
+    f.SetPayloadFormat(r.format);
+    f.SetNClusters(r.nClusters);
+    if (r.mcData) f.SetFrameAsMCData(); else f.SetFrameAsData();
+
+    f.SetPixelCounts(r.pixelX.data(), r.pixelC.data(),
+                     r.pixelX.size() < r.pixelC.size() ? r.pixelX.size() : r.pixelC.size());
+    if (r.pixelCluster.size() == r.pixelX.size()) {
+      f.SetClusterIds(r.pixelX.data(), r.pixelCluster.data(), r.pixelX.size());
+    } else {
+      f.SetClusterIds(0, 0, 0);
+    }
+    f.SetLVL1Map(r.lvl1X.data(), r.lvl1V.data(),
+                 r.lvl1X.size() < r.lvl1V.size() ? r.lvl1X.size() : r.lvl1V.size());
+    f.SetPixelEnergies(r.energyX.data(), r.energyE.data(),
+                       r.energyX.size() < r.energyE.size() ? r.energyX.size() : r.energyE.size());
+
+    // The occupancy, ToT sums and bounding box come from the pixels.
+    f.UpdateFrameStats();
+
+    f.SetAcqMode(r.acqMode);
+    f.SetCounters(vector<Int_t>(r.counters.begin(), r.counters.end()));
+    f.SetHwTimerMode(r.hwTimer);
+    f.SetAutoEraseInterval(r.autoEraseInterval);
+    f.SetAutoEraseIntervalCounter(r.autoEraseIntervalCounter);
+    f.SetLastTriggerTime(r.triggerTime);
+    f.SetCoincidenceMode(r.coincidenceMode);
+    f.SetCoincidenceDelayTime(r.coincidenceDelay);
+    f.SetCoincidenceLiveTime(r.coincidenceLiveTime);
+    f.SetPixelmanVersion(r.pixelmanVersion.c_str());
+
+    f.SetLatitude(r.latitude);
+    f.SetLongitude(r.longitude);
+    f.SetAltitude(r.altitude);
+    f.SetOmega_x(r.omegaX);
+    f.SetOmega_y(r.omegaY);
+    f.SetOmega_z(r.omegaZ);
+    f.SetRoll(r.roll);
+    f.SetPitch(r.pitch);
+    f.SetYaw(r.yaw);
+
+    f.SetStartTime(r.startTime);
+    f.SetStartTimeS(r.startTimeS);
+    f.SetAcqTime(r.acqTime);
+
+    f.SetPolarity(r.polarity);
+    f.SetHV(r.hv);
+    if (!r.dacs.empty()) f.SetDACs(vector<Int_t>(r.dacs.begin(), r.dacs.end()));
+    f.SetMpxClock(r.mpxClock);
+    f.SetTpxClock(r.tpxClock);
+    f.SetBsActive(r.bsActive);
+
+    f.SetChipboardID(r.chipboardId.c_str());
+    f.SetCustomName(r.customName.c_str());
+    f.SetFirmware(r.firmware.c_str());
+    f.SetInterface(r.interfaceName.c_str());
+    f.SetAppFilters(r.appFilters.c_str());
+    f.SetMpxType(r.mpxType);
+    f.SetDet_x(r.detX);
+    f.SetDet_y(r.detY);
+    f.SetDet_z(r.detZ);
+    f.SetEulerA(r.eulerA);
+    f.SetEulerB(r.eulerB);
+    f.SetEulerC(r.eulerC);
+
+    f.SetSourceId(r.sourceId.c_str());
+    for (size_t i = 0; i < r.pvX.size() && i < r.pvY.size() && i < r.pvZ.size(); ++i) {
+      f.SetPrimaryVertex(r.pvX[i], r.pvY[i], r.pvZ[i]);
+    }
+
+  }
+
+}
+
+/// @brief The RNTuple writer and the record its entry is bound to.
+class RNTupleFrameWriter::Impl {
+
+ public:
+
+  /// @brief The field values of the frame being written.
+  FrameRecord record;
+
+  /// @brief The writer.
+  std::unique_ptr<RNT::RNTupleWriter> writer;
+
+  /// @brief The entry bound to the record.
+  std::unique_ptr<RNT::REntry> entry;
+
+};//end of RNTupleFrameWriter::Impl class definition.
+
+/// @brief The RNTuple reader and the record its entry is bound to.
+class RNTupleFrameReader::Impl {
+
+ public:
+
+  /// @brief The field values of the frame read.
+  FrameRecord record;
+
+  /// @brief The reader.
+  std::unique_ptr<RNT::RNTupleReader> reader;
+
+  /// @brief The entry bound to the record.
+  std::unique_ptr<RNT::REntry> entry;
+
+};//end of RNTupleFrameReader::Impl class definition.
+#else
+/// @brief Placeholder: this ROOT has no RNTuple.
+class RNTupleFrameWriter::Impl {};
+
+/// @brief Placeholder: this ROOT has no RNTuple.
+class RNTupleFrameReader::Impl {};
+#endif
+
+//
+// RNTupleFrameWriter constructor
+//
+RNTupleFrameWriter::RNTupleFrameWriter(TString path, ConverterOptions const & options)
+:
+  m_path(path),
+  m_impl(0)
+{
+
+#ifdef RNTUPLEIO_HAS_RNTUPLE
+  Impl * impl = new Impl();
+
+  auto model = RNT::RNTupleModel::Create();
+  visitFields(impl->record, [&model](const char * name, auto & value) {
+    model->MakeField<typename std::decay<decltype(value)>::type>(name);
+  });
+
+  RNT::RNTupleWriteOptions writeOptions;
+  if (options.GetCompressionSettings() >= 0) {
+    writeOptions.SetCompression(options.GetCompressionSettings());
+  }
+
+  try {
+    impl->writer = RNT::RNTupleWriter::Recreate(std::move(model), kNTupleName,
+                                                 path.Data(), writeOptions);
+  } catch (std::exception const & e) {
+    cout << "ERROR: unable to create the RNTuple file '" << path << "': "
+         << e.what() << endl;
+    delete impl;
+    return;
+  }
+
+  impl->entry = impl->writer->CreateEntry();
+  visitFields(impl->record, [impl](const char * name, auto & value) {
+    impl->entry->BindRawPtr(name, &value);
+  });
+
+  m_impl = impl;
+#else
+  (void)options;
+  cout << "ERROR: RNTuple output needs ROOT 6.34 or later." << endl;
+#endif
+
+}//end of RNTupleFrameWriter constructor.
+
+//
+// RNTupleFrameWriter destructor
+//
+RNTupleFrameWriter::~RNTupleFrameWriter() {
+
+  Close();
+
+}//end of RNTupleFrameWriter destructor.
+
+//
+// RNTupleFrameWriter::IsAvailable
+//
+Bool_t RNTupleFrameWriter::IsAvailable() {
+
+#ifdef RNTUPLEIO_HAS_RNTUPLE
+  return true;
+#else
+  return false;
+#endif
+
+}//end of RNTupleFrameWriter::IsAvailable method.
+
+//
+// RNTupleFrameWriter::fillFrame
+//
+void RNTupleFrameWriter::fillFrame(FrameStruct & frame) {
+
+  if (!m_impl) return;
+
+#ifdef RNTUPLEIO_HAS_RNTUPLE
+  frame.UpdateFrameStats();
+
+  toRecord(frame, m_impl->record);
+  m_impl->writer->Fill(*m_impl->entry);
+#endif
+
+}//end of RNTupleFrameWriter::fillFrame method.
+
+//
+// RNTupleFrameWriter::Close
+//
+void RNTupleFrameWriter::Close() {
+
+  // Deleting the writer commits the last cluster and the footer.
+  delete m_impl;
+  m_impl = 0;
+
+}//end of RNTupleFrameWriter::Close method.
+
+//
+// RNTupleFrameWriter::GetBytesWritten
+//
+Long64_t RNTupleFrameWriter::GetBytesWritten() const {
+
+  // The clusters are written to the file as they fill up.
+  struct stat st;
+  if (stat(m_path.Data(), &st) != 0) return 0;
+
+  return st.st_size;
+
+}//end of RNTupleFrameWriter::GetBytesWritten method.
+
+//
+// RNTupleFrameReader constructor
+//
+RNTupleFrameReader::RNTupleFrameReader(TString path)
+:
+  m_impl(0),
+  m_frame(new FrameStruct())
+{
+
+#ifdef RNTUPLEIO_HAS_RNTUPLE
+  Impl * impl = new Impl();
+
+  try {
+    impl->reader = RNT::RNTupleReader::Open(kNTupleName, path.Data());
+  } catch (std::exception const & e) {
+    cout << "ERROR: no RNTuple '" << kNTupleName << "' in '" << path << "': "
+         << e.what() << endl;
+    delete impl;
+    return;
+  }
+
+  // Fields added since a file was written (e.g. pixelCluster) are
+  // left empty.
+  impl->entry = impl->reader->GetModel().CreateBareEntry();
+  visitFields(impl->record, [impl](const char * name, auto & value) {
+    try {
+      impl->entry->BindRawPtr(name, &value);
+    } catch (std::exception const &) {
+      value = typename std::decay<decltype(value)>::type();
+    }
+  });
+
+  m_impl = impl;
+#else
+  cout << "ERROR: reading '" << path << "' needs ROOT 6.34 or later (RNTuple)." << endl;
+#endif
+
+}//end of RNTupleFrameReader constructor.
+
+//
+// RNTupleFrameReader destructor
+//
+RNTupleFrameReader::~RNTupleFrameReader() {
+
+  delete m_impl;
+  delete m_frame;
+
+}//end of RNTupleFrameReader destructor.
+
+//
+// RNTupleFrameReader::GetEntries
+//
+Long64_t RNTupleFrameReader::GetEntries() const {
+
+#ifdef RNTUPLEIO_HAS_RNTUPLE
+  if (m_impl) return m_impl->reader->GetNEntries();
+#endif
+
+  return 0;
+
+}//end of RNTupleFrameReader::GetEntries method.
+
+//
+// RNTupleFrameReader::GetFrame
+//
+FrameStruct * RNTupleFrameReader::GetFrame(Long64_t entry) {
+
+  if (!m_impl || entry < 0 || entry >= GetEntries()) return 0;
+
+#ifdef RNTUPLEIO_HAS_RNTUPLE
+  m_impl->reader->LoadEntry(entry, *m_impl->entry);
+  fromRecord(m_impl->record, *m_frame);
+#endif
+
+  return m_frame;
+
+}//end of RNTupleFrameReader::GetFrame method.
@@ -30,7 +30,9 @@ namespace Utils {
 
     //cout << "DEBUG TMP: " << Utils::MyWid(time,30,8) << endl;
 
-    string ts  = static_cast<string>(ctime(&m_time));
+    // ctime_r, as the cluster log parsing threads share this.
+    char buf[32];
+    string ts  = static_cast<string>(ctime_r(&m_time, buf));
 
     string m_day = ts.substr( 0,3);
     string m_mon = ts.substr( 4,3);
@@ -0,0 +1,133 @@
+/// @file ValidationCounters.cc
+/// @brief Implementation of the ValidationCounters class.
+
+// ROOT include statements.
+#include "TDirectory.h"
+#include "TH1D.h"
+
+// Local include statements.
+#include "ValidationCounters.h"
+
+//
+// ValidationCounters constructor
+//
+ValidationCounters::ValidationCounters()
+:
+  m_nLines(0),
+  m_nHeaders(0),
+  m_nBlanks(0),
+  m_nClusters(0),
+  m_nOutside(0),
+  m_nDuplicates(0),
+  m_nSplit(0),
+  m_nTouching(0),
+  m_nBadFrames(0),
+  m_nBfChecked(0),
+  m_nBfMismatched(0)
+{}
+
+//
+// ValidationCounters::Merge
+//
+void ValidationCounters::Merge(ValidationCounters const & other) {
+
+  m_nLines    += other.m_nLines;
+  m_nHeaders  += other.m_nHeaders;
+  m_nBlanks   += other.m_nBlanks;
+  m_nClusters += other.m_nClusters;
+
+  m_nOutside      += other.m_nOutside;
+  m_nDuplicates   += other.m_nDuplicates;
+  m_nSplit        += other.m_nSplit;
+  m_nTouching     += other.m_nTouching;
+  m_nBadFrames    += other.m_nBadFrames;
+  m_nBfChecked    += other.m_nBfChecked;
+  m_nBfMismatched += other.m_nBfMismatched;
+
+  m_pixelsPerCluster.Merge(other.m_pixelsPerCluster);
+  m_pixelsRead.Merge(other.m_pixelsRead);
+  m_pixelsStored.Merge(other.m_pixelsStored);
+  m_clustersRead.Merge(other.m_clustersRead);
+  m_clustersFound.Merge(other.m_clustersFound);
+
+}//end of ValidationCounters::Merge method.
+
+//
+// ValidationCounters::Write
+//
+void ValidationCounters::Write(TDirectory * dir) const {
+
+  TDirectory * old = gDirectory;
+  dir->cd();
+
+  // The histograms belong to the directory and are written with it.
+  // Each blank line ends a frame, so the two counts are the same.
+  fillCount(new TH1D("nFrames_ex",   "",1,0.0,1.0), m_nBlanks);
+  fillCount(new TH1D("nLines_ex",    "",1,0.0,1.0), m_nLines);
+  fillCount(new TH1D("nHeaders_ex",  "",1,0.0,1.0), m_nHeaders);
+  fillCount(new TH1D("nClusters_ex", "",1,0.0,1.0), m_nClusters);
+  fillCount(new TH1D("nBlanks_ex",   "",1,0.0,1.0), m_nBlanks);
+  //
+  // The cluster checks (see ClusterValidator).
+  fillCount(new TH1D("nOutside_ex",     "",1,0.0,1.0), m_nOutside);
+  fillCount(new TH1D("nDuplicates_ex",  "",1,0.0,1.0), m_nDuplicates);
+  fillCount(new TH1D("nSplit_ex",       "",1,0.0,1.0), m_nSplit);
+  fillCount(new TH1D("nTouching_ex",    "",1,0.0,1.0), m_nTouching);
+  fillCount(new TH1D("nBadFrames_ex",   "",1,0.0,1.0), m_nBadFrames);
+  fillCount(new TH1D("nBfChecked_bf",   "",1,0.0,1.0), m_nBfChecked);
+  fillCount(new TH1D("nBfMismatched_bf","",1,0.0,1.0), m_nBfMismatched);
+  //
+  m_pixelsRead.Fill(  new TH1D("nPixelsPf_ex","",65536,0.0,65536.0), 0.0);
+  m_pixelsStored.Fill(new TH1D("nPixelsPf_fc","",65536,0.0,65536.0), 0.5);
+  //
+  m_clustersRead.Fill( new TH1D("nClustersPf_ex","",16384,0.,16384.0), 0.0);
+  m_clustersFound.Fill(new TH1D("nClustersPf_bf","",16384,0.,16384.0), 0.5);
+  //
+  m_pixelsPerCluster.Fill(new TH1D("ppc_ex","",11811,0.,11811.0), 0.0);
+
+  if (old) old->cd();
+
+}//end of ValidationCounters::Write method.
+
+//
+// ValidationCounters::fillCount
+//
+void ValidationCounters::fillCount(TH1D * h, Long64_t n) {
+
+  if (n == 0) return;
+
+  // The content and entries of n single fills. (A weighted fill would
+  // switch on Sumw2, giving an error of n rather than sqrt(n).)
+  h->AddBinContent(h->FindBin(0.5), Double_t(n));
+  h->SetEntries(Double_t(n));
+
+}//end of ValidationCounters::fillCount method.
+
+//
+// ValidationCounters::Counts::Merge
+//
+void ValidationCounters::Counts::Merge(Counts const & other) {
+
+  if (other.m_n.size() > m_n.size()) m_n.resize(other.m_n.size(), 0);
+
+  for (UInt_t v = 0; v < other.m_n.size(); ++v) m_n[v] += other.m_n[v];
+
+}//end of ValidationCounters::Counts::Merge method.
+
+//
+// ValidationCounters::Counts::Fill
+//
+void ValidationCounters::Counts::Fill(TH1D * h, Double_t shift) const {
+
+  // As for fillCount, the bins are filled without weights so the
+  // errors stay sqrt(content).
+  Long64_t entries = 0;
+  for (UInt_t v = 0; v < m_n.size(); ++v) {
+    if (m_n[v] == 0) continue;
+    h->AddBinContent(h->FindBin(Double_t(v) + shift), Double_t(m_n[v]));
+    entries += m_n[v];
+  }
+
+  h->SetEntries(Double_t(entries));
+
+}//end of ValidationCounters::Counts::Fill method.
@@ -1,31 +1,209 @@
 /// @file WriteToNtuple.cc
 /// @brief Implementation of the ntuple writing class.
 
+// Standard include statements.
+#include <thread>
+#include <memory>
+
+// ROOT include statements.
+#include "RVersion.h"
+#if ROOT_VERSION_CODE < ROOT_VERSION(6,0,0)
+#include "TThread.h"
+#endif
+
+// TBufferMerger is available from ROOT 6.10 (out of Experimental in 6.26).
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,10,0)
+#include "ROOT/TBufferMerger.hxx"
+#define WRITETONTUPLE_HAS_BUFFERMERGER 1
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,26,0)
+using ROOT::TBufferMerger;
+using ROOT::TBufferMergerFile;
+#else
+using ROOT::Experimental::TBufferMerger;
+using ROOT::Experimental::TBufferMergerFile;
+#endif
+#endif
+
 // Local include statements.
 #include "WriteToNtuple.h"
+#include "FrameRing.h"
+#include "FrameQueue.h"
+#include "FrameIndex.h"
+#include "ZoneMap.h"
+
+namespace {
+
+  /// @brief The number of consecutive frames a parallel writer takes
+  /// (unless the AutoFlush setting gives a number of entries).
+  const UInt_t kFramesPerBlock = 64;
+
+  /// @brief The most consecutive frames a parallel writer takes (the
+  /// frame pool holds a block per thread, plus one, from the start).
+  const Long64_t kMaxFramesPerBlock = 4096;
+
+  /// @brief Tell ROOT that it will be used from more than one thread.
+  void enableThreadSafety() {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,0,0)
+    ROOT::EnableThreadSafety();
+#else
+    TThread::Initialize();
+#endif
+  }
+
+}
+
+/// @brief The frame queue and thread of the asynchronous writer.
+class WriteToNtuple::AsyncWriter {
+
+ public:
+
+  /// @brief Constructor.
+  AsyncWriter(UInt_t nbuffers, TString datasetid)
+  : queue(nbuffers, datasetid) {}
+
+  /// @brief The frames waiting to be written, and the empty buffers.
+  FrameQueue queue;
+
+  /// @brief The writer thread.
+  thread writer;
+
+};//end of WriteToNtuple::AsyncWriter class definition.
+
+#ifdef WRITETONTUPLE_HAS_BUFFERMERGER
+/// @brief The frame queue, threads and merger of the parallel writer.
+class WriteToNtuple::ParallelWriter {
+
+ public:
+
+  /// @brief Constructor.
+  ParallelWriter(TString path, UInt_t nthreads, TString datasetid,
+                 ConverterOptions const & options)
+  : blockFrames(options.autoFlush <= 0                 ? kFramesPerBlock    :
+                options.autoFlush > kMaxFramesPerBlock ? kMaxFramesPerBlock :
+                                                         options.autoFlush),
+    basketSize(options.basketSize),
+    queue((nthreads + 1)*blockFrames, datasetid),
+    nextBlock(0),
+    nextMerge(0)
+  {
+    if (options.autoFlush > kMaxFramesPerBlock) {
+      cout << "WARNING: the parallel writer's blocks are limited to "
+           << kMaxFramesPerBlock << " frames (not " << options.autoFlush << ")." << endl;
+    }
+    Int_t compress = options.GetCompressionSettings();
+    if (compress >= 0) merger.reset(new TBufferMerger(path.Data(), "RECREATE", compress));
+    else               merger.reset(new TBufferMerger(path.Data(), "RECREATE"));
+  }
+
+  /// @brief The number of consecutive frames each thread takes.
+  UInt_t blockFrames;
+
+  /// @brief The basket size of the FramesData branch.
+  Int_t basketSize;
+
+  /// @brief Merges the threads' buffers into the output file.
+  unique_ptr<TBufferMerger> merger;
+
+  /// @brief The frames waiting to be written, and the empty buffers.
+  FrameQueue queue;
+
+  /// @brief The writer threads.
+  vector<thread> writers;
+
+  /// @brief Held while a thread takes its block from the queue.
+  mutex takeMutex;
+
+  /// @brief The number of the next block to be taken.
+  ULong64_t nextBlock;
+
+  /// @brief Guards nextMerge.
+  mutex mergeMutex;
+
+  /// @brief Signalled when a block has been handed to the merger.
+  condition_variable mergeCond;
+
+  /// @brief The number of the next block to hand to the merger.
+  ULong64_t nextMerge;
+
+};//end of WriteToNtuple::ParallelWriter class definition.
+#else
+/// @brief Placeholder: this ROOT has no TBufferMerger.
+class WriteToNtuple::ParallelWriter {};
+#endif
 
 //
 // WriteToNtuple constructor
 //
-WriteToNtuple::WriteToNtuple(TString dataSet, TString tempScratchDir){
+WriteToNtuple::WriteToNtuple(TString dataSet, TString tempScratchDir,
+                             ConverterOptions const & options, Int_t fileNum) {
 
   m_MPXDataSetNumber = dataSet;
   m_ntupleFileName = "";
+  m_ring = 0;
+  m_bytesWritten = 0;
+  m_index = new FrameIndex();
+  m_zones = new ZoneMap();
+  m_async = 0;
+  m_parallel = 0;
+  nt = 0;
+  t2 = 0;
 
   // change dir if requested
   if(tempScratchDir.Length() > 0){
     m_ntupleFileName += tempScratchDir;
     m_ntupleFileName += "/";
   }
-  
+
   //m_ntupleFileName += "MPXNtuple_"+m_MPXDataSetNumber+".root";
-  m_ntupleFileName += m_MPXDataSetNumber+"_0000000001.root";
+  m_ntupleFileName += TString::Format("%s_%010d.root", m_MPXDataSetNumber.Data(), fileNum);
+
+  m_frame = new FrameStruct(m_MPXDataSetNumber);
+  m_ownFrame = m_frame;
+
+  if (options.writeThreads > 0) {
+#ifdef WRITETONTUPLE_HAS_BUFFERMERGER
+    enableThreadSafety();
+
+    // The output file is written by the merger.
+    m_parallel = new ParallelWriter(m_ntupleFileName, options.writeThreads,
+                                    m_MPXDataSetNumber, options);
+    for (Int_t i = 0; i < options.writeThreads; ++i) {
+      m_parallel->writers.push_back(thread(&WriteToNtuple::mergeLoop, this));
+    }
+
+    cout << "INFO: writing the ntuple on " << options.writeThreads
+         << " threads." << endl;
+
+    return;
+#else
+    cout << "ERROR: this version of ROOT can't write the ntuple in parallel"
+         << " (TBufferMerger needs ROOT 6.10)." << endl
+         << "ERROR: writing on a single thread instead." << endl;
+#endif
+  }
+
   nt = new TFile(m_ntupleFileName, "RECREATE");
+  if (options.GetCompressionSettings() >= 0) {
+    nt->SetCompressionSettings(options.GetCompressionSettings());
+  }
+
   t2 = new TTree("MPXTree","Medi/TimePix data");
+  options.ConfigureTree(t2);
+
+  t2->Branch("FramesData", "FrameStruct", &m_frame, options.basketSize, 2);
+
+  if (options.asyncWrite || options.writeThreads > 0) {
+
+    enableThreadSafety();
+
+    m_async = new AsyncWriter(options.writeBuffers, m_MPXDataSetNumber);
+    m_async->writer = thread(&WriteToNtuple::writeLoop, this);
+
+    cout << "INFO: writing the ntuple on a separate thread ("
+         << options.writeBuffers << " frame buffers)." << endl;
+
+  }
 
-  m_frame = new FrameStruct(m_MPXDataSetNumber);
-  t2->Branch("FramesData", "FrameStruct", &m_frame, 128000, 2);
-  
 }
 
 //
@@ -33,14 +211,20 @@ WriteToNtuple::WriteToNtuple(TString dataSet, TString tempScratchDir){
 //
 WriteToNtuple::~WriteToNtuple() {
 
-  // Delete the TTree.
-  if (t2) t2->Delete();
+  // Write anything still queued if the ntuple was never closed.
+  if (m_async || m_parallel) closeNtuple();
 
-  // Delete the ntuple file.
-  if (nt) nt->Delete();
+  // Close the ntuple file if needed (this also deletes the TTree).
+  if (nt) {
+    if (nt->IsOpen()) nt->Close();
+    delete nt;
+  }
 
   // Delete the frame container.
-  if (m_frame) delete m_frame;
+  if (m_ownFrame) delete m_ownFrame;
+
+  delete m_index;
+  delete m_zones;
 
 }//end of destructor.
 
@@ -49,27 +233,204 @@ WriteToNtuple::~WriteToNtuple() {
 //
 void WriteToNtuple::fillVars(FramesHandler * frameHandlerObj, bool rewind_metadata) {
 
-  // Get the frame data into the frame container pointer.
-  m_frame = frameHandlerObj->getFrameStructObject();
-
-  // Get the current ntuple file.
-  nt->cd();
-
-  // Fill the branches of the TTree.
-  t2->Fill();
+  // Write the frame data from the frame container.
+  fillFrame(*frameHandlerObj->getFrameStructObject());
 
   // Clean up the frame container.
   frameHandlerObj->RewindAll(rewind_metadata);
 
 }//end of fillVars method.
 
+//
+// WriteToNtuple::fillFrame
+//
+void WriteToNtuple::fillFrame(FrameStruct & frame) {
+
+  // Compute the frame summary statistics from the payload.
+  frame.UpdateFrameStats();
+
+  // The frames keep their order whichever way they are written.
+  m_index->Add(frame);
+  m_zones->Add(frame);
+
+  // Publish the frame to any live monitors.
+  if (m_ring) m_ring->Publish(frame);
+
+  FrameQueue * queue = 0;
+  if (m_async)    queue = &m_async->queue;
+#ifdef WRITETONTUPLE_HAS_BUFFERMERGER
+  if (m_parallel) queue = &m_parallel->queue;
+#endif
+
+  if (!queue) {
+
+    // The branch reads the frame through m_frame.
+    m_frame = &frame;
+
+    // Get the current ntuple file.
+    nt->cd();
+
+    // Fill the branches of the TTree.
+    t2->Fill();
+
+    m_bytesWritten = nt->GetEND();
+
+    return;
+  }
+
+  // Take an empty frame; this waits if the writers have fallen behind.
+  FrameStruct * queued = queue->GetFree();
+
+  // Copy the metadata and move the pixel data into the queued frame.
+  FrameContainer payload;
+  frame.SwapPayload(payload);
+  *queued = frame;
+  queued->SwapPayload(payload);
+
+  queue->PutFull(queued);
+
+}//end of fillFrame method.
+
+//
+// WriteToNtuple::writeLoop
+//
+void WriteToNtuple::writeLoop() {
+
+  nt->cd();
+
+  FrameStruct * frame = 0;
+  while ((frame = m_async->queue.GetFull()) != 0) {
+    m_frame = frame;
+    t2->Fill();
+    m_bytesWritten.store(nt->GetEND(), std::memory_order_relaxed);
+    m_async->queue.PutFree(frame);
+  }
+
+}//end of writeLoop method.
+
+//
+// WriteToNtuple::mergeLoop
+//
+void WriteToNtuple::mergeLoop() {
+
+#ifdef WRITETONTUPLE_HAS_BUFFERMERGER
+  ParallelWriter * pw = m_parallel;
+
+  // The frame the branch reads (declared first so that it outlives the file).
+  FrameStruct * frame = 0;
+
+  // Each thread fills a TTree in its own in-memory file; the baskets
+  // are compressed there as they fill up.
+  shared_ptr<TBufferMergerFile> file = pw->merger->GetFile();
+  file->cd();
+
+  TTree * tree = new TTree("MPXTree","Medi/TimePix data");
+  tree->SetDirectory(file.get());
+  tree->SetAutoFlush(0);
+  tree->Branch("FramesData", "FrameStruct", &frame, pw->basketSize, 2);
+
+  vector<FrameStruct*> block;
+  block.reserve(pw->blockFrames);
+
+  Bool_t more_frames = true;
+
+  while (more_frames) {
+
+    // Take the next block of consecutive frames.
+    ULong64_t blockNum;
+    {
+      lock_guard<mutex> lock(pw->takeMutex);
+      blockNum = pw->nextBlock++;
+      while (block.size() < pw->blockFrames) {
+        FrameStruct * f = pw->queue.GetFull();
+        if (!f) break;
+        block.push_back(f);
+      }
+    }
+    more_frames = (block.size() == pw->blockFrames);
+
+    for (UInt_t i = 0; i < block.size(); ++i) {
+      frame = block[i];
+      tree->Fill();
+      pw->queue.PutFree(block[i]);
+    }
+
+    // Hand the block to the merger once the previous ones have been.
+    {
+      unique_lock<mutex> lock(pw->mergeMutex);
+      while (pw->nextMerge != blockNum) pw->mergeCond.wait(lock);
+    }
+    if (!block.empty()) {
+      // Count the compressed baskets before they are sent.
+      m_bytesWritten.fetch_add(file->GetEND(), std::memory_order_relaxed);
+      file->Write();
+    }
+    {
+      lock_guard<mutex> lock(pw->mergeMutex);
+      pw->nextMerge++;
+    }
+    pw->mergeCond.notify_all();
+
+    block.clear();
+
+  }//end of loop over the blocks.
+#endif
+
+}//end of mergeLoop method.
+
 //
 // WriteToNtuple::closeNtuple
 //
 void WriteToNtuple::closeNtuple()
 {
 
+  if (m_async) {
+
+    // Write the frames still in the queue.
+    m_async->queue.Close();
+    m_async->writer.join();
+    delete m_async;
+    m_async = 0;
+
+    m_frame = m_ownFrame;
+  }
+
+#ifdef WRITETONTUPLE_HAS_BUFFERMERGER
+  if (m_parallel) {
+
+    m_parallel->queue.Close();
+    for (UInt_t i = 0; i < m_parallel->writers.size(); ++i) {
+      m_parallel->writers[i].join();
+    }
+
+    // The merger writes the output file when it is deleted.
+    delete m_parallel;
+    m_parallel = 0;
+
+    // Add the index and zone map to the finished file.
+    TFile * file = TFile::Open(m_ntupleFileName, "UPDATE");
+    if (!file || file->IsZombie()) {
+      cout << "ERROR: unable to add the frame index to '" << m_ntupleFileName << "'" << endl;
+    } else {
+      m_index->Write(file);
+      m_zones->Write(file, (TTree*)file->Get("MPXTree"));
+      file->Close();
+    }
+    delete file;
+
+    return;
+  }
+#endif
+
+  if (!nt || !nt->IsOpen()) return;
+
+  nt->cd();
   t2->Write();
+  m_index->Write(nt);
+  m_zones->Write(nt, t2);
   nt->Close();
 
+  // Closing the file deleted the TTree.
+  t2 = 0;
+
 }
@@ -0,0 +1,365 @@
+/// @file ZoneMap.cc
+/// @brief Implementation of the ZoneMap class.
+
+// ROOT include statements.
+#include "TDirectory.h"
+#include "TTree.h"
+
+// Local include statements.
+#include "ZoneMap.h"
+#include "Frames.h"
+
+namespace {
+
+  /// @brief The names of the quantities.
+  const char * kQuantityNames[ZoneMap::kNQuantities] = {
+    "startTime", "occupancy", "totalToT", "latitude", "longitude", "altitude", "HV"
+  };
+
+}
+
+//
+// ZoneMap::GetQuantityName
+//
+const char * ZoneMap::GetQuantityName(Int_t q) {
+
+  if (q < 0 || q >= kNQuantities) return "";
+
+  return kQuantityNames[q];
+
+}//end of ZoneMap::GetQuantityName method.
+
+//
+// ZoneMap::FindQuantity
+//
+Int_t ZoneMap::FindQuantity(TString name) {
+
+  for (Int_t q = 0; q < kNQuantities; ++q) {
+    if (name.EqualTo(kQuantityNames[q], TString::kIgnoreCase)) return q;
+  }
+
+  return -1;
+
+}//end of ZoneMap::FindQuantity method.
+
+//
+// ZoneMap::GetValue
+//
+Double_t ZoneMap::GetValue(FrameStruct & frame, Int_t q) {
+
+  switch (q) {
+    case kStartTime: return frame.GetStartTime();
+    case kOccupancy: return frame.GetOccupancy();
+    case kTotalToT:  return frame.GetTotalToT();
+    case kLatitude:  return frame.GetLatitude();
+    case kLongitude: return frame.GetLongitude();
+    case kAltitude:  return frame.GetAltitude();
+    case kHV:        return frame.GetHV();
+  }
+
+  return 0.;
+
+}//end of ZoneMap::GetValue method.
+
+//
+// ZoneMap constructor
+//
+ZoneMap::ZoneMap()
+:
+  m_nEntries(0)
+{}
+
+//
+// ZoneMap destructor
+//
+ZoneMap::~ZoneMap() {}
+
+//
+// ZoneMap::Add
+//
+void ZoneMap::Add(FrameStruct & frame) {
+
+  // Start a new run after any appended zones.
+  if (m_runs.empty() || m_runs.back().end != m_nEntries) {
+    Run run = { m_nEntries, m_nEntries, (Long64_t)(m_values.size() / kNQuantities) };
+    m_runs.push_back(run);
+  }
+
+  for (Int_t q = 0; q < kNQuantities; ++q) m_values.push_back(GetValue(frame, q));
+
+  ++m_runs.back().end;
+  ++m_nEntries;
+
+}//end of ZoneMap::Add method.
+
+//
+// ZoneMap::Append
+//
+void ZoneMap::Append(ZoneMap const & other, Long64_t nentries) {
+
+  for (Int_t z = 0; z < other.GetNZones(); ++z) {
+    m_first.push_back(other.m_first[z] + m_nEntries);
+    m_end.push_back(other.m_end[z] + m_nEntries);
+    for (Int_t q = 0; q < kNQuantities; ++q) {
+      m_min.push_back(other.GetMin(z, q));
+      m_max.push_back(other.GetMax(z, q));
+    }
+  }
+
+  m_nEntries += nentries;
+
+}//end of ZoneMap::Append method.
+
+//
+// ZoneMap::Write
+//
+Bool_t ZoneMap::Write(TDirectory * dir, TTree * tree) {
+
+  if (!dir || !tree) return false;
+
+  Long64_t nentries = m_nEntries;
+  if (tree->GetEntries() != nentries) {
+    cout << "ERROR: the zone map has " << nentries << " frames but the tree has "
+         << tree->GetEntries() << " entries." << endl;
+    return false;
+  }
+
+  vector<Long64_t> firsts, ends;
+  vector<Double_t> mins, maxs;
+
+  // Find the range of each quantity over each entry cluster, from the
+  // frames added and any appended zones overlapping the cluster.
+  UInt_t r = 0, a = 0;
+  TTree::TClusterIterator clusters = tree->GetClusterIterator(0);
+  Long64_t first;
+  while ((first = clusters.Next()) < nentries) {
+
+    Long64_t end = clusters.GetNextEntry();
+    if (end > nentries) end = nentries;
+
+    Double_t lo[kNQuantities], hi[kNQuantities];
+    Bool_t found = false;
+    auto include = [&](Double_t const * vlo, Double_t const * vhi) {
+      for (Int_t q = 0; q < kNQuantities; ++q) {
+        if (!found || vlo[q] < lo[q]) lo[q] = vlo[q];
+        if (!found || vhi[q] > hi[q]) hi[q] = vhi[q];
+      }
+      found = true;
+    };
+
+    while (r < m_runs.size() && m_runs[r].end <= first) ++r;
+    for (UInt_t i = r; i < m_runs.size() && m_runs[i].first < end; ++i) {
+      Run const & run = m_runs[i];
+      Long64_t from = run.first > first ? run.first : first;
+      Long64_t to   = run.end   < end   ? run.end   : end;
+      for (Long64_t j = from; j < to; ++j) {
+        Double_t const * v = &m_values[(run.offset + j - run.first)*kNQuantities];
+        include(v, v);
+      }
+    }
+
+    while (a < m_first.size() && m_end[a] <= first) ++a;
+    for (UInt_t i = a; i < m_first.size() && m_first[i] < end; ++i) {
+      include(&m_min[i*kNQuantities], &m_max[i*kNQuantities]);
+    }
+
+    if (!found) continue;
+
+    firsts.push_back(first);
+    ends.push_back(end);
+    mins.insert(mins.end(), lo, lo + kNQuantities);
+    maxs.insert(maxs.end(), hi, hi + kNQuantities);
+
+  }//end of loop over the clusters.
+
+  m_first.swap(firsts);
+  m_end.swap(ends);
+  m_min.swap(mins);
+  m_max.swap(maxs);
+
+  // The per-frame values aren't needed any more.
+  vector<Double_t>().swap(m_values);
+  m_runs.clear();
+
+  return WriteZones(dir);
+
+}//end of ZoneMap::Write method.
+
+//
+// ZoneMap::WriteZones
+//
+Bool_t ZoneMap::WriteZones(TDirectory * dir) {
+
+  if (!dir) return false;
+
+  TDirectory * old = gDirectory;
+  dir->cd();
+
+  Long64_t firstEntry, endEntry;
+  Double_t vmin[kNQuantities], vmax[kNQuantities];
+
+  TTree * t = new TTree("MPXZoneMap", "Ranges of the frame quantities per MPXTree entry cluster");
+  t->Branch("firstEntry", &firstEntry, "firstEntry/L");
+  t->Branch("endEntry",   &endEntry,   "endEntry/L");
+  for (Int_t q = 0; q < kNQuantities; ++q) {
+    TString name = kQuantityNames[q];
+    t->Branch((name + "_min").Data(), &vmin[q], (name + "_min/D").Data());
+    t->Branch((name + "_max").Data(), &vmax[q], (name + "_max/D").Data());
+  }
+
+  for (Int_t z = 0; z < GetNZones(); ++z) {
+    firstEntry = m_first[z];
+    endEntry   = m_end[z];
+    for (Int_t q = 0; q < kNQuantities; ++q) {
+      vmin[q] = GetMin(z, q);
+      vmax[q] = GetMax(z, q);
+    }
+    t->Fill();
+  }
+
+  Bool_t ok = t->Write("", TObject::kOverwrite) > 0;
+
+  if (old) old->cd();
+
+  return ok;
+
+}//end of ZoneMap::WriteZones method.
+
+//
+// ZoneMap::SetValues
+//
+void ZoneMap::SetValues(Int_t q, vector<Double_t> const & values) {
+
+  if (q < 0 || q >= kNQuantities) return;
+
+  Long64_t nvalues = values.size();
+
+  for (Int_t z = 0; z < GetNZones(); ++z) {
+    Long64_t first = m_first[z], end = m_end[z] < nvalues ? m_end[z] : nvalues;
+    if (first >= end) continue;
+    Double_t lo = values[first], hi = values[first];
+    for (Long64_t j = first + 1; j < end; ++j) {
+      if (values[j] < lo) lo = values[j];
+      if (values[j] > hi) hi = values[j];
+    }
+    m_min[z*kNQuantities + q] = lo;
+    m_max[z*kNQuantities + q] = hi;
+  }
+
+}//end of ZoneMap::SetValues method.
+
+//
+// ZoneMap::Read
+//
+Bool_t ZoneMap::Read(TDirectory * dir) {
+
+  m_first.clear();
+  m_end.clear();
+  m_min.clear();
+  m_max.clear();
+
+  if (!dir) return false;
+
+  TTree * t = (TTree*)dir->Get("MPXZoneMap");
+  if (!t) {
+    cout << "ERROR: no zone map in '" << dir->GetName() << "'" << endl;
+    return false;
+  }
+
+  Long64_t firstEntry, endEntry;
+  Double_t vmin[kNQuantities], vmax[kNQuantities];
+
+  t->SetBranchAddress("firstEntry", &firstEntry);
+  t->SetBranchAddress("endEntry",   &endEntry);
+  for (Int_t q = 0; q < kNQuantities; ++q) {
+    TString name = kQuantityNames[q];
+    t->SetBranchAddress((name + "_min").Data(), &vmin[q]);
+    t->SetBranchAddress((name + "_max").Data(), &vmax[q]);
+  }
+
+  for (Long64_t z = 0; z < t->GetEntries(); ++z) {
+    t->GetEntry(z);
+    m_first.push_back(firstEntry);
+    m_end.push_back(endEntry);
+    for (Int_t q = 0; q < kNQuantities; ++q) {
+      m_min.push_back(vmin[q]);
+      m_max.push_back(vmax[q]);
+    }
+  }
+
+  t->ResetBranchAddresses();
+
+  return true;
+
+}//end of ZoneMap::Read method.
+
+//
+// ZoneMap::AddCut
+//
+void ZoneMap::AddCut(Int_t q, Double_t lo, Double_t hi) {
+
+  if (q < 0 || q >= kNQuantities) {
+    cout << "ERROR: unknown zone map quantity " << q << endl;
+    return;
+  }
+
+  Cut cut = { q, lo, hi };
+  m_cuts.push_back(cut);
+
+}//end of ZoneMap::AddCut method.
+
+//
+// ZoneMap::Passes
+//
+Bool_t ZoneMap::Passes(Int_t zone) const {
+
+  for (UInt_t i = 0; i < m_cuts.size(); ++i) {
+    Cut const & cut = m_cuts[i];
+    if (GetMax(zone, cut.q) < cut.lo || GetMin(zone, cut.q) > cut.hi) return false;
+  }
+
+  return true;
+
+}//end of ZoneMap::Passes method.
+
+//
+// ZoneMap::Passes
+//
+Bool_t ZoneMap::Passes(FrameStruct & frame) const {
+
+  for (UInt_t i = 0; i < m_cuts.size(); ++i) {
+    Cut const & cut = m_cuts[i];
+    Double_t value = GetValue(frame, cut.q);
+    if (value < cut.lo || value > cut.hi) return false;
+  }
+
+  return true;
+
+}//end of ZoneMap::Passes method.
+
+//
+// ZoneMap::GetEntryRanges
+//
+Long64_t ZoneMap::GetEntryRanges(vector< pair<Long64_t,Long64_t> > & ranges) const {
+
+  ranges.clear();
+
+  Long64_t n = 0;
+
+  for (Int_t z = 0; z < GetNZones(); ++z) {
+
+    if (!Passes(z)) continue;
+
+    if (!ranges.empty() && ranges.back().second == m_first[z]) {
+      ranges.back().second = m_end[z];
+    } else {
+      ranges.push_back(make_pair(m_first[z], m_end[z]));
+    }
+
+    n += m_end[z] - m_first[z];
+
+  }
+
+  return n;
+
+}//end of ZoneMap::GetEntryRanges method.